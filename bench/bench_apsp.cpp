@@ -0,0 +1,110 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <unordered_map>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 原始实现：哈希表上的Floyd（仅作为对照，节点较多时过慢）
+static void hashMapFloyd(const vector<Edge>& edges,
+                         std::unordered_map<int, std::unordered_map<int, double>>& distances)
+{
+    for (const auto& edge : edges) {
+        distances[edge.node1][edge.node2] = edge.length;
+        distances[edge.node2][edge.node1] = edge.length;
+    }
+    vector<int> nodes;
+    for (const auto& pair : distances) nodes.push_back(pair.first);
+    for (int node : nodes) distances[node][node] = 0.0;
+
+    for (int k : nodes) {
+        for (int i : nodes) {
+            auto& rowI = distances[i];
+            auto itIK = rowI.find(k);
+            if (itIK == rowI.end()) continue;
+            for (const auto& [j, distKJ] : distances[k]) {
+                double throughK = itIK->second + distKJ;
+                auto itIJ = rowI.find(j);
+                if (itIJ == rowI.end() || throughK < itIJ->second) rowI[j] = throughK;
+            }
+        }
+    }
+}
+
+// 比较两个距离矩阵的最大差异
+static double maxDifference(const vector<double>& a, const vector<double>& b)
+{
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::isinf(a[i]) != std::isinf(b[i])) return std::numeric_limits<double>::infinity();
+        if (!std::isinf(a[i])) diff = std::max(diff, std::abs(a[i] - b[i]));
+    }
+    return diff;
+}
+
+// 用法：apsp [side] [threads]
+int benchApsp(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 40;
+    int maxThreads = args.size() > 1 ? std::stoi(args[1]) : 4;
+
+    RouteNetwork base;
+    base.edges = generateGridEdges(side, 42);
+    buildNodeIndex(base);
+    cout << "路网节点数: " << base.nodeCount << ", 边数: " << base.edges.size() << endl;
+
+    if (base.nodeCount <= 900) {
+        std::unordered_map<int, std::unordered_map<int, double>> distances;
+        double seconds = timeSeconds([&] { hashMapFloyd(base.edges, distances); });
+        cout << "哈希表Floyd（原实现）: " << seconds << " 秒" << endl;
+    }
+
+    RouteNetwork reference = base;
+    double naiveSeconds = timeSeconds([&] { floyd(reference); });
+    cout << "稠密矩阵朴素Floyd: " << naiveSeconds << " 秒" << endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RouteNetwork blocked = base;
+        double seconds = timeSeconds([&] { blockedFloyd(blocked, threads); });
+        cout << "分块Floyd（" << threads << " 线程）: " << seconds << " 秒"
+             << ", 加速比: " << naiveSeconds / seconds
+             << ", 与朴素结果最大差异: " << maxDifference(reference.distMatrix, blocked.distMatrix) << endl;
+    }
+
+    // 分块Floyd同时记录下一跳矩阵的额外开销
+    {
+        RouteNetwork withHops = base;
+        initNextHops(withHops);
+        double seconds = timeSeconds([&] { blockedFloyd(withHops, maxThreads); });
+        cout << "分块Floyd+下一跳（" << maxThreads << " 线程）: " << seconds << " 秒"
+             << ", 下一跳矩阵 " << (withHops.nextHop.hops16.empty() ? 32 : 16) << " 位"
+             << ", 展开路径长度与距离最大差异: " << maxRoadPathError(withHops) << endl;
+    }
+
+    // 只计算终端节点（约10%的节点）之间距离的多源Dijkstra
+    vector<int> terminals;
+    for (int i = 0; i < base.nodeCount; i += 10) terminals.push_back(base.nodeIds[i]);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RouteNetwork terminalNetwork;
+        terminalNetwork.edges = base.edges;
+        double seconds = timeSeconds([&] { terminalDijkstra(terminalNetwork, terminals, threads); });
+
+        double diff = 0.0;
+        for (int a = 0; a < terminalNetwork.nodeCount; ++a) {
+            for (int b = 0; b < terminalNetwork.nodeCount; ++b) {
+                int i = reference.indexOf(terminalNetwork.nodeIds[a]);
+                int j = reference.indexOf(terminalNetwork.nodeIds[b]);
+                diff = std::max(diff, std::abs(reference.distanceAt(i, j) - terminalNetwork.distanceAt(a, b)));
+            }
+        }
+        cout << "终端多源Dijkstra（" << terminals.size() << " 个源点, " << threads << " 线程）: "
+             << seconds << " 秒, 加速比: " << naiveSeconds / seconds
+             << ", 与朴素结果最大差异: " << diff << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "contraction_hierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 用法：ch [side] [threads] [queries]
+int benchContractionHierarchy(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 60;
+    int maxThreads = args.size() > 1 ? std::stoi(args[1]) : 4;
+    int queryCount = args.size() > 2 ? std::stoi(args[2]) : 100000;
+
+    RouteNetwork network;
+    network.edges = generateGridEdges(side, 7);
+    CsrGraph graph = buildCsrGraph(network.edges);
+    cout << "路网节点数: " << graph.nodeCount << ", 边数: " << network.edges.size() << endl;
+
+    // 预处理时间：CH（不同线程数）与Floyd
+    ContractionHierarchy ch;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double seconds = timeSeconds([&] { ch = buildContractionHierarchy(graph, threads); });
+        cout << "CH预处理（" << threads << " 线程）: " << seconds << " 秒, 向上边数: "
+             << ch.upTargets.size() << endl;
+    }
+    ch.edgeHash = hashEdgeList(network.edges);
+
+    bool runFloyd = graph.nodeCount <= 2500;
+    if (runFloyd) {
+        double seconds = timeSeconds([&] {
+            buildNodeIndex(network);
+            blockedFloyd(network, maxThreads);
+        });
+        cout << "分块Floyd预处理（" << maxThreads << " 线程）: " << seconds << " 秒" << endl;
+    } else {
+        cout << "节点数过多，跳过Floyd预处理" << endl;
+    }
+
+    // 序列化往返
+    const string path = "bench_ch.bin";
+    double saveSeconds = timeSeconds([&] { saveContractionHierarchy(ch, path); });
+    ContractionHierarchy loaded;
+    bool ok = false;
+    double loadSeconds = timeSeconds([&] { ok = loadContractionHierarchy(path, ch.edgeHash, loaded); });
+    std::remove(path.c_str());
+    cout << "CH序列化: 保存 " << saveSeconds << " 秒, 加载 " << loadSeconds << " 秒"
+         << (ok ? "" : "（加载失败）") << endl;
+
+    // 查询延迟
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> pick(0, graph.nodeCount - 1);
+    vector<std::pair<int, int>> queries(queryCount);
+    for (auto& q : queries) q = {graph.nodeIds[pick(rng)], graph.nodeIds[pick(rng)]};
+
+    double checksum = 0.0;
+    double chSeconds = timeSeconds([&] {
+        for (const auto& [s, t] : queries) checksum += queryContractionHierarchy(loaded, s, t);
+    });
+    cout << "CH查询: 平均 " << chSeconds / queryCount * 1e6 << " 微秒/次" << endl;
+
+    if (runFloyd) {
+        double matrixSum = 0.0;
+        double matrixSeconds = timeSeconds([&] {
+            for (const auto& [s, t] : queries) {
+                matrixSum += network.distanceAt(network.indexOf(s), network.indexOf(t));
+            }
+        });
+        cout << "距离矩阵查询: 平均 " << matrixSeconds / queryCount * 1e6 << " 微秒/次" << endl;
+    }
+
+    // 正确性：与单源Dijkstra结果比较
+    double maxDiff = 0.0;
+    vector<double> dist;
+    for (int i = 0; i < 20; i++) {
+        int source = pick(rng);
+        dijkstra(graph, source, dist);
+        for (int j = 0; j < 200; j++) {
+            int target = pick(rng);
+            double d = queryContractionHierarchy(loaded, graph.nodeIds[source], graph.nodeIds[target]);
+            maxDiff = std::max(maxDiff, std::abs(d - dist[target]));
+        }
+    }
+    cout << "与Dijkstra结果最大差异: " << maxDiff << "（校验和 " << checksum << "）" << endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "common.h"
+#include "road_path.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 计时工具：返回执行fn所用的秒数
+template <typename Fn>
+double timeSeconds(Fn&& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 生成 side x side 的网格状随机路网（含少量对角边和重边），节点ID从1开始，边长单位公里
+inline std::vector<Edge> generateGridEdges(int side, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> length(0.2, 0.6);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    std::vector<Edge> edges;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int id = r * side + c + 1;
+            if (c + 1 < side) edges.push_back({id, id + 1, length(rng)});
+            if (r + 1 < side) edges.push_back({id, id + side, length(rng)});
+            if (r + 1 < side && c + 1 < side && chance(rng) < 0.2) {
+                edges.push_back({id, id + side + 1, length(rng) * 1.4});
+            }
+        }
+    }
+    // 约10%的重边，长度与原边一致
+    size_t original = edges.size();
+    for (size_t i = 0; i < original; i += 10) {
+        edges.push_back(edges[i]);
+    }
+    return edges;
+}
+
+// 沿下一跳矩阵展开所有点对的路网路径，返回路径长度与距离矩阵的最大差异（路径断开时为无穷大）
+inline double maxRoadPathError(const RouteNetwork& network)
+{
+    std::unordered_map<long long, double> edgeLength;
+    for (const auto& edge : network.edges) {
+        for (long long key : {(long long)edge.node1 << 32 | edge.node2, (long long)edge.node2 << 32 | edge.node1}) {
+            auto it = edgeLength.find(key);
+            if (it == edgeLength.end() || edge.length < it->second) edgeLength[key] = edge.length;
+        }
+    }
+    double error = 0.0;
+    for (int a = 0; a < network.nodeCount; ++a) {
+        for (int b = 0; b < network.nodeCount; ++b) {
+            double expected = network.distanceAt(a, b);
+            RoadLeg leg(network, network.nodeIds[a], network.nodeIds[b]);
+            if (leg.empty()) {
+                if (!std::isinf(expected)) return INFINITY;
+                continue;
+            }
+            double length = 0.0;
+            int previous = -1;
+            for (int nodeId : leg) {
+                if (previous >= 0) {
+                    auto it = edgeLength.find((long long)previous << 32 | nodeId);
+                    if (it == edgeLength.end()) return INFINITY;
+                    length += it->second;
+                }
+                previous = nodeId;
+            }
+            if (previous != network.nodeIds[b]) return INFINITY;
+            error = std::max(error, std::abs(length - expected));
+        }
+    }
+    return error;
+}
+
+// 各基准测试入口，args为基准名之后的命令行参数
+int benchApsp(const std::vector<std::string>& args);
+int benchContractionHierarchy(const std::vector<std::string>& args);
+int benchNetworkUpdate(const std::vector<std::string>& args);
+int benchHilbertOrder(const std::vector<std::string>& args);
+int benchTravelTime(const std::vector<std::string>& args);
+int benchTimeDependent(const std::vector<std::string>& args);
+int benchLoad(const std::vector<std::string>& args);
+int benchDroneScan(const std::vector<std::string>& args);
+int benchNearestIndex(const std::vector<std::string>& args);
+int benchNeighborLists(const std::vector<std::string>& args);
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,102 @@
+#include "bench_common.h"
+#include "drone_kernel.h"
+#include <iostream>
+#include <limits>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 原实现：逐个候选点用 pow/sqrt 计算距离并逐条检查约束，返回满足约束（含直飞回配送中心）的最近点下标
+static int nearestByLoop(const DroneCandidates& c, const DroneScanState& s)
+{
+    double minDistance = std::numeric_limits<double>::max();
+    int nearest = -1;
+    for (size_t i = 0; i < c.size(); ++i) {
+        double distanceToTask = sqrt(pow(c.x[i] - s.fromX, 2) + pow(c.y[i] - s.fromY, 2));
+        double batteryNeededToTask = distanceToTask / s.speed;
+        if (batteryNeededToTask + c.returnTime[i] > s.battery) continue;
+        if (s.battery - batteryNeededToTask < s.minBattery) continue;
+        if (c.sendWeight[i] > 0 && s.maxProcessLoad + c.sendWeight[i] > s.maxLoad) continue;
+        if (c.pickWeight[i] > 0 && s.load + c.pickWeight[i] > s.maxLoad) continue;
+        if (s.time + batteryNeededToTask + 0.000001 < c.readyTime[i]) continue;
+        if (distanceToTask < minDistance) {
+            minDistance = distanceToTask;
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+static int nearestByKernel(const DroneCandidates& c, const DroneScanState& s, DroneKernel kernel,
+                           vector<double>& distance, vector<uint8_t>& status)
+{
+    scanDroneCandidates(c, s, distance.data(), status.data(), kernel);
+    double minDistance = std::numeric_limits<double>::max();
+    int nearest = -1;
+    for (size_t i = 0; i < c.size(); ++i) {
+        if (status[i] == CandidateFeasible && distance[i] < minDistance) {
+            minDistance = distance[i];
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+// 用法：drone [candidates=200] [queries=200000]
+int benchDroneScan(const vector<string>& args)
+{
+    int candidateCount = args.size() > 0 ? std::stoi(args[0]) : 200;
+    int queryCount = args.size() > 1 ? std::stoi(args[1]) : 200000;
+
+    // 配送中心位于原点，候选点散布在20公里见方内，约三成为已出现时间不定的额外需求点
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> coordinate(-10.0, 10.0), weight(0.0, 5.0), hour(0.0, 4.0), chance(0.0, 1.0);
+    const double speed = 60.0, maxfuel = 0.5, maxLoad = 10.0;
+    DroneCandidates candidates;
+    candidates.resize(candidateCount);
+    for (int i = 0; i < candidateCount; ++i) {
+        candidates.x[i] = coordinate(rng);
+        candidates.y[i] = coordinate(rng);
+        candidates.returnTime[i] = sqrt(candidates.x[i] * candidates.x[i] + candidates.y[i] * candidates.y[i]) / speed;
+        bool pickup = chance(rng) < 0.5;
+        candidates.pickWeight[i] = pickup ? weight(rng) : 0.0;
+        candidates.sendWeight[i] = pickup ? 0.0 : weight(rng);
+        candidates.readyTime[i] = chance(rng) < 0.3 ? hour(rng) : -std::numeric_limits<double>::infinity();
+    }
+    vector<DroneScanState> states(queryCount);
+    std::uniform_real_distribution<double> battery(0.0, maxfuel), load(0.0, maxLoad);
+    for (auto& state : states) {
+        state = {coordinate(rng), coordinate(rng), speed, battery(rng), maxfuel * 0.1, hour(rng),
+                 load(rng), load(rng), maxLoad};
+    }
+
+    vector<double> distance(candidateCount);
+    vector<uint8_t> status(candidateCount);
+    long long loopSum = 0;
+    double loopSeconds = timeSeconds([&] {
+        for (const auto& state : states) loopSum += nearestByLoop(candidates, state);
+    });
+    double calls = (double)queryCount;
+    cout << candidateCount << " 个候选点 x " << queryCount << " 次最近邻选择，本机可用: "
+         << droneKernelName(activeDroneKernel()) << endl;
+    cout << "逐点pow/sqrt循环: " << loopSeconds / calls * 1e9 << " 纳秒/次" << endl;
+
+    for (DroneKernel kernel : {DroneKernel::Scalar, DroneKernel::Sse2, DroneKernel::Avx2}) {
+        if (kernel > activeDroneKernel()) continue;
+        long long kernelSum = 0;
+        double seconds = timeSeconds([&] {
+            for (const auto& state : states) kernelSum += nearestByKernel(candidates, state, kernel, distance, status);
+        });
+        // 逐次比较选中的点，任何一次不同都说明与原实现不一致
+        int mismatches = 0;
+        for (const auto& state : states) {
+            mismatches += nearestByKernel(candidates, state, kernel, distance, status) != nearestByLoop(candidates, state);
+        }
+        cout << droneKernelName(kernel) << "扫描: " << seconds / calls * 1e9 << " 纳秒/次, 加速比: "
+             << loopSeconds / seconds << ", 与逐点循环不一致: " << mismatches << " 次, 校验和差异: "
+             << std::abs(loopSum - kernelSum) << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "hilbert_order.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 模拟路径构造中的最近邻扫描：每个配送中心从中心出发，反复在本中心未访问的任务中选距离最近者
+// 候选任务按 problem.tasks 中的顺序排列，距离按矩阵索引读取
+static double nearestNeighborTours(const DeliveryProblem& problem, const vector<int>& taskCenter, int repeats)
+{
+    const RouteNetwork& network = problem.network;
+    double total = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t c = 0; c < problem.centers.size(); ++c) {
+            vector<int> candidates;
+            for (size_t t = 0; t < problem.tasks.size(); ++t) {
+                if (taskCenter[toRoadNodeId(problem.tasks[t].id)] == (int)c) {
+                    candidates.push_back(network.indexOf(toRoadNodeId(problem.tasks[t].id)));
+                }
+            }
+            int current = network.indexOf(toRoadNodeId(problem.centers[c].id));
+            while (!candidates.empty()) {
+                size_t best = 0;
+                double bestDistance = INFINITY;
+                for (size_t k = 0; k < candidates.size(); ++k) {
+                    double d = network.distanceAt(current, candidates[k]);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        best = k;
+                    }
+                }
+                total += bestDistance;
+                current = candidates[best];
+                candidates[best] = candidates.back();
+                candidates.pop_back();
+            }
+        }
+    }
+    return total;
+}
+
+// 用法：hilbert [side] [tasks] [centers] [threads] [repeats]
+int benchHilbertOrder(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 90;
+    int taskCount = args.size() > 1 ? std::stoi(args[1]) : 3000;
+    int centerCount = args.size() > 2 ? std::stoi(args[2]) : 10;
+    int threads = args.size() > 3 ? std::stoi(args[3]) : 4;
+    int repeats = args.size() > 4 ? std::stoi(args[4]) : 20;
+    side = std::min(side, 99);  // 节点ID需小于10000，避免与额外任务ID的偏移冲突
+    taskCount = std::min(taskCount, side * side - centerCount);
+
+    // 网格路网，节点坐标即网格位置；任务和配送中心随机分布且文件中的顺序随机
+    DeliveryProblem problem;
+    problem.network.edges = generateGridEdges(side, 42);
+    vector<int> nodes(side * side);
+    for (int i = 0; i < side * side; ++i) nodes[i] = i + 1;
+    std::mt19937 rng(11);
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    auto coordinate = [&](int nodeId) {
+        return std::make_pair(((nodeId - 1) % side) * 0.4, ((nodeId - 1) / side) * 0.4);
+    };
+    for (int t = 0; t < taskCount; ++t) {
+        auto [x, y] = coordinate(nodes[t]);
+        problem.tasks.push_back({nodes[t], x, y, 0.0, DeliveryProblem::DEFAULT_CENTER_ID, 5.0, 0.0});
+    }
+    for (int c = 0; c < centerCount; ++c) {
+        int nodeId = nodes[taskCount + c];
+        auto [x, y] = coordinate(nodeId);
+        problem.centers.push_back({nodeId + 20000, x, y, 1, 0, {}});
+    }
+    problem.initialDemandCount = taskCount;
+    problem.extraDemandCount = 0;
+
+    // 每个任务归属欧氏距离最近的配送中心
+    vector<int> taskCenter(side * side + 1, -1);
+    for (const auto& task : problem.tasks) {
+        double best = INFINITY;
+        for (size_t c = 0; c < problem.centers.size(); ++c) {
+            double d = std::hypot(task.x - problem.centers[c].x, task.y - problem.centers[c].y);
+            if (d < best) {
+                best = d;
+                taskCenter[task.id] = c;
+            }
+        }
+    }
+
+    double seconds = timeSeconds([&] {
+        terminalDijkstra(problem.network, collectTerminalNodes(problem), threads);
+    });
+    cout << "路网节点数: " << side * side << ", 终端节点数: " << problem.network.nodeCount
+         << ", 距离矩阵 " << problem.network.distMatrix.size() * sizeof(double) / 1048576.0
+         << " MB, 计算用时: " << seconds << " 秒" << endl;
+
+    double originalLength = 0.0;
+    double originalSeconds = timeSeconds([&] {
+        originalLength = nearestNeighborTours(problem, taskCenter, repeats);
+    });
+    cout << "原始顺序最近邻构造: " << originalSeconds << " 秒" << endl;
+
+    // Hilbert重排：任务列表排序，距离矩阵按节点顺序置换
+    DeliveryProblem sorted = problem;
+    double reorderSeconds = timeSeconds([&] {
+        sortTasksAlongHilbert(sorted);
+        permuteMatrixNodes(sorted.network, hilbertNodeOrder(sorted, sorted.network.nodeIds));
+    });
+    double sortedLength = 0.0;
+    double sortedSeconds = timeSeconds([&] {
+        sortedLength = nearestNeighborTours(sorted, taskCenter, repeats);
+    });
+    cout << "Hilbert顺序最近邻构造: " << sortedSeconds << " 秒, 加速比: " << originalSeconds / sortedSeconds
+         << ", 重排用时: " << reorderSeconds << " 秒" << endl;
+    cout << "路径总长度差异: " << std::abs(originalLength - sortedLength) << endl;
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include "bench_common.h"
+#include "input_parser.h"
+#include "instance_delta.h"
+#include "instance_file.h"
+#include "mapped_file.h"
+#include "shortest_path.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 各段的记录数
+struct SectionCounts
+{
+    int edgeCount, taskCount, extraCount, centerCount;
+};
+
+// 生成 side x side 网格路网的输入文件：每条边一行速度系数，任务点与配送中心取ID小于10000的随机节点
+static SectionCounts writeInputFile(const string& path, int side, int taskCount, int extraCount)
+{
+    vector<Edge> edges = generateGridEdges(side, 42);
+    std::mt19937 rng(5);
+    vector<int> nodes(std::min(side * side, 9999));
+    for (size_t i = 0; i < nodes.size(); ++i) nodes[i] = i + 1;
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    int carCenters = 4, droneCenters = 2;
+    taskCount = std::min<int>(taskCount, nodes.size() - carCenters - droneCenters);
+    extraCount = std::min(extraCount, taskCount);
+
+    std::ofstream out(path);
+    out.setf(std::ios::fixed);
+    auto location = [&](int nodeId) {
+        out.precision(6);
+        out << 120.0 + ((nodeId - 1) % side) * 0.004 << " " << 30.0 + ((nodeId - 1) / side) * 0.0036;
+    };
+    out << taskCount << " " << extraCount << " " << carCenters << " " << droneCenters << "\n";
+    out << "20 10 0.84 0.62 20 2.0 0.1\n" << edges.size() << "\n";
+    out.precision(2);
+    for (const auto& edge : edges) {
+        out << edge.node1 << " " << edge.node2 << " " << edge.length * 1000.0 << "\n";
+    }
+    for (int t = 0; t < taskCount; ++t) {
+        out << nodes[t] << " ";
+        location(nodes[t]);
+        out << " " << 1 + t % 5 << " " << t % 4 << "\n";
+    }
+    for (int c = 0; c < carCenters + droneCenters; ++c) {
+        int nodeId = nodes[taskCount + c];
+        out << nodeId << " ";
+        location(nodeId);
+        out << " " << 4 << "\n";
+    }
+    for (int t = 0; t < extraCount; ++t) {
+        out << nodes[t] << " ";
+        location(nodes[t]);
+        out << " " << 1 + t % 3 << " 0 " << 60 + t % 600 << "\n";
+    }
+    std::uniform_real_distribution<double> factor(0.4, 1.0);
+    out.precision(2);
+    for (const auto& edge : edges) {
+        out << edge.node1 << " " << edge.node2 << " " << factor(rng) << " " << factor(rng) << "\n";
+    }
+    return {(int)edges.size(), taskCount, extraCount, carCenters + droneCenters};
+}
+
+// 原加载方式：ifstream逐个读取，返回读到的速度系数行数
+static size_t streamParse(const string& path, const SectionCounts& counts, vector<Edge>& edges)
+{
+    std::ifstream file(path);
+    int header[5];
+    double parameters[7];
+    for (int& value : header) file >> value;
+    for (double& value : parameters) file >> value;
+    edges.resize(counts.edgeCount);
+    for (auto& edge : edges) {
+        file >> edge.node1 >> edge.node2 >> edge.length;
+        edge.length /= 1000.0;
+    }
+    int id, count;
+    double lon, lat, pickup, delivery, arrival;
+    for (int i = 0; i < counts.taskCount; ++i) file >> id >> lon >> lat >> pickup >> delivery;
+    for (int i = 0; i < counts.centerCount; ++i) file >> id >> lon >> lat >> count;
+    for (int i = 0; i < counts.extraCount; ++i) file >> id >> lon >> lat >> pickup >> delivery >> arrival;
+    vector<EdgePeakFactor> factors;
+    int node1, node2;
+    double morning, evening;
+    while (file >> node1 >> node2 >> morning >> evening) {
+        factors.push_back({node1, node2, {morning, evening}});
+    }
+    return factors.size();
+}
+
+// 映射文件后就地解析，边与速度系数两段按threads并行
+static size_t mappedParse(const string& path, const SectionCounts& counts, vector<Edge>& edges, int threads)
+{
+    MappedFile file;
+    if (!file.open(path)) return 0;
+    TokenScanner scanner(file.data(), file.data() + file.size());
+    int header[5];
+    double parameters[7];
+    for (int& value : header) scanner.read(value);
+    for (double& value : parameters) scanner.read(value);
+    if (!parseEdgeSection(scanner, counts.edgeCount, edges, threads)) return 0;
+    int id, count;
+    double lon, lat, pickup, delivery, arrival;
+    for (int i = 0; i < counts.taskCount; ++i) scanner.readAll(id, lon, lat, pickup, delivery);
+    for (int i = 0; i < counts.centerCount; ++i) scanner.readAll(id, lon, lat, count);
+    for (int i = 0; i < counts.extraCount; ++i) scanner.readAll(id, lon, lat, pickup, delivery, arrival);
+    return parseFactorSection(scanner.position(), scanner.limit(), threads).size();
+}
+
+// 加载时屏蔽标准输出
+static bool quietLoad(const string& path, DeliveryProblem& problem, vector<EdgePeakFactor>* factorLines = nullptr)
+{
+    std::ostringstream sink;
+    std::streambuf* saved = cout.rdbuf(sink.rdbuf());
+    bool loaded = loadProblemData(path, problem, factorLines);
+    cout.rdbuf(saved);
+    return loaded;
+}
+
+// 用法：load [side] [tasks] [threads] [path]
+int benchLoad(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 200;
+    int taskCount = args.size() > 1 ? std::stoi(args[1]) : 300;
+    int threads = args.size() > 2 ? std::stoi(args[2]) : 4;
+    string path = args.size() > 3 ? args[3] : "bench_load_input.txt";
+    int extraCount = taskCount / 3;
+
+    SectionCounts counts = writeInputFile(path, side, taskCount, extraCount);
+    std::ifstream sizeProbe(path, std::ios::ate | std::ios::binary);
+    cout << "输入文件: " << path << ", " << sizeProbe.tellg() / 1048576.0 << " MB, 边数: " << counts.edgeCount
+         << ", 任务点: " << counts.taskCount + counts.extraCount << endl;
+
+    // 两种解析方式结果一致
+    vector<Edge> streamEdges, mappedEdges;
+    size_t streamFactors = 0, mappedFactors = 0;
+    double streamSeconds = timeSeconds([&] { streamFactors = streamParse(path, counts, streamEdges); });
+    cout << "ifstream逐个读取: " << streamSeconds << " 秒" << endl;
+    for (int t : {1, threads}) {
+        double seconds = timeSeconds([&] { mappedFactors = mappedParse(path, counts, mappedEdges, t); });
+        bool same = mappedFactors == streamFactors && mappedEdges.size() == streamEdges.size() &&
+                    std::equal(mappedEdges.begin(), mappedEdges.end(), streamEdges.begin(),
+                               [](const Edge& a, const Edge& b) {
+                                   return a.node1 == b.node1 && a.node2 == b.node2 && a.length == b.length;
+                               });
+        cout << "mmap + from_chars（" << t << " 线程）: " << seconds << " 秒, 加速比: " << streamSeconds / seconds
+             << (same ? "" : "，结果不一致！") << endl;
+    }
+
+    // 每条速度系数记录拆成两行时，块边界可能落在记录中间，分块解析仍须与顺序解析一致
+    std::ostringstream split;
+    for (int i = 0; i < 40000; ++i) split << i + 1 << " " << i + 2 << "\n0." << 4 + i % 6 << " 0." << 9 - i % 5 << "\n";
+    string splitText = split.str();
+    vector<EdgePeakFactor> sequentialSplit = parseFactorSection(splitText.data(), splitText.data() + splitText.size(), 1);
+    vector<EdgePeakFactor> chunkedSplit = parseFactorSection(splitText.data(), splitText.data() + splitText.size(), threads);
+    bool splitSame = sequentialSplit.size() == chunkedSplit.size() &&
+                     std::equal(sequentialSplit.begin(), sequentialSplit.end(), chunkedSplit.begin(),
+                                [](const EdgePeakFactor& a, const EdgePeakFactor& b) {
+                                    return a.node1 == b.node1 && a.node2 == b.node2 &&
+                                           a.factor.morning == b.factor.morning && a.factor.evening == b.factor.evening;
+                                });
+    cout << "记录跨行的速度系数段（" << threads << " 线程）: " << chunkedSplit.size() << " / " << sequentialSplit.size()
+         << " 条" << (splitSame ? "" : "，结果不一致！") << endl;
+
+    // 完整加载：最短路与任务点、配送中心及速度系数的解析重叠，对比解析与最短路分别计时之和
+    DeliveryProblem lazyProblem;
+    lazyProblem.config.apspMethod = ApspMethod::Lazy;
+    lazyProblem.config.threadCount = threads;
+    vector<EdgePeakFactor> factorLines;
+    double parseSeconds = timeSeconds([&] { quietLoad(path, lazyProblem, &factorLines); });
+
+    DeliveryProblem problem;
+    problem.config.apspMethod = ApspMethod::Dijkstra;
+    problem.config.threadCount = threads;
+    double loadSeconds = timeSeconds([&] { quietLoad(path, problem); });
+    DeliveryProblem again = lazyProblem;
+    again.config.apspMethod = ApspMethod::Dijkstra;
+    std::ostringstream sink;
+    std::streambuf* saved = cout.rdbuf(sink.rdbuf());
+    double apspSeconds = timeSeconds([&] { computeShortestPaths(again); });
+    cout.rdbuf(saved);
+    cout << "完整加载（--apsp=lazy，几乎只有解析）: " << parseSeconds << " 秒" << endl;
+    cout << "完整加载（--apsp=dijkstra）: " << loadSeconds << " 秒, 单独计算最短路: " << apspSeconds
+         << " 秒, 重叠节省: " << parseSeconds + apspSeconds - loadSeconds << " 秒" << endl;
+
+    // 同一输入转换为二进制实例后加载：不含矩阵时照常计算最短路，含矩阵时直接映射
+    string binaryPath = path + ".bin", matrixPath = path + ".matrix.bin";
+    saveInstanceFile(binaryPath, lazyProblem, factorLines, false);
+    saveInstanceFile(matrixPath, problem, factorLines, true);
+    DeliveryProblem binaryProblem;
+    binaryProblem.config.apspMethod = ApspMethod::Lazy;
+    double binarySeconds = timeSeconds([&] { quietLoad(binaryPath, binaryProblem); });
+    DeliveryProblem matrixProblem;
+    matrixProblem.config.apspMethod = ApspMethod::Dijkstra;
+    double matrixSeconds = timeSeconds([&] { quietLoad(matrixPath, matrixProblem); });
+    cout << "二进制实例加载（--apsp=lazy）: " << binarySeconds << " 秒, 加速比: " << parseSeconds / binarySeconds << endl;
+    cout << "含距离矩阵的二进制实例加载（--apsp=dijkstra）: " << matrixSeconds << " 秒, 加速比: "
+         << loadSeconds / matrixSeconds << endl;
+
+    // 日内变更：新增与取消若干任务，就地应用增量与完整重新加载对比
+    std::mt19937 rng(11);
+    vector<DeltaOp> ops;
+    int changeCount = std::max(1, counts.taskCount / 20);
+    for (int k = 0; (int)ops.size() < changeCount && k < side * side; ++k) {
+        int nodeId = rng() % std::min(side * side, 9999) + 1;
+        if (problem.taskIdToIndex.count(nodeId + 10000)) continue;
+        DeltaOp op{DeltaKind::AddTask};
+        op.task = {nodeId + 10000, 0.0, 0.0, 1.0 + k % 8, DeliveryProblem::DEFAULT_CENTER_ID, 1.0, 0.0};
+        op.extra = true;
+        ops.push_back(op);
+    }
+    for (int k = 0; k < changeCount; ++k) {
+        DeltaOp op{DeltaKind::CancelTask};
+        op.id = problem.tasks[k * 7 % problem.initialDemandCount].id;
+        if (std::none_of(ops.begin(), ops.end(), [&](const DeltaOp& other) { return other.id == op.id; })) ops.push_back(op);
+    }
+    bool applied = false;
+    double deltaSeconds = timeSeconds([&] { applied = applyDelta(problem, ops); });
+    cout << "增量应用 " << ops.size() << " 项变更（--apsp=dijkstra）: " << deltaSeconds * 1000.0 << " 毫秒, 相对完整重新加载加速比: "
+         << loadSeconds / deltaSeconds << (applied ? "" : "，应用失败！") << endl;
+
+    std::remove(path.c_str());
+    std::remove(binaryPath.c_str());
+    std::remove(matrixPath.c_str());
+    return 0;
+}
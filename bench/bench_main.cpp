@@ -0,0 +1,44 @@
+#include "bench_common.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <benchmark> [args...]" << endl;
+        cout << "  apsp [side=40] [threads=4]    朴素Floyd、分块多线程Floyd与终端多源Dijkstra对比" << endl;
+        cout << "  ch [side=60] [threads=4] [queries=100000]    收缩层次预处理/查询与Floyd对比" << endl;
+        cout << "  update [side=40] [threads=4] [updates=40]    单路段更新的增量修复与全量重算对比" << endl;
+        cout << "  hilbert [side=90] [tasks=3000] [centers=10] [threads=4] [repeats=20]    Hilbert重排前后最近邻扫描对比" << endl;
+        cout << "  travel [legs=200000] [repeats=10] [maxDistance=60]    高峰期行驶时间：分段线性函数与逐段循环对比" << endl;
+        cout << "  td [side=60] [terminals=200] [queries=200000] [bucketMinutes=15]    时变最短路缓存插值与精确结果对比" << endl;
+        cout << "  load [side=200] [tasks=300] [threads=4] [path]    生成大输入文件，对比ifstream与mmap+from_chars解析、最短路重叠加载、二进制实例加载及增量变更" << endl;
+        cout << "  drone [candidates=200] [queries=200000]    无人机候选点扫描：SIMD批量计算与逐点pow/sqrt循环对比" << endl;
+        cout << "  nearest [side=99] [tasks=3000] [centers=6] [threads=4]    车辆最近邻路径构造：网格索引与顺序扫描对比" << endl;
+        cout << "  neighbors [side=99] [tasks=3000] [centers=6] [k=16] [threads=4]    车辆/无人机最近邻路径构造：K近邻表与顺序扫描对比" << endl;
+        return 1;
+    }
+
+    string name = argv[1];
+    vector<string> args(argv + 2, argv + argc);
+
+    if (name == "apsp") return benchApsp(args);
+    if (name == "ch") return benchContractionHierarchy(args);
+    if (name == "update") return benchNetworkUpdate(args);
+    if (name == "hilbert") return benchHilbertOrder(args);
+    if (name == "travel") return benchTravelTime(args);
+    if (name == "td") return benchTimeDependent(args);
+    if (name == "load") return benchLoad(args);
+    if (name == "drone") return benchDroneScan(args);
+    if (name == "nearest") return benchNearestIndex(args);
+    if (name == "neighbors") return benchNeighborLists(args);
+
+    cout << "未知的基准测试: " << name << endl;
+    return 1;
+}
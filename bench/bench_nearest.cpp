@@ -0,0 +1,76 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "spatial_index.h"
+#include "path_optimizer.h"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 用法：nearest [side=99] [tasks=3000] [centers=6] [threads=4]
+// 每个配送中心一辆车，对比顺序扫描与网格索引的静态最近邻路径构造
+int benchNearestIndex(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 99;
+    int taskCount = args.size() > 1 ? std::stoi(args[1]) : 3000;
+    int centerCount = args.size() > 2 ? std::stoi(args[2]) : 6;
+    int threads = args.size() > 3 ? std::stoi(args[3]) : 4;
+    side = std::min(side, 99);  // 节点ID需小于10000，避免与额外任务ID的偏移冲突
+    taskCount = std::min(taskCount, side * side - centerCount);
+
+    // 网格路网，节点坐标即网格位置（间距0.4公里，与边长0.2~0.6公里相当）
+    DeliveryProblem problem;
+    problem.network.edges = generateGridEdges(side, 42);
+    vector<int> nodes(side * side);
+    for (int i = 0; i < side * side; ++i) nodes[i] = i + 1;
+    std::mt19937 rng(13);
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    auto coordinate = [&](int nodeId) {
+        return std::make_pair(((nodeId - 1) % side) * 0.4, ((nodeId - 1) / side) * 0.4);
+    };
+    for (int t = 0; t < taskCount; ++t) {
+        auto [x, y] = coordinate(nodes[t]);
+        problem.tasks.push_back({nodes[t], x, y, 0.0, DeliveryProblem::DEFAULT_CENTER_ID, 5.0, 0.0});
+        problem.taskIdToIndex[nodes[t]] = t;
+    }
+    vector<Vehicle> vehicles;
+    for (int c = 0; c < centerCount; ++c) {
+        int nodeId = nodes[taskCount + c];
+        auto [x, y] = coordinate(nodeId);
+        problem.centers.push_back({nodeId + 20000, x, y, 1, 0, {}});
+        problem.centerIdToIndex[nodeId + 20000] = c;
+        vehicles.push_back({c + 1, 40.0, 1.0, 0.0, 0.0, nodeId + 20000});
+    }
+    problem.initialDemandCount = taskCount;
+    problem.extraDemandCount = 0;
+
+    // 任务按随机顺序轮流分给各车（每车不超过路径构造的1000次迭代上限）
+    vector<vector<int>> assigned(centerCount);
+    for (int t = 0; t < taskCount; ++t) {
+        assigned[t % centerCount].push_back(problem.tasks[t].id);
+    }
+
+    terminalDijkstra(problem.network, collectTerminalNodes(problem), threads);
+    buildNodeHandles(problem);
+    double calibrateSeconds = timeSeconds([&] { calibrateEuclideanLowerBound(problem); });
+    cout << "路网节点数: " << side * side << ", 任务数: " << taskCount << ", 每车约 " << taskCount / centerCount
+         << " 个任务, 直线距离下界系数: " << problem.network.euclideanLowerBound << "（标定用时 "
+         << calibrateSeconds << " 秒）" << endl;
+
+    auto buildRoutes = [&](int minTasks, vector<vector<int>>& paths) {
+        problem.config.spatialIndexMinTasks = minTasks;
+        paths.clear();
+        for (int c = 0; c < centerCount; ++c) {
+            paths.push_back(optimizePathForVehicle(assigned[c], problem.tasks, vehicles[c], problem));
+        }
+    };
+    vector<vector<int>> scanned, indexed;
+    double scanSeconds = timeSeconds([&] { buildRoutes(0, scanned); });
+    double indexSeconds = timeSeconds([&] { buildRoutes(1, indexed); });
+    cout << "顺序扫描: " << scanSeconds << " 秒" << endl;
+    cout << "网格索引: " << indexSeconds << " 秒, 加速比: " << scanSeconds / indexSeconds
+         << ", 路径" << (scanned == indexed ? "一致" : "不一致") << endl;
+    return scanned == indexed ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "neighbor_lists.h"
+#include "path_optimizer.h"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 用法：neighbors [side=99] [tasks=3000] [centers=6] [k=16] [threads=4]
+// 每个配送中心一辆车和一架无人机，对比顺序扫描与先查K近邻表的静态最近邻路径构造（不启用网格索引）
+int benchNeighborLists(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 99;
+    int taskCount = args.size() > 1 ? std::stoi(args[1]) : 3000;
+    int centerCount = args.size() > 2 ? std::stoi(args[2]) : 6;
+    int k = args.size() > 3 ? std::stoi(args[3]) : 16;
+    int threads = args.size() > 4 ? std::stoi(args[4]) : 4;
+    side = std::min(side, 99);  // 节点ID需小于10000，避免与额外任务ID的偏移冲突
+    taskCount = std::min(taskCount, side * side - centerCount);
+
+    // 网格路网，节点坐标即网格位置（间距0.4公里，与边长0.2~0.6公里相当）
+    DeliveryProblem problem;
+    problem.config.threadCount = threads;
+    problem.config.spatialIndexMinTasks = 0;
+    problem.network.edges = generateGridEdges(side, 42);
+    vector<int> nodes(side * side);
+    for (int i = 0; i < side * side; ++i) nodes[i] = i + 1;
+    std::mt19937 rng(13);
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    auto coordinate = [&](int nodeId) {
+        return std::make_pair(((nodeId - 1) % side) * 0.4, ((nodeId - 1) / side) * 0.4);
+    };
+    for (int t = 0; t < taskCount; ++t) {
+        auto [x, y] = coordinate(nodes[t]);
+        problem.tasks.push_back({nodes[t], x, y, 0.0, DeliveryProblem::DEFAULT_CENTER_ID, 5.0, 0.0});
+        problem.taskIdToIndex[nodes[t]] = t;
+    }
+    vector<Vehicle> cars, drones;
+    for (int c = 0; c < centerCount; ++c) {
+        int nodeId = nodes[taskCount + c];
+        auto [x, y] = coordinate(nodeId);
+        problem.centers.push_back({nodeId + 20000, x, y, 1, 1, {}});
+        problem.centerIdToIndex[nodeId + 20000] = c;
+        cars.push_back({c + 1, 40.0, 1.0, 0.0, 0.0, nodeId + 20000});
+        // 续航足以往返网格对角，每次行程取4个货
+        drones.push_back({centerCount + c + 1, 60.0, 0.5, 20.0, 2.0, nodeId + 20000});
+    }
+    problem.initialDemandCount = taskCount;
+    problem.extraDemandCount = 0;
+
+    // 任务按随机顺序轮流分给各车（每车不超过路径构造的1000次迭代上限），无人机分到同样的任务
+    vector<vector<int>> assigned(centerCount);
+    for (int t = 0; t < taskCount; ++t) {
+        assigned[t % centerCount].push_back(problem.tasks[t].id);
+    }
+
+    terminalDijkstra(problem.network, collectTerminalNodes(problem), threads);
+    buildNodeHandles(problem);
+    std::shared_ptr<const NeighborLists> lists;
+    double buildSeconds = timeSeconds([&] { lists = buildNeighborLists(problem, k); });
+    cout << "路网节点数: " << side * side << ", 任务数: " << taskCount << ", 每车约 " << taskCount / centerCount
+         << " 个任务, K=" << k << ", 近邻表建立用时 " << buildSeconds << " 秒（" << threads << " 线程）" << endl;
+
+    auto buildRoutes = [&](const vector<Vehicle>& vehicles, vector<vector<int>>& paths) {
+        paths.clear();
+        for (int c = 0; c < centerCount; ++c) {
+            paths.push_back(optimizePathForVehicle(assigned[c], problem.tasks, vehicles[c], problem));
+        }
+    };
+    bool same = true;
+    for (const auto* vehicles : {&cars, &drones}) {
+        vector<vector<int>> scanned, listed;
+        problem.neighbors = nullptr;
+        double scanSeconds = timeSeconds([&] { buildRoutes(*vehicles, scanned); });
+        problem.neighbors = lists;
+        double listSeconds = timeSeconds([&] { buildRoutes(*vehicles, listed); });
+        same = same && scanned == listed;
+        cout << (vehicles == &cars ? "车辆" : "无人机") << " 顺序扫描: " << scanSeconds << " 秒, 近邻表: " << listSeconds
+             << " 秒, 加速比: " << scanSeconds / listSeconds << ", 路径" << (scanned == listed ? "一致" : "不一致") << endl;
+    }
+    return same ? 0 : 1;
+}
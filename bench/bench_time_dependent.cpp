@@ -0,0 +1,93 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "time_dependent.h"
+#include "travel_time.h"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 用法：td [side] [terminals] [queries] [bucketMinutes]
+int benchTimeDependent(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 60;
+    int terminalCount = args.size() > 1 ? std::stoi(args[1]) : 200;
+    int queryCount = args.size() > 2 ? std::stoi(args[2]) : 200000;
+    int bucketMinutes = args.size() > 3 ? std::stoi(args[3]) : 15;
+    terminalCount = std::min(terminalCount, side * side);
+
+    // 网格路网，每条路段随机的早晚高峰系数（拥堵程度不同，高峰期最快路线会绕开拥堵路段）
+    vector<Edge> edges = generateGridEdges(side, 42);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> factor(0.2, 1.0);
+    vector<EdgePeakFactor> edgeFactors;
+    for (const auto& edge : edges) {
+        edgeFactors.push_back({edge.node1, edge.node2, {factor(rng), factor(rng)}});
+    }
+    vector<int> nodes(side * side);
+    for (int i = 0; i < side * side; ++i) nodes[i] = i + 1;
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    vector<int> terminals(nodes.begin(), nodes.begin() + terminalCount);
+
+    SolverConfig config;
+    CsrGraph graph = buildCsrGraph(edges);
+    TimeDependentRoutes routes(graph, edgeFactors, buildTravelTimeProfile(config.peakWindows), terminals,
+                               bucketMinutes, config.rowCacheBytes);
+    TravelTimeProfile profile = buildTravelTimeProfile(config.peakWindows);
+
+    // 原模型所需的终端之间最短距离
+    vector<vector<double>> distances(terminalCount);
+    for (int s = 0; s < terminalCount; ++s) {
+        dijkstra(graph, graph.indexOf(terminals[s]), distances[s]);
+    }
+
+    struct Query { int from, to; double departure; };
+    const double speed = 30.0;
+    std::uniform_int_distribution<int> pick(0, terminalCount - 1);
+    std::uniform_real_distribution<double> departure(0.0, 24.0);
+    vector<Query> queries(queryCount);
+    for (auto& query : queries) {
+        query = {pick(rng), pick(rng), departure(rng)};
+    }
+
+    double checksum = 0.0;
+    double warmSeconds = timeSeconds([&] {
+        for (const auto& query : queries) checksum += routes.travelTime(query.from, query.to, query.departure, speed);
+    });
+    double cachedSeconds = timeSeconds([&] {
+        for (const auto& query : queries) checksum += routes.travelTime(query.from, query.to, query.departure, speed);
+    });
+
+    // 与精确时变Dijkstra对比误差（抽样），并对比原模型：最短距离路线整体乘以默认高峰系数
+    int samples = std::min(queryCount, 2000);
+    double cachedError = 0.0, cachedMaxError = 0.0, staticError = 0.0, staticMaxError = 0.0;
+    double exactSeconds = timeSeconds([&] {
+        for (int i = 0; i < samples; ++i) {
+            const Query& query = queries[i];
+            double exact = routes.exactTravelTime(terminals[query.from], terminals[query.to], query.departure, speed);
+            double cached = routes.travelTime(query.from, query.to, query.departure, speed);
+            double distance = distances[query.from][graph.indexOf(terminals[query.to])];
+            BandTravelTimes times = {{distance, distance / DeliveryProblem::DEFAULT_MORNING_PEAK_FACTOR,
+                                      distance / DeliveryProblem::DEFAULT_EVENING_PEAK_FACTOR}};
+            double approximate = legTravelTime(profile, times, speed, query.departure);
+            cachedError += std::abs(cached - exact);
+            cachedMaxError = std::max(cachedMaxError, std::abs(cached - exact));
+            staticError += std::abs(approximate - exact);
+            staticMaxError = std::max(staticMaxError, std::abs(approximate - exact));
+        }
+    });
+
+    TimeDependentStats stats = routes.stats();
+    cout << "路网节点数: " << side * side << ", 终端节点数: " << terminalCount << ", 时间桶: " << bucketMinutes
+         << " 分钟 (" << routes.bucketCount() << " 个)" << endl;
+    cout << "首次查询（含建立 " << stats.misses << " 行缓存）: " << warmSeconds << " 秒" << endl;
+    cout << "缓存插值查询: " << cachedSeconds / queryCount * 1e9 << " 纳秒/次" << endl;
+    cout << "精确时变Dijkstra: " << exactSeconds / samples * 1e6 << " 微秒/次（含对照计算）" << endl;
+    cout << "缓存插值与精确结果误差: 平均 " << cachedError / samples * 60.0 << " 分钟, 最大 "
+         << cachedMaxError * 60.0 << " 分钟" << endl;
+    cout << "最短距离路线整体乘系数的误差: 平均 " << staticError / samples * 60.0 << " 分钟, 最大 "
+         << staticMaxError * 60.0 << " 分钟（校验和 " << checksum << "）" << endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "bench_common.h"
+#include "travel_time.h"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 原实现：逐段循环跨越早晚高峰边界（7-9点、17-19点），用作结果对照
+static double phaseLoopTravelTime(double distance, double morningFactor, double eveningFactor,
+                                  double speed, double currentTime)
+{
+    double remainingDistance = distance;
+    double totalTime = 0.0;
+    double travelTime = currentTime;
+    while (remainingDistance > 0.0001) {
+        bool isMorningPeak = (travelTime >= 7.0 && travelTime < 9.0);
+        bool isEveningPeak = (travelTime >= 17.0 && travelTime < 19.0);
+        double speedFactor = isMorningPeak ? morningFactor : isEveningPeak ? eveningFactor : 1.0;
+        double currentSpeed = speed * speedFactor;
+
+        double timeToNextPhase;
+        if (travelTime < 7.0) {
+            timeToNextPhase = 7.0 - travelTime;
+        } else if (travelTime < 9.0) {
+            timeToNextPhase = 9.0 - travelTime;
+        } else if (travelTime < 17.0) {
+            timeToNextPhase = 17.0 - travelTime;
+        } else if (travelTime < 19.0) {
+            timeToNextPhase = 19.0 - travelTime;
+        } else {
+            timeToNextPhase = 24.0 - travelTime + 7.0;
+        }
+
+        double distanceCanTravel = currentSpeed * timeToNextPhase;
+        if (distanceCanTravel >= remainingDistance) {
+            totalTime += remainingDistance / currentSpeed;
+            remainingDistance = 0;
+        } else {
+            totalTime += timeToNextPhase;
+            remainingDistance -= distanceCanTravel;
+            travelTime += timeToNextPhase;
+            if (travelTime >= 24.0) {
+                travelTime -= 24.0;
+            }
+        }
+    }
+    return totalTime;
+}
+
+struct TravelLeg
+{
+    double distance, morningFactor, eveningFactor, speed, departure;
+};
+
+// 用法：travel [legs] [repeats] [maxDistance]
+int benchTravelTime(const vector<string>& args)
+{
+    int legCount = args.size() > 0 ? std::stoi(args[0]) : 200000;
+    int repeats = args.size() > 1 ? std::stoi(args[1]) : 10;
+    double maxDistance = args.size() > 2 ? std::stod(args[2]) : 60.0;
+
+    // 随机路段：出发时间限定在原实现能正确处理的 [0, 31) 小时内
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> distance(0.5, maxDistance), factor(0.2, 1.0), speed(15.0, 60.0), departure(0.0, 31.0);
+    vector<TravelLeg> legs(legCount);
+    for (auto& leg : legs) {
+        leg = {distance(rng), factor(rng), factor(rng), speed(rng), departure(rng)};
+    }
+    vector<BandTravelTimes> times(legCount);
+    for (int i = 0; i < legCount; ++i) {
+        const TravelLeg& leg = legs[i];
+        times[i] = {{leg.distance, leg.distance / leg.morningFactor, leg.distance / leg.eveningFactor}};
+    }
+
+    SolverConfig config;
+    TravelTimeProfile profile = buildTravelTimeProfile(config.peakWindows);
+
+    double loopSum = 0.0, closedSum = 0.0;
+    double loopSeconds = timeSeconds([&] {
+        for (int r = 0; r < repeats; ++r) {
+            for (const auto& leg : legs) {
+                loopSum += phaseLoopTravelTime(leg.distance, leg.morningFactor, leg.eveningFactor, leg.speed, leg.departure);
+            }
+        }
+    });
+    double closedSeconds = timeSeconds([&] {
+        for (int r = 0; r < repeats; ++r) {
+            for (int i = 0; i < legCount; ++i) {
+                closedSum += legTravelTime(profile, times[i], legs[i].speed, legs[i].departure);
+            }
+        }
+    });
+
+    double maxError = 0.0, maxRelative = 0.0;
+    for (int i = 0; i < legCount; ++i) {
+        const TravelLeg& leg = legs[i];
+        double expected = phaseLoopTravelTime(leg.distance, leg.morningFactor, leg.eveningFactor, leg.speed, leg.departure);
+        double actual = legTravelTime(profile, times[i], leg.speed, leg.departure);
+        maxError = std::max(maxError, std::abs(actual - expected));
+        maxRelative = std::max(maxRelative, std::abs(actual - expected) / expected);
+    }
+
+    double calls = (double)legCount * repeats;
+    cout << legCount << " 条随机路段（0.5~" << maxDistance << " 公里）x " << repeats << " 次" << endl;
+    cout << "逐段循环: " << loopSeconds / calls * 1e9 << " 纳秒/次" << endl;
+    cout << "分段线性函数: " << closedSeconds / calls * 1e9 << " 纳秒/次, 加速比: " << loopSeconds / closedSeconds << endl;
+    cout << "与逐段循环结果最大差异: " << maxError << " 小时（相对 " << maxRelative << "）, 校验和差异: "
+         << std::abs(loopSum - closedSum) << endl;
+
+    // 时间窗较多时二分查找的开销
+    vector<PeakWindow> windows;
+    parsePeakWindows("6-7,7.5-9,11.5-13,16-17,17.5-19,21-22", windows);
+    TravelTimeProfile manyWindows = buildTravelTimeProfile(windows);
+    double manySum = 0.0;
+    double manySeconds = timeSeconds([&] {
+        for (int r = 0; r < repeats; ++r) {
+            for (int i = 0; i < legCount; ++i) {
+                manySum += legTravelTime(manyWindows, times[i], legs[i].speed, legs[i].departure);
+            }
+        }
+    });
+    cout << windows.size() << " 个高峰时间窗（" << manyWindows.bands.size() << " 段）: "
+         << manySeconds / calls * 1e9 << " 纳秒/次 (" << manySum / calls << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "bench_common.h"
+#include "shortest_path.h"
+#include "network_update.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+// 用法：update [side] [threads] [updates]
+int benchNetworkUpdate(const vector<string>& args)
+{
+    int side = args.size() > 0 ? std::stoi(args[0]) : 40;
+    int threads = args.size() > 1 ? std::stoi(args[1]) : 4;
+    int updates = args.size() > 2 ? std::stoi(args[2]) : 40;
+
+    RouteNetwork network;
+    network.edges = generateGridEdges(side, 42);
+    buildNodeIndex(network);
+    initNextHops(network);
+    double fullSeconds = timeSeconds([&] { blockedFloyd(network, threads); });
+    cout << "路网节点数: " << network.nodeCount << ", 分块Floyd全量计算: " << fullSeconds << " 秒" << endl;
+
+    // 依次封路、变长、变短、重新开通，交替进行
+    std::mt19937 rng(7);
+    vector<Edge> closed;
+    double incrementalSeconds = 0.0;
+    for (int k = 0; k < updates; ++k) {
+        Edge edge = network.edges[rng() % network.edges.size()];
+        double seconds = 0.0;
+        switch (k % 4) {
+        case 0:
+            seconds = timeSeconds([&] { removeRoadEdge(network, edge.node1, edge.node2, threads); });
+            closed.push_back(edge);
+            break;
+        case 1:
+            seconds = timeSeconds([&] { updateRoadEdge(network, edge.node1, edge.node2, edge.length * 2.0, threads); });
+            break;
+        case 2:
+            seconds = timeSeconds([&] { updateRoadEdge(network, edge.node1, edge.node2, edge.length * 0.5, threads); });
+            break;
+        default:
+            edge = closed.back();
+            closed.pop_back();
+            seconds = timeSeconds([&] { updateRoadEdge(network, edge.node1, edge.node2, edge.length, threads); });
+            break;
+        }
+        incrementalSeconds += seconds;
+    }
+    cout << updates << " 次路段更新，增量修复平均: " << incrementalSeconds / updates * 1000.0
+         << " 毫秒/次, 相对全量重算加速比: " << fullSeconds / (incrementalSeconds / updates) << endl;
+
+    // 与按最终路网重新计算的结果比较
+    RouteNetwork reference;
+    reference.edges = network.edges;
+    buildNodeIndex(reference);
+    blockedFloyd(reference, threads);
+    double diff = 0.0;
+    for (int a = 0; a < network.nodeCount; ++a) {
+        for (int b = 0; b < network.nodeCount; ++b) {
+            int i = reference.indexOf(network.nodeIds[a]);
+            int j = reference.indexOf(network.nodeIds[b]);
+            double expected = (i < 0 || j < 0) ? (a == b ? 0.0 : INFINITY) : reference.distanceAt(i, j);
+            double actual = network.distanceAt(a, b);
+            if (std::isinf(expected) != std::isinf(actual)) {
+                diff = INFINITY;
+            } else if (!std::isinf(expected)) {
+                diff = std::max(diff, std::abs(expected - actual));
+            }
+        }
+    }
+    cout << "与全量重算结果最大差异: " << diff
+         << ", 下一跳展开路径长度最大误差: " << maxRoadPathError(network) << endl;
+    return 0;
+}
@@ -10,6 +10,13 @@
 #include <ctime>  // 添加时间相关头文件
 #include <unistd.h>
 #include <unordered_set>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <array>
+#include <functional>
+#include "output.h"
+#include "solution_format.h"
 
 // 前向声明
 struct TaskPoint;
@@ -18,6 +25,12 @@ struct DistributionCenter;
 struct Edge;
 struct RouteNetwork;
 struct DeliveryProblem;
+struct ContractionHierarchy;
+struct NeighborLists;
+class MappedFile;
+class LazyDistanceRows;
+class TimeDependentRoutes;
+class TrafficFeed;
 
 // 地球半径（单位：公里）
 constexpr double EARTH_RADIUS = 6371.0;
@@ -68,14 +81,277 @@ struct Edge
     double length;              // 边长度
 };
 
+// 压缩稀疏行（CSR）格式的路网邻接表（双向、已去除重边）
+struct CsrGraph
+{
+    int nodeCount = 0;                  // 节点数量
+    std::vector<int> nodeIds;           // 索引 -> 节点ID
+    std::vector<int> nodeIndex;         // 节点ID -> 索引（-1表示不在路网中）
+    std::vector<int> offsets;           // 节点i的邻接边为 [offsets[i], offsets[i+1])
+    std::vector<int> targets;           // 邻接节点索引
+    std::vector<double> weights;        // 对应边长度
+
+    int indexOf(int nodeId) const {
+        return (nodeId >= 0 && nodeId < (int)nodeIndex.size()) ? nodeIndex[nodeId] : -1;
+    }
+};
+
+// 距离矩阵的存储格式
+enum class MatrixStorage
+{
+    Double,     // 完整的 nodeCount x nodeCount double 矩阵（默认）
+    Float,      // 上三角，32位浮点
+    Fixed16,    // 上三角，16位定点
+    Fixed32,    // 上三角，32位定点
+};
+
+// 对称距离矩阵的紧凑存储：只保存上三角（不含对角线），值量化为float或定点整数
+// 定点格式按最大有限距离选取缩放系数，编码最大值表示不可达
+struct CompactDistanceMatrix
+{
+    MatrixStorage storage = MatrixStorage::Double;  // Double表示未启用
+    std::vector<int64_t> rowBase;                   // 行i的元素(i,j)（j>i）位于 rowBase[i] + j
+    std::vector<float> floatValues;
+    std::vector<uint16_t> fixed16Values;
+    std::vector<uint32_t> fixed32Values;
+    double inverseScale = 0.0;                      // 定点编码 -> 距离
+    double maxError = 0.0;                          // 量化误差上限（与边长度同单位）
+
+    double at(int i, int j) const {
+        if (i == j) return 0.0;
+        if (i > j) std::swap(i, j);
+        size_t k = rowBase[i] + j;
+        switch (storage) {
+        case MatrixStorage::Float:
+            return floatValues[k];
+        case MatrixStorage::Fixed16: {
+            uint16_t code = fixed16Values[k];
+            return code == UINT16_MAX ? std::numeric_limits<double>::infinity() : code * inverseScale;
+        }
+        default: {
+            uint32_t code = fixed32Values[k];
+            return code == UINT32_MAX ? std::numeric_limits<double>::infinity() : code * inverseScale;
+        }
+        }
+    }
+};
+
+// 最短路下一跳矩阵：next(i, j) 为从矩阵节点i前往j的最短路上紧接i的节点（矩阵索引），不可达为-1
+// 节点数小于65535时按16位存储（最大值表示不可达），否则按32位存储
+struct NextHopMatrix
+{
+    int nodeCount = 0;                  // 0表示未记录
+    std::vector<uint16_t> hops16;
+    std::vector<int32_t> hops32;
+
+    bool empty() const { return nodeCount == 0; }
+    int next(int i, int j) const {
+        size_t k = (size_t)i * nodeCount + j;
+        if (!hops16.empty()) return hops16[k] == UINT16_MAX ? -1 : hops16[k];
+        return hops32[k];
+    }
+};
+
+// 去掉协同点(30000)、配送中心(20000)、额外需求点(10000)的ID偏移量，得到对应的路网节点ID
+inline int toRoadNodeId(int id)
+{
+    if (id > 30000) id -= 30000;
+    if (id > 20000) id -= 20000;
+    if (id > 10000) id -= 10000;
+    return id;
+}
+
+// 一天中的时段（车辆速度系数按时段区分）
+enum TimeBand
+{
+    OffPeak = 0,    // 非高峰期（速度系数1.0）
+    MorningPeak,    // 早高峰
+    EveningPeak,    // 晚高峰
+    TimeBandCount
+};
+
+// 路段高峰期速度系数，morning < 0 表示文件中没有该路段（使用默认系数）
+struct PeakFactor
+{
+    double morning = -1.0;
+    double evening = -1.0;
+
+    bool valid() const { return morning >= 0.0; }
+};
+
+// 系数文件中的一行：两端节点ID及其高峰期系数
+struct EdgePeakFactor
+{
+    int node1;
+    int node2;
+    PeakFactor factor;
+};
+
+// 按时段的单位速度行驶时间（距离/速度系数），车辆行驶时间 = 单位时间 / 车速
+struct BandTravelTimes
+{
+    double unit[TimeBandCount];
+};
+
+// 高峰时间窗 [start, end)（小时），band 指定该时间窗使用路段的早高峰还是晚高峰系数
+struct PeakWindow
+{
+    double start;
+    double end;
+    TimeBand band;
+};
+
+// 按高峰时间窗把一天划分成若干段（buildTravelTimeProfile建立）
+// 段内车速不变，因此路段的到达时间是出发时间的分段线性函数（先出发先到达），断点就是各段边界
+struct TravelTimeProfile
+{
+    std::vector<double> breakpoints;                            // 0 = t0 < t1 < ... < tk = 24
+    std::vector<TimeBand> bands;                                // 第i段 [t_i, t_{i+1}) 所属时段
+    std::vector<std::array<double, TimeBandCount>> elapsed;     // [0, t_i) 内各时段的累计小时数，共k+1项
+    std::array<uint16_t, 24> hourSegment{};                     // 每个整点所在的段
+};
+
+// 稠密高峰期系数表
+// 只有任务点和配送中心所在的路网节点会被查询，为它们分配连续槽位，按无序节点对的上三角存储
+// 加载路网后再按槽位对预计算各时段的单位行驶时间，查询时一次读取
+// 每一版是一份完整的交通快照，发布后只读；实时交通数据更新时整体替换为新版本（见 traffic_feed.h）
+struct PeakFactorTable
+{
+    uint64_t version = 0;                   // 快照版本号，每次发布加一
+    int slotCount = 0;
+    std::vector<int> slotOf;                // 路网节点ID -> 槽位（-1表示不是任务点/配送中心节点）
+    std::vector<int> slotNodes;             // 槽位 -> 路网节点ID
+    std::vector<PeakFactor> factors;        // slotCount*(slotCount+1)/2 个节点对
+    std::vector<BandTravelTimes> bandTimes; // 与factors同下标，为空表示未预计算
+    uint64_t bandDistanceVersion = 0;       // 建立 bandTimes 时的 network.distanceVersion，不一致时表已过期、不再读取
+    std::shared_ptr<TimeDependentRoutes> timeDependent;  // 按本版系数的时变最短路（--time-dependent时建立）
+    std::shared_ptr<const std::vector<EdgePeakFactor>> lines;  // 建立本版的系数行，增量加入新槽位时据此补齐系数
+
+    // 路网节点ID -> 槽位
+    int slotOfNode(int nodeId) const {
+        return (nodeId >= 0 && nodeId < (int)slotOf.size()) ? slotOf[nodeId] : -1;
+    }
+
+    // 对外ID -> 槽位；协同点（ID > 30000）不在系数文件的ID范围内，返回-1
+    int slotOfPoint(int pointId) const {
+        return pointId > 30000 ? -1 : slotOfNode(toRoadNodeId(pointId));
+    }
+
+    static size_t pairIndex(int a, int b) {
+        if (a > b) std::swap(a, b);
+        return (size_t)b * (b + 1) / 2 + a;
+    }
+
+    // 按对外ID查找路段系数，没有记录返回nullptr
+    const PeakFactor* find(int fromId, int toId) const {
+        int a = slotOfPoint(fromId), b = slotOfPoint(toId);
+        if (a < 0 || b < 0) return nullptr;
+        const PeakFactor& factor = factors[pairIndex(a, b)];
+        return factor.valid() ? &factor : nullptr;
+    }
+};
+
 // 路网信息
 struct RouteNetwork
 {
-    std::unordered_map<int, std::unordered_map<int, double>> distances; // 存储节点间最短距离
     std::vector<Edge> edges;                                            // 存储边信息
+
+    CsrGraph graph;                                                     // CSR邻接表（Dijkstra/CH方式构建，二进制实例中直接读入）
+    std::shared_ptr<const ContractionHierarchy> hierarchy;              // 收缩层次（CH方式下替代距离矩阵，按需查询）
+    std::shared_ptr<LazyDistanceRows> lazyRows;                         // 按需计算的LRU距离行（lazy方式下替代距离矩阵）
+
+    // 稠密距离矩阵（按节点索引行主序存储，在loadProblemData中建立一次）
+    // Floyd方式下包含全部路网节点；Dijkstra方式下只包含任务点和配送中心所在节点
+    int nodeCount = 0;                                                  // 矩阵节点数量
+    std::vector<int> nodeIds;                                           // 索引 -> 节点ID
+    std::vector<int> nodeIndex;                                         // 节点ID -> 索引（-1表示不在路网中）
+    std::vector<double> distMatrix;                                     // nodeCount x nodeCount 最短距离
+    std::shared_ptr<const MappedFile> matrixFile;                       // 距离缓存文件的只读映射
+    const double* mappedMatrix = nullptr;                               // 非空时距离矩阵直接读取映射内存
+    CompactDistanceMatrix compact;                                      // 启用紧凑存储时替代上面的稠密矩阵
+    NextHopMatrix nextHop;                                              // 下一跳矩阵（--road-paths时由Floyd记录）
+    double euclideanLowerBound = 0.0;                                   // 任务点/配送中心之间 路网距离 >= 该系数×直线距离，0表示未标定（见 spatial_index.h）
+    uint64_t distanceVersion = 0;                                       // 路段更新（updateRoadEdge）后递增，按路网距离预先计算的结果据此判断是否过期
+
+    // 节点ID转换为矩阵索引，不在路网中返回-1
+    int indexOf(int nodeId) const {
+        return (nodeId >= 0 && nodeId < (int)nodeIndex.size()) ? nodeIndex[nodeId] : -1;
+    }
+
+    // 按索引读取最短距离，一次数组访问
+    double distanceAt(int i, int j) const {
+        if (compact.storage != MatrixStorage::Double) return compact.at(i, j);
+        const double* data = mappedMatrix ? mappedMatrix : distMatrix.data();
+        return data[(size_t)i * nodeCount + j];
+    }
+
+#ifdef DEBUG_DISTANCE_MAP
+    std::unordered_map<int, std::unordered_map<int, double>> distances; // 调试视图：节点ID -> 节点ID -> 最短距离
+#endif
     
-    // 存储路段的高峰期系数信息
-    std::unordered_map<int, std::unordered_map<int, std::pair<double, double>>> peakFactors; // 存储节点间高峰期系数 (morningFactor, eveningFactor)
+    // 当前生效的交通快照：路段高峰期系数、各时段预计算的单位行驶时间及时变最短路
+    // 只在两次优化之间由求解线程替换，正在进行的计算持有的旧版本在引用释放后才回收
+    std::shared_ptr<const PeakFactorTable> peakFactors;
+};
+
+// 所有点对最短路算法
+enum class ApspMethod
+{
+    Floyd,      // 朴素Floyd（默认）
+    Blocked,    // 分块多线程Floyd
+    Dijkstra,   // CSR邻接表上以任务点和配送中心为源点的多源Dijkstra
+    Hierarchy,  // 收缩层次预处理，查询时按需计算
+    Lazy,       // 不预计算，按源点惰性运行Dijkstra并LRU缓存距离行
+};
+
+// 命令行可配置的运行参数
+struct SolverConfig
+{
+    ApspMethod apspMethod = ApspMethod::Floyd;  // 最短路算法（--apsp=floyd|blocked|dijkstra|ch|lazy）
+    int threadCount = 1;                        // 并行线程数（--threads=N）
+    size_t rowCacheBytes = 256u << 20;          // lazy方式距离行缓存及时变行驶时间缓存的内存上限（--row-cache-mb=N）
+    MatrixStorage matrixStorage = MatrixStorage::Double;  // 距离矩阵存储格式（--matrix-storage=double|float|fixed16|fixed32）
+    bool recordRoadPaths = false;               // 记录下一跳矩阵并输出车辆的路网节点序列（--road-paths）
+    bool hilbertOrder = false;                  // 按Hilbert曲线重排任务和距离矩阵节点以改善访存局部性（--hilbert）
+    bool timeDependent = false;                 // 高峰期车辆按路段系数走时变最短路（--time-dependent）
+    int timeBucketMinutes = 15;                 // 时变行驶时间缓存的出发时间桶宽度（--td-bucket-min=N）
+    std::string solutionFile;                   // 最终方案的二进制输出文件（--solution-out=path）
+    std::string routeStream;                    // 逐车输出最终路径的NDJSON目标，可为FIFO（--route-stream=path）
+    bool planDiff = false;                      // 输出静态到动态阶段的路线变化（--plan-diff）
+    std::string planDiffFile;                   // 路线变化的二进制输出文件（--plan-diff-out=path）
+    std::vector<std::string> deltaFiles;        // 加载后依次就地应用的增量文件（--delta=path，可重复）
+    int spatialIndexMinTasks = 64;              // 路线任务数达到该值时用网格索引选最近点（--spatial-index-min=N，0表示不使用）
+    int neighborCount = 16;                     // 每个任务点/配送中心预先计算的近邻任务数（--neighbors=K，0表示不使用近邻表）
+    std::string trafficFeed;                    // 实时交通系数来源（--traffic-feed=path 监视文件，- 为标准输入）
+    Verbosity verbosity = Verbosity::Normal;    // 输出详细程度（--quiet 只输出最终汇总，--verbose 不限速输出进度）
+    std::string hierarchyFile;                  // 收缩层次序列化文件（--ch-file=path，存在且匹配则直接加载）
+    std::string distanceCacheDir;               // 距离矩阵缓存目录（--distance-cache=dir，按路网哈希命名）
+    std::vector<PeakWindow> peakWindows = {     // 高峰时间窗（--peak-windows=7-9,17-19）
+        {7.0, 9.0, MorningPeak},
+        {17.0, 19.0, EveningPeak},
+    };
+};
+
+// 点位类型
+enum class NodeKind : uint8_t
+{
+    Task,       // problem.tasks 中的任务点
+    Center,     // problem.centers 中的配送中心
+};
+
+// 稠密点位句柄：加载后由对外ID解析一次，热点循环中直接按下标访问，不再做ID偏移运算和哈希查找
+// 协同点（任务ID+30000）与对应任务点位置相同，只用 collaboration 标记还原对外ID
+struct NodeHandle
+{
+    NodeKind kind = NodeKind::Task;
+    bool collaboration = false;
+    int index = -1;             // tasks 或 centers 下标，-1表示无效
+
+    bool valid() const { return index >= 0; }
+    bool operator==(const NodeHandle& other) const {
+        return kind == other.kind && collaboration == other.collaboration && index == other.index;
+    }
+    bool operator!=(const NodeHandle& other) const { return !(*this == other); }
 };
 
 // 配送问题信息
@@ -102,16 +378,15 @@ struct DeliveryProblem
     static constexpr double DEFAULT_MORNING_PEAK_FACTOR = 0.3;  // 默认早高峰速度系数（7:00-9:00）
     static constexpr double DEFAULT_EVENING_PEAK_FACTOR = 0.3;  // 默认晚高峰速度系数（17:00-18:00）
     
-    // 时间段定义
-    static constexpr double MORNING_PEAK_START = 7.0;      // 早高峰开始时间
-    static constexpr double MORNING_PEAK_END = 9.0;        // 早高峰结束时间
-    static constexpr double EVENING_PEAK_START = 17.0;     // 晚高峰开始时间
-    static constexpr double EVENING_PEAK_END = 19.0;       // 晚高峰结束时间
-
     std::vector<TaskPoint> tasks;                       // 所有任务点
     std::vector<Vehicle> vehicles;                      // 所有车辆（包括无人机）
     std::vector<DistributionCenter> centers;            // 所有配送中心
+    int vehicleCenterCount = 0;                         // centers中前vehicleCenterCount个为车辆配送中心，其后为无人机配送中心
     RouteNetwork network;                               // 路网
+    SolverConfig config;                                // 运行参数
+    TravelTimeProfile travelProfile;                    // 由config.peakWindows建立的一天分段时刻表
+    std::shared_ptr<TrafficFeed> trafficFeed;           // 实时交通数据的发布点（--traffic-feed时建立）
+    std::shared_ptr<const NeighborLists> neighbors;     // 各点位的K近邻任务表（见 neighbor_lists.h），任务增删后重建
     double timeWeight;                                  // 时间权重
     int initialDemandCount;                            // 初始需求点数量
     int extraDemandCount;                              // 额外需求点数量
@@ -132,12 +407,70 @@ struct DeliveryProblem
     std::unordered_set<int> centerIds;
     std::vector<int> allCarIds;
     std::vector<int> allDroneIds;
+
+    // 点位句柄对应的距离矩阵索引（buildNodeHandles建立，-1表示不在矩阵中）
+    std::vector<int> taskMatrixIndex;
+    std::vector<int> centerMatrixIndex;
+    // 点位句柄对应的高峰期系数表槽位（-1表示没有槽位）
+    std::vector<int> taskFactorSlot;
+    std::vector<int> centerFactorSlot;
 };
 
 // 工具函数声明
-bool loadProblemData(const std::string &filename, DeliveryProblem &problem);
+// 加载文本或二进制实例；savedFactorLines非空时同时返回文件中的高峰期系数行（delivery_convert写入二进制实例用）
+bool loadProblemData(const std::string &filename, DeliveryProblem &problem,
+                     std::vector<EdgePeakFactor>* savedFactorLines = nullptr);
+void finishProblemLoad(DeliveryProblem &problem, const std::vector<EdgePeakFactor> &factorLines);
 double getDistance(int id1, int id2, const DeliveryProblem& problem, bool isDrone);
+
+// 点位句柄：对外ID只在输入输出边界与句柄互相转换
+void buildNodeHandles(DeliveryProblem &problem);
+NodeHandle resolveNodeHandle(const DeliveryProblem& problem, int pointId);
+std::vector<NodeHandle> resolveNodeHandles(const DeliveryProblem& problem, const std::vector<int>& pointIds);
+int nodeHandleId(const DeliveryProblem& problem, NodeHandle handle);
+
+// 按句柄计算距离，结果与 getDistance 对同一对ID完全一致
+// 距离矩阵方式下直接按下标读取；收缩层次/lazy方式退回按ID查询
+inline double handleDistance(const DeliveryProblem& problem, NodeHandle a, NodeHandle b, bool isDrone)
+{
+    if (a == b) return 0.0;
+    bool aTask = a.kind == NodeKind::Task, bTask = b.kind == NodeKind::Task;
+    if (isDrone) {
+        double x1 = aTask ? problem.tasks[a.index].x : problem.centers[a.index].x;
+        double y1 = aTask ? problem.tasks[a.index].y : problem.centers[a.index].y;
+        double x2 = bTask ? problem.tasks[b.index].x : problem.centers[b.index].x;
+        double y2 = bTask ? problem.tasks[b.index].y : problem.centers[b.index].y;
+        return sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+    }
+    if (problem.network.hierarchy || problem.network.lazyRows) {
+        return getDistance(nodeHandleId(problem, a), nodeHandleId(problem, b), problem, false);
+    }
+    int i = aTask ? problem.taskMatrixIndex[a.index] : problem.centerMatrixIndex[a.index];
+    int j = bTask ? problem.taskMatrixIndex[b.index] : problem.centerMatrixIndex[b.index];
+    if (i < 0 || j < 0) return std::numeric_limits<double>::infinity();
+    return problem.network.distanceAt(i, j);
+}
+
+// 句柄所指点位的坐标（公里）
+inline void handlePosition(const DeliveryProblem& problem, NodeHandle handle, double &x, double &y)
+{
+    bool task = handle.kind == NodeKind::Task;
+    x = task ? problem.tasks[handle.index].x : problem.centers[handle.index].x;
+    y = task ? problem.tasks[handle.index].y : problem.centers[handle.index].y;
+}
+void buildNodeIndex(RouteNetwork &network);
+void initPeakFactorSlots(DeliveryProblem &problem);
+void buildBandTravelTimes(PeakFactorTable &table, const RouteNetwork &network);
+// 各槽位对（pairIndex下标）的最短距离，没有稠密double矩阵时返回空
+std::vector<double> slotPairDistances(const std::vector<int> &slotNodes, const RouteNetwork &network);
+// 由预先取得的槽位对距离建立时段行驶时间表；距离为空或不足（槽位在取得距离之后新增）时不建立
+void buildBandTravelTimes(PeakFactorTable &table, const std::vector<double> &pairDistances, uint64_t distanceVersion);
+void appendBandTravelTimes(PeakFactorTable &table, const RouteNetwork &network, int slot);
+void initNextHops(RouteNetwork &network);
 void floyd(RouteNetwork &network);
+#ifdef DEBUG_DISTANCE_MAP
+void buildDistanceMapView(RouteNetwork &network);
+#endif
 
 // 判断配送中心类型的辅助函数
 inline bool isDroneCenter(const DistributionCenter& center) {
@@ -148,11 +481,84 @@ inline bool isCarCenter(const DistributionCenter& center) {
     return center.carCount > 0;
 }
 
-// 输出配送结果
-void Print_DeliveryResults(
+// 一个阶段的配送方案：文本输出和二进制方案文件（solution_format.h）都是它的视图
+struct PlanStop
+{
+    int id;                     // 对外ID（配送中心/任务/协同点）
+    StopKind kind;
+    double arrival;             // 到达/完成时间（小时），没有时间时为NaN
+};
+
+struct VehiclePlan
+{
+    int vehicleId;
+    int centerId;               // 所属配送中心ID
+    bool drone;
+    std::vector<PlanStop> stops;
+};
+
+struct DeliveryPlan
+{
+    std::vector<VehiclePlan> vehicles;  // 只含有任务的车辆，顺序与文本输出一致
+    int taskCount = 0;                  // 路径上的任务点停靠数
+    double makespan = 0.0;              // 所有任务的最晚完成时间（小时）
+    double cost = 0.0;                  // 总成本
+};
+
+// 一辆车在两个方案间的路线变化：沿用原路线的前keptStops个停靠点，其后的removedStops个替换为suffix
+struct RouteChange
+{
+    int vehicleId;
+    int centerId;
+    bool drone;
+    int keptStops;
+    int removedStops;
+    std::vector<PlanStop> suffix;   // 替换后的路线后缀（路线被取消时为空）
+};
+
+// 两个方案的差异：只含路线有变化的车辆，按新方案的车辆顺序，被取消路线的车辆排在最后
+struct PlanDiff
+{
+    std::vector<RouteChange> changes;
+    int unchangedCount = 0;         // 路线完全相同的车辆数
+};
+
+// 由一辆车的路径和完成时间建立其方案（只有一个时间的路径不记录时间）
+VehiclePlan buildVehiclePlan(const DeliveryProblem& problem, int vehicleId,
+                             const std::vector<int>& path, const std::vector<double>& completionTimes);
+
+// 单条路径确定后的回调：求解器每定下一辆车的最终路径就调用一次，不等其余车辆（--route-stream 用它逐车输出）
+using RouteSink = std::function<void(int vehicleId, const std::vector<int>& path,
+                                     const std::vector<double>& completionTimes)>;
+
+// 由各车辆的路径和完成时间建立配送方案
+DeliveryPlan buildDeliveryPlan(
     const DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& allPaths);
 
+// 以文本输出配送方案；末尾的任务数、最晚完成时间和总成本按totalsLevel级别输出（最终结果在Quiet模式下也输出）
+void printDeliveryPlan(const DeliveryProblem& problem, const DeliveryPlan& plan,
+                       Verbosity totalsLevel = Verbosity::Normal);
+
+// 写出二进制方案文件（先写临时文件再原子重命名）
+bool saveSolutionFile(const std::string &path, const DeliveryPlan &plan);
+
+// 比较两个方案的路线：按停靠点ID和类型逐车求公共前缀，每辆车线性时间。
+// 路线相同只是到达时间变化的车辆不算变化；有变化的车辆的后缀带新的到达时间
+PlanDiff diffDeliveryPlans(const DeliveryPlan &before, const DeliveryPlan &after);
+
+// 以文本输出方案差异（Normal级别）
+void printPlanDiff(const PlanDiff &diff);
+
+// 写出二进制方案差异文件（格式见 solution_format.h）
+bool savePlanDiffFile(const std::string &path, const PlanDiff &diff);
+
+// 输出配送结果（建立方案后按文本输出）
+void Print_DeliveryResults(
+    const DeliveryProblem& problem,
+    const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& allPaths,
+    Verbosity totalsLevel = Verbosity::Normal);
+
 // 输出动态阶段配送结果 - 更新参数类型
 void printDynamicResults(
     const DeliveryProblem& problem, 
@@ -0,0 +1,51 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "common.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 收缩层次（Contraction Hierarchy）距离索引
+// 预处理按重要性依次收缩节点并添加捷径边，查询时只需在"向上"的边上做双向Dijkstra
+struct ContractionHierarchy
+{
+    int nodeCount = 0;                  // 节点数量
+    std::vector<int> nodeIds;           // 索引 -> 节点ID
+    std::vector<int> nodeIndex;         // 节点ID -> 索引（-1表示不在路网中）
+    std::vector<int> rank;              // 节点收缩顺序（越大越重要）
+    std::vector<int> upOffsets;         // 节点i的向上边为 [upOffsets[i], upOffsets[i+1])
+    std::vector<int> upTargets;         // 向上边终点（rank更大的节点）
+    std::vector<double> upWeights;      // 向上边长度（含捷径边）
+    uint64_t edgeHash = 0;              // 构建所用边列表的哈希，用于校验序列化文件
+
+    // 终端节点（任务点/配送中心）之间查询结果的惰性缓存：首次查询时计算，之后直接读取
+    std::vector<int> terminalSlot;                      // 节点索引 -> 终端序号（-1表示非终端）
+    int terminalCount = 0;
+    std::unique_ptr<std::atomic<double>[]> terminalMemo; // terminalCount x terminalCount，负数表示未计算
+
+    int indexOf(int nodeId) const {
+        return (nodeId >= 0 && nodeId < (int)nodeIndex.size()) ? nodeIndex[nodeId] : -1;
+    }
+};
+
+// 在CSR路网上构建收缩层次；每轮选出互不相邻的一批节点，并行进行见证搜索后统一收缩
+ContractionHierarchy buildContractionHierarchy(const CsrGraph &graph, int threadCount);
+
+// 双向CH查询两个路网节点（节点ID）之间的最短距离，不可达或不在路网中返回无穷大
+// 查询使用线程局部的临时数组，可在多个线程中并发调用
+double queryContractionHierarchy(const ContractionHierarchy &ch, int sourceNodeId, int targetNodeId);
+
+// 为终端节点建立查询结果缓存
+void attachTerminalMemo(ContractionHierarchy &ch, const std::vector<int> &terminalNodeIds);
+
+// 带终端缓存的距离查询：两端都是终端节点时优先读缓存，否则直接做CH查询
+double hierarchyDistance(const ContractionHierarchy &ch, int sourceNodeId, int targetNodeId);
+
+// 二进制序列化，文件中记录边列表哈希，加载时哈希不一致则视为失效；头部长度、节点ID和边区间/终点越界的损坏文件同样视为失效
+bool saveContractionHierarchy(const ContractionHierarchy &ch, const std::string &path);
+bool loadContractionHierarchy(const std::string &path, uint64_t expectedEdgeHash, ContractionHierarchy &ch);
+
+#endif // CONTRACTION_HIERARCHY_H
@@ -0,0 +1,24 @@
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+#include "common.h"
+#include <cstdint>
+#include <string>
+
+// 距离矩阵磁盘缓存
+// 文件布局：固定头部 + 矩阵节点ID数组 + 按64字节对齐的 nodeCount x nodeCount double 矩阵
+// 加载时以只读方式mmap，矩阵不做拷贝，并发运行的多个求解进程共享同一份页缓存
+
+// 缓存键：边列表哈希；Dijkstra方式下矩阵只含终端节点，键中还混入终端节点列表
+uint64_t distanceCacheKey(const DeliveryProblem &problem);
+
+// 缓存文件路径：<dir>/distances_<key十六进制>.bin
+std::string distanceCachePath(const std::string &dir, uint64_t key);
+
+// 映射缓存文件并设置 network 的矩阵节点和距离视图；文件不存在或不匹配时返回false
+bool loadDistanceCache(const std::string &path, uint64_t key, RouteNetwork &network);
+
+// 写入缓存文件（先写临时文件再原子重命名，避免并发进程读到不完整的文件）
+bool saveDistanceCache(const std::string &path, uint64_t key, const RouteNetwork &network);
+
+#endif // DISTANCE_CACHE_H
@@ -0,0 +1,47 @@
+#ifndef DISTANCE_ROWS_H
+#define DISTANCE_ROWS_H
+
+#include "common.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <vector>
+
+// 距离行缓存的统计信息
+struct DistanceRowStats
+{
+    uint64_t hits = 0;          // 命中已缓存的行
+    uint64_t misses = 0;        // 需要运行Dijkstra计算新行
+    uint64_t evictions = 0;     // 因超出内存上限被淘汰的行
+    size_t cachedRows = 0;      // 当前缓存的行数
+    size_t capacityRows = 0;    // 内存上限对应的最大行数
+};
+
+// 按需计算的距离行：某个源点第一次被查询时在CSR路网上运行单源Dijkstra得到整行距离，
+// 行按LRU策略缓存，总字节数不超过上限。路网为无向图，(u,v)与(v,u)共用任一端的行
+class LazyDistanceRows
+{
+public:
+    LazyDistanceRows(CsrGraph graph, size_t byteLimit);
+
+    // 两个路网节点（节点ID）之间的最短距离，不可达或不在路网中返回无穷大
+    double distance(int sourceNodeId, int targetNodeId);
+
+    // 路网变化后替换邻接表并清空全部已缓存的行（统计计数保留）
+    void reset(CsrGraph graph);
+
+    DistanceRowStats stats() const;
+    size_t rowBytes() const { return graph.nodeCount * sizeof(double); }
+
+private:
+    CsrGraph graph;
+    size_t byteLimit;
+    size_t capacityRows;
+    std::vector<std::vector<double>> rows;              // CSR索引 -> 距离行（未缓存时为空）
+    std::list<int> recentSources;                       // 已缓存的源点，表头为最近使用
+    std::vector<std::list<int>::iterator> position;     // 源点在 recentSources 中的位置
+    DistanceRowStats counters;
+    mutable std::mutex mutex;                           // 行计算也在锁内进行，多线程查询时串行化
+};
+
+#endif // DISTANCE_ROWS_H
@@ -0,0 +1,88 @@
+#ifndef DRONE_KERNEL_H
+#define DRONE_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 无人机最近邻构造的候选点扫描：每一步从当前位置到全部候选任务点的直线距离与电量/载重/出现时间约束一次算完。
+// 候选点按结构数组（SoA）排列，运行时按CPU选择AVX2（每次4个）、SSE2（每次2个）或标量实现；
+// 距离按 sqrt(dx*dx + dy*dy) 逐项计算、不使用FMA，与 handleDistance 的结果逐位一致
+
+// 一条路线的候选任务点，路线构造开始时建立一次
+struct DroneCandidates
+{
+    std::vector<double> x, y;           // 坐标（公里）
+    std::vector<double> returnTime;     // 从该点直飞回所属配送中心的耗电（小时），路线内不变
+    std::vector<double> sendWeight;
+    std::vector<double> pickWeight;
+    std::vector<double> readyTime;      // 最早可访问时刻：不受出现时间约束的为-inf，已访问的置为+inf
+
+    size_t size() const { return x.size(); }
+    void resize(size_t count)
+    {
+        for (auto* column : {&x, &y, &returnTime, &sendWeight, &pickWeight, &readyTime}) column->resize(count);
+    }
+};
+
+// 当前位置与状态
+struct DroneScanState
+{
+    double fromX, fromY;
+    double speed;
+    double battery;             // 当前剩余电量（小时）
+    double minBattery;          // 到达任务点后至少保留的电量
+    double time;                // 当前时刻（出现时间约束用）
+    double load;                // 当前载重
+    double maxProcessLoad;      // 本次行程的最大载重
+    double maxLoad;
+};
+
+enum DroneCandidateStatus : uint8_t
+{
+    CandidateInfeasible = 0,    // 违反载重、电量或出现时间约束（含已访问）
+    CandidateFeasible = 1,      // 可访问且之后能直飞回配送中心
+    CandidateNoReturn = 2,      // 可访问，但之后不能直飞回配送中心（协同规划再检查能否飞往车辆经过点）
+};
+
+// 单个候选点的距离与可行性（近邻表逐个检查候选点时使用，也是扫描的标量实现）。各约束与路径构造中的标量判断逐条对应：
+//   送货点 maxProcessLoad + sendWeight > maxLoad、取货点 load + pickWeight > maxLoad 不可访问；
+//   time + 去程耗电 + 0.000001 < readyTime 不可访问（额外需求点尚未出现）；
+//   去程耗电 > battery、battery - 去程耗电 < minBattery 不可访问；
+//   去程耗电 + returnTime <= battery 为能直飞回配送中心
+inline uint8_t droneCandidateStatus(const DroneCandidates &c, const DroneScanState &s, size_t i, double &distance)
+{
+    double dx = c.x[i] - s.fromX;
+    double dy = c.y[i] - s.fromY;
+    distance = std::sqrt(dx * dx + dy * dy);
+    double toTask = distance / s.speed;
+    // 用按位与而不是短路求值，避免难以预测的分支
+    int feasible = (!(c.sendWeight[i] > 0) | !(s.maxProcessLoad + c.sendWeight[i] > s.maxLoad))
+                 & (!(c.pickWeight[i] > 0) | !(s.load + c.pickWeight[i] > s.maxLoad))
+                 & !(s.time + toTask + 0.000001 < c.readyTime[i])
+                 & !(toTask > s.battery)
+                 & !(s.battery - toTask < s.minBattery);
+    int back = toTask + c.returnTime[i] <= s.battery;
+    return (uint8_t)(feasible * (2 - back));
+}
+
+enum class DroneKernel
+{
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+// 本机可用的最快实现（首次调用时检测CPU）
+DroneKernel activeDroneKernel();
+const char* droneKernelName(DroneKernel kernel);
+
+// 计算当前位置到每个候选点的距离 distance[i] 与可行性 status[i]
+void scanDroneCandidates(const DroneCandidates &candidates, const DroneScanState &state,
+                         double* distance, uint8_t* status);
+// 指定实现（基准测试对比用），本机不支持时退回标量实现
+void scanDroneCandidates(const DroneCandidates &candidates, const DroneScanState &state,
+                         double* distance, uint8_t* status, DroneKernel kernel);
+
+#endif // DRONE_KERNEL_H
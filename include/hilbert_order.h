@@ -0,0 +1,29 @@
+#ifndef HILBERT_ORDER_H
+#define HILBERT_ORDER_H
+
+#include "common.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hilbert曲线重排：空间上相近的任务点和路网节点在 problem.tasks 和距离矩阵中也相邻，
+// 最近邻扫描和按行读取距离时访问的缓存行更少。只改变内部存储顺序，对外ID不变
+
+// 2^order x 2^order 网格上的点 (x, y) 在Hilbert曲线上的序号
+uint64_t hilbertIndex(uint32_t x, uint32_t y, int order = 16);
+
+// 按包围盒把坐标归一化到 2^16 网格后计算Hilbert序号
+std::vector<uint64_t> hilbertKeys(const std::vector<std::pair<double, double>> &points);
+
+// 任务按Hilbert序稳定排序，初始任务和额外任务两段各自排序（需在建立 taskIdToIndex 之前调用）
+void sortTasksAlongHilbert(DeliveryProblem &problem);
+
+// 路网节点的Hilbert顺序，返回 order[新位置] = nodeIds中的原位置
+// 任务点/配送中心所在节点直接取其坐标；其余节点没有坐标，取路网上BFS最近的有坐标节点的序号
+std::vector<int> hilbertNodeOrder(const DeliveryProblem &problem, const std::vector<int> &nodeIds);
+
+// 按 order[新索引] = 原索引 重排距离矩阵的节点（nodeIds/nodeIndex/distMatrix）
+// 在buildNodeIndex之后、Floyd之前调用，只需重排初始矩阵
+void permuteMatrixNodes(RouteNetwork &network, const std::vector<int> &order);
+
+#endif // HILBERT_ORDER_H
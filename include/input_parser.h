@@ -0,0 +1,62 @@
+#ifndef INPUT_PARSER_H
+#define INPUT_PARSER_H
+
+#include "common.h"
+#include <charconv>
+#include <vector>
+
+// 在内存中的文本上按空白分隔读取数字（用 std::from_chars 就地转换，不分配内存）
+class TokenScanner
+{
+public:
+    TokenScanner(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+    // 跳过空白后读取一个数；格式不符或已到末尾时返回false
+    template <typename T>
+    bool read(T &value)
+    {
+        skipSpace();
+        const char* first = cursor;
+        if (first < end && *first == '+') first++;  // 与流读取一致，允许显式正号
+        auto result = std::from_chars(first, end, value);
+        if (result.ec != std::errc()) return false;
+        cursor = result.ptr;
+        return true;
+    }
+
+    template <typename... T>
+    bool readAll(T &... values) { return (read(values) && ...); }
+
+    // 跳过空白后是否已到末尾
+    bool atEnd()
+    {
+        skipSpace();
+        return cursor == end;
+    }
+
+    const char* position() const { return cursor; }
+    const char* limit() const { return end; }
+    void seek(const char* position) { cursor = position; }
+
+private:
+    void skipSpace()
+    {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t' ||
+                                *cursor == '\v' || *cursor == '\f')) {
+            cursor++;
+        }
+    }
+
+    const char* cursor;
+    const char* end;
+};
+
+// 从scanner当前位置读取count条边（长度由米转换为公里），成功后scanner移到边段之后；节点ID为负时视为格式错误
+// 多线程时先按行定位各块起点再并行解析；边不是一行一条时退回顺序读取
+bool parseEdgeSection(TokenScanner &scanner, int count, std::vector<Edge> &edges, int threadCount);
+
+// 读取[begin, end)内的 "节点1 节点2 早高峰系数 晚高峰系数" 记录，遇到格式错误处停止（与逐个读取相同）
+// 多线程时按字节分块、块边界对齐到行首并行解析，结果按文件顺序拼接
+std::vector<EdgePeakFactor> parseFactorSection(const char* begin, const char* end, int threadCount);
+
+#endif // INPUT_PARSER_H
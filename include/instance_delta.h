@@ -0,0 +1,54 @@
+#ifndef INSTANCE_DELTA_H
+#define INSTANCE_DELTA_H
+
+#include "common.h"
+#include <string>
+#include <vector>
+
+// 实例的增量变更：日内新增/取消任务、车辆调到其他配送中心时就地修改 DeliveryProblem，不重新加载整个实例。
+// 同步维护 tasks 与 taskIdToIndex、coordinates、centerToTasks（已分配过中心时）、任务点句柄的矩阵索引和系数槽位；
+// 新任务点所在节点不在只含终端节点的距离矩阵中时只补算该节点一行（addMatrixNode），
+// 没有系数槽位时追加一个槽位并只计算它与已有槽位的点对，其余距离和系数不重算；
+// 任务点增删使近邻表失效（置空），applyDelta 在全部变更应用后重建一次。
+// 应在两次优化之间由求解线程调用
+//
+// 增量文件每行一项，# 开头为注释，字段格式与输入文件对应的段相同：
+//   task  <ID> <经度> <纬度> <取货重量> <送货重量>               新增初始需求点
+//   extra <ID> <经度> <纬度> <取货重量> <送货重量> <出现时间(分钟)>  新增额外需求点（ID同输入文件，内部加10000）
+//   cancel <任务ID>                                              取消任务，ID与结果输出一致（额外需求点为10000+原ID）
+//   move <车辆ID> <配送中心ID>                                    车辆/无人机调到同类的另一配送中心，中心ID与结果输出一致（20000+原ID）
+
+enum class DeltaKind
+{
+    AddTask,
+    CancelTask,
+    MoveVehicle,
+};
+
+struct DeltaOp
+{
+    DeltaKind kind;
+    TaskPoint task = {};        // AddTask：新任务点（坐标已换算为公里，ID已加偏移）
+    bool extra = false;         // AddTask：是否为额外需求点
+    int id = -1;                // CancelTask：任务ID；MoveVehicle：车辆ID
+    int centerId = -1;          // MoveVehicle：目标配送中心ID
+};
+
+// 读取增量文件，格式错误时输出行号并返回false
+bool loadDeltaFile(const std::string &path, std::vector<DeltaOp> &ops);
+
+// 新增任务点：初始需求点插在初始需求点末尾，额外需求点追加在最后。ID重复、--road-paths 下节点不在路网中、
+// 或已分配过配送中心而新初始需求点没有可到达的中心时返回false（后者撤销已插入的任务点）
+bool addTask(DeliveryProblem &problem, const TaskPoint &task, bool extra);
+
+// 取消任务点，之后的任务点下标前移；距离矩阵和系数槽位保留（其他任务点可能位于同一节点）
+bool cancelTask(DeliveryProblem &problem, int taskId);
+
+// 车辆调到另一配送中心，两个中心的车辆列表和车辆/无人机数量随之更新；
+// 车辆只能调到车辆配送中心、无人机只能调到无人机配送中心，否则返回false
+bool moveVehicle(DeliveryProblem &problem, int vehicleId, int centerId);
+
+// 按顺序应用各项变更，某项失败时输出原因并停在该项（之前的变更已生效）
+bool applyDelta(DeliveryProblem &problem, const std::vector<DeltaOp> &ops);
+
+#endif // INSTANCE_DELTA_H
@@ -0,0 +1,29 @@
+#ifndef INSTANCE_FILE_H
+#define INSTANCE_FILE_H
+
+#include "common.h"
+#include "mapped_file.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 二进制实例文件（由 delivery_convert 从文本输入生成）
+// 文件布局：固定头部（问题参数 + 段表）+ 若干定长记录段，各段起始偏移按64字节对齐
+// 段依次为：任务点、配送中心、车辆/无人机、路网边、CSR邻接表、高峰期系数行，以及可选的预计算距离矩阵
+// 加载时整体mmap：各段按定长记录直接拷入 DeliveryProblem，不做文本解析和经纬度换算，CSR邻接表不再重建；
+// 距离矩阵不拷贝，直接作为 network 的只读映射视图（与距离缓存相同，多个进程共享页缓存）
+
+// 文件是否以二进制实例的魔数开头
+bool isInstanceFile(const MappedFile &file);
+
+// 由已映射的二进制实例建立问题数据；版本或段表不匹配、邻接表或矩阵节点ID不一致时返回false
+// 文件中有距离矩阵且当前方式使用稠密矩阵（floyd/blocked/dijkstra，未启用--hilbert/--road-paths）时直接使用，否则照常计算最短路
+bool loadInstanceFile(std::shared_ptr<const MappedFile> file, DeliveryProblem &problem,
+                      std::vector<EdgePeakFactor>* savedFactorLines = nullptr);
+
+// 写入二进制实例；includeMatrix为true且network持有稠密double距离矩阵时一并写入
+// 先写临时文件再原子重命名
+bool saveInstanceFile(const std::string &path, const DeliveryProblem &problem,
+                      const std::vector<EdgePeakFactor> &factorLines, bool includeMatrix);
+
+#endif // INSTANCE_FILE_H
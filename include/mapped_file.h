@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+
+// 只读内存映射文件（MAP_SHARED），多个进程映射同一文件时共享页缓存
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整个文件，失败（文件不存在、为空等）返回false
+    bool open(const std::string &path);
+    void close();
+
+    const char* data() const { return static_cast<const char*>(address); }
+    size_t size() const { return length; }
+    bool isOpen() const { return address != nullptr; }
+
+private:
+    void* address = nullptr;
+    size_t length = 0;
+};
+
+// 原子地写出文件：write 向临时文件写入全部内容，成功后 rename 到 path，读者（包括映射该文件的进程）只看到完整文件。
+// 临时文件名带进程号，多个进程同时写同一文件互不干扰；打开、写入或 rename 失败时删除临时文件并返回false
+bool writeFileAtomically(const std::string &path, const std::function<void(std::ofstream &)> &write);
+
+#endif // MAPPED_FILE_H
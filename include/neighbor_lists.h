@@ -0,0 +1,41 @@
+#ifndef NEIGHBOR_LISTS_H
+#define NEIGHBOR_LISTS_H
+
+#include "common.h"
+#include <memory>
+#include <vector>
+
+// 每个任务点和配送中心的K个最近任务点（候选近邻表），加载后预先计算一次。
+// 路径构造每一步先按当前位置的近邻表由近到远找可行的未访问任务点，找不到时才扫描整条路线；
+// 路网距离表供普通车辆使用（需要稠密距离矩阵），直线距离表供无人机使用。
+// 各表按 (点位, 名次) 行主序平铺：点位编号任务点在前（tasks下标），配送中心在后（任务点数+centers下标）
+struct NeighborLists
+{
+    int k = 0;                                  // 每行的近邻数
+    int taskCount = 0;                          // 建立时的任务点数
+    int pointCount = 0;                         // 任务点数 + 配送中心数
+    bool hasRoad = false;                       // 是否建立了路网距离表
+    uint64_t distanceVersion = 0;               // 建立时的 network.distanceVersion，路段更新后路网距离表不再使用
+    std::vector<int> roadTasks;                 // 按路网距离由近到远的任务下标，任务点不足k个时以-1补齐
+    std::vector<double> roadDistances;          // 与 roadTasks 同下标，值与 handleDistance 一致
+    std::vector<int> straightTasks;             // 按直线距离由近到远
+    std::vector<double> straightDistances;
+
+    // 路网距离表与当前距离矩阵一致、任务点未增删时可用
+    bool roadUsable(const DeliveryProblem &problem) const {
+        return hasRoad && distanceVersion == problem.network.distanceVersion && taskCount == (int)problem.tasks.size();
+    }
+    bool straightUsable(const DeliveryProblem &problem) const {
+        return taskCount == (int)problem.tasks.size();
+    }
+
+    int pointOf(NodeHandle handle) const {
+        return handle.kind == NodeKind::Task ? handle.index : taskCount + handle.index;
+    }
+};
+
+// 并行建立近邻表（problem.config.threadCount 个线程），不含点位自身；距离相同时按任务下标排列。
+// 路网距离表只在有稠密距离矩阵时建立（每个点位读取一行矩阵），收缩层次/lazy方式只建立直线距离表
+std::shared_ptr<const NeighborLists> buildNeighborLists(const DeliveryProblem &problem, int k);
+
+#endif // NEIGHBOR_LISTS_H
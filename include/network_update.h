@@ -0,0 +1,38 @@
+#ifndef NETWORK_UPDATE_H
+#define NETWORK_UPDATE_H
+
+#include "common.h"
+#include <limits>
+
+// 修改（或新增）两节点之间的路段长度，并增量修复最短路距离
+// 原有的重边全部替换为一条长度为length的边；length为无穷大表示封路（删除该路段）
+// 距离矩阵只重新计算经过该路段的行，多线程并行（记录了下一跳时同步修复）；lazy方式清空距离行缓存。
+// 交通快照只读，不就地修改：复制一份，按新距离重建各时段行驶时间表、在新邻接表上建立新的时变最短路后替换 network.peakFactors；
+// 直线距离下界系数置0（路段变短后可能不再成立），需要时调用 calibrateEuclideanLowerBound 重新标定；
+// distanceVersion 递增，此前建立的近邻表只再使用直线距离部分。长度不变时不做处理
+// 收缩层次方式不支持增量更新，端点不在路网中时返回false
+//
+// 目前只由基准测试（delivery_bench update）调用，求解程序和增量文件不会修改路段。每次调用都重建整个边列表和CSR邻接表（O(边数)）
+bool updateRoadEdge(RouteNetwork &network, int nodeId1, int nodeId2, double length, int threadCount = 1);
+
+// 同上，用于求解过程中的路段更新（--traffic-feed 下也可用）：有交通数据发布点时，新快照经发布点发布，
+// 后台更新线程建立快照所用的邻接表和槽位距离同时替换，refreshTraffic 不会换回旧路网上的快照。应由求解线程调用
+bool updateRoadEdge(DeliveryProblem &problem, int nodeId1, int nodeId2, double length, int threadCount = 1);
+
+// 向距离矩阵追加一个路网节点（只含任务点/配送中心节点的矩阵加入新任务点时使用），返回其矩阵索引
+// 只以该节点为源点运行一次Dijkstra（路网无向，该行即该列），其余点对不变；已在矩阵中时直接返回原索引
+// 节点不在路网中、或矩阵记录了下一跳（全路网矩阵已含全部节点）时返回-1；收缩层次/lazy方式没有矩阵，返回-1
+int addMatrixNode(RouteNetwork &network, int nodeId);
+
+// 删除两节点之间的路段（封路）
+inline bool removeRoadEdge(RouteNetwork &network, int nodeId1, int nodeId2, int threadCount = 1)
+{
+    return updateRoadEdge(network, nodeId1, nodeId2, std::numeric_limits<double>::infinity(), threadCount);
+}
+
+inline bool removeRoadEdge(DeliveryProblem &problem, int nodeId1, int nodeId2, int threadCount = 1)
+{
+    return updateRoadEdge(problem, nodeId1, nodeId2, std::numeric_limits<double>::infinity(), threadCount);
+}
+
+#endif // NETWORK_UPDATE_H
@@ -0,0 +1,43 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <chrono>
+#include <ostream>
+
+// 输出详细程度（--quiet / --verbose）
+enum class Verbosity
+{
+    Quiet,      // 只输出最终汇总：动态阶段的任务数、最晚完成时间、总成本和路径验证结果
+    Normal,     // 默认：加载信息、各阶段的分配与路径时间表，遗传算法进度每秒至多一行
+    Verbose,    // 遗传算法进度不限速
+};
+
+// 带缓冲的分级输出
+// initOutput 把 std::cout 接到一个大缓冲区上，只在缓冲区写满、显式 flushOutput（各阶段结束）和程序退出时写出，
+// 结果输出一律用 '\n' 换行，不用 std::endl 逐行刷新。
+// std::cout 即 Normal 级别的输出通道：Quiet 模式下 std::cout 被静音（格式化也被跳过），
+// 更高或更低级别的输出通过 output(level) 取得对应的流
+void initOutput(Verbosity level);
+Verbosity outputVerbosity();
+
+// 该级别的输出流；当前级别不输出时返回空流
+std::ostream& output(Verbosity level);
+
+// 立即写出缓冲区内容
+void flushOutput();
+
+// 热点循环中的进度行限速：Verbose 级别下总是允许，否则距上次允许不足 interval 秒时返回false
+// 每个进度来源持有一个实例；只在调用方已按计数筛选后调用，不在每次迭代中读时钟
+class ProgressThrottle
+{
+public:
+    explicit ProgressThrottle(double intervalSeconds = 1.0) : interval(intervalSeconds) {}
+    bool ready();
+
+private:
+    double interval;
+    bool started = false;
+    std::chrono::steady_clock::time_point last;
+};
+
+#endif // OUTPUT_H
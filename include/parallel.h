@@ -0,0 +1,46 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 并行执行 fn(i)，i ∈ [begin, end)，threadCount 个线程动态领取任务
+// threadCount <= 1 或任务数不足时直接在当前线程顺序执行
+template <typename Fn>
+void parallelFor(int begin, int end, int threadCount, Fn&& fn)
+{
+    int taskCount = end - begin;
+    if (taskCount <= 0) return;
+
+    int workerCount = std::min(threadCount, taskCount);
+    if (workerCount <= 1) {
+        for (int i = begin; i < end; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<int> next(begin);
+    auto worker = [&]() {
+        for (int i = next.fetch_add(1); i < end; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount - 1);
+    for (int t = 0; t < workerCount - 1; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();  // 当前线程也参与计算
+    for (auto& thread : threads) thread.join();
+}
+
+// 默认线程数：硬件并发数（获取失败时为1）
+inline int defaultThreadCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+#endif // PARALLEL_H
@@ -14,6 +14,24 @@ std::vector<int> optimizePathForVehicle(
 // 辅助函数：检查是否还有未访问的任务点
 bool anyTaskUnvisited(const std::vector<bool>& visited, const std::vector<int>& taskIds);
 
+// 固定一次路线计算使用的交通快照：存续期间本线程的 calculateTimeNeeded/getSpeedFactor 都读取构造时生效的那一版，
+// 一条路线（或一次适应度计算）的各段不会混用不同版本的系数。可以嵌套，内层沿用外层固定的版本
+class TrafficPin
+{
+public:
+    explicit TrafficPin(const DeliveryProblem &problem);
+    ~TrafficPin();
+    TrafficPin(const TrafficPin&) = delete;
+    TrafficPin& operator=(const TrafficPin&) = delete;
+
+private:
+    std::shared_ptr<const PeakFactorTable> snapshot;   // 最外层持有引用，保证快照在固定期间不被回收
+    bool outermost;
+};
+
+// 本线程固定的交通快照，没有固定时为当前生效的 problem.network.peakFactors
+const PeakFactorTable* activeTraffic(const DeliveryProblem &problem);
+
 // 根据时间和路段判断是否处于高峰期，返回速度系数
 double getSpeedFactor(double currentTime, int fromId, int toId, const DeliveryProblem& problem);
 
@@ -26,9 +44,11 @@ std::vector<double> calculateCompletionTimes(
     bool considerTraffic = false);
 
 // 优化动态阶段的所有路径 - 更新返回类型
+// onRouteFinal 非空时每辆车的路径一确定就回调：普通车辆在第一轮规划后即确定，无人机在各自协同规划后确定
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> optimizeDynamicPaths(
     const DeliveryProblem& problem,
-    const std::vector<std::pair<int, int>>& dynamicAssignments);
+    const std::vector<std::pair<int, int>>& dynamicAssignments,
+    const RouteSink& onRouteFinal = nullptr);
 
 // 动态阶段为车辆优化考虑时间约束的路径
 std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
@@ -55,4 +75,14 @@ double calculateTimeNeeded(
     bool considerTraffic = false,  // 是否考虑高峰期
     bool isDrone = false);  // 是否是无人机
 
+// 按点位句柄计算行驶时间（路径构造的热点循环使用）
+double calculateTimeNeeded(
+    NodeHandle current,
+    NodeHandle dest,
+    double currentTime,
+    const Vehicle& vehicle,
+    const DeliveryProblem& problem,
+    bool considerTraffic = false,
+    bool isDrone = false);
+
 #endif // PATH_OPTIMIZER_H
\ No newline at end of file
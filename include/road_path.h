@@ -0,0 +1,61 @@
+#ifndef ROAD_PATH_H
+#define ROAD_PATH_H
+
+#include "common.h"
+#include <cstddef>
+#include <iterator>
+
+// 车辆一段行程（两个路径点之间）经过的路网节点序列，含起点和终点
+// 沿下一跳矩阵逐个展开，不分配内存；未记录下一跳、端点不在路网中或不可达时为空
+// 用法：for (int nodeId : RoadLeg(problem.network, fromPointId, toPointId)) { ... }
+class RoadLeg
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        Iterator(const RouteNetwork* network, int current, int target)
+            : network(network), current(current), target(target) {}
+
+        int operator*() const { return network->nodeIds[current]; }
+        Iterator& operator++() {
+            current = current == target ? -1 : network->nextHop.next(current, target);
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return current == other.current; }
+        bool operator!=(const Iterator& other) const { return current != other.current; }
+
+    private:
+        const RouteNetwork* network;
+        int current;    // 当前节点的矩阵索引，-1表示结束
+        int target;
+    };
+
+    RoadLeg(const RouteNetwork& network, int fromPointId, int toPointId)
+        : network(&network)
+    {
+        if (network.nextHop.empty()) return;
+        int from = network.indexOf(toRoadNodeId(fromPointId));
+        int to = network.indexOf(toRoadNodeId(toPointId));
+        if (from < 0 || to < 0 || (from != to && network.nextHop.next(from, to) < 0)) return;
+        source = from;
+        target = to;
+    }
+
+    Iterator begin() const { return Iterator(network, source, target); }
+    Iterator end() const { return Iterator(network, -1, target); }
+    bool empty() const { return source < 0; }
+
+private:
+    const RouteNetwork* network;
+    int source = -1;
+    int target = -1;
+};
+
+#endif // ROAD_PATH_H
@@ -0,0 +1,47 @@
+#ifndef ROUTE_STREAM_H
+#define ROUTE_STREAM_H
+
+#include "common.h"
+#include <mutex>
+#include <string>
+
+// 逐车输出最终路径（--route-stream=path）：每辆车的路径一确定就写出一行JSON（NDJSON），
+// 调度端不必等最慢的车辆规划完，已确定路线的司机可以先出发。
+// path 可以是普通文件、命名管道（FIFO）或 /dev/stdout 等；打开FIFO会阻塞到读端打开为止。
+//
+// 每行一个对象，stage 为 "static" 或 "dynamic"：
+//   {"stage":"dynamic","vehicle":3,"drone":false,"center":20001,
+//    "stops":[{"id":20001,"kind":"center","arrival":0},{"id":17,"kind":"task","arrival":8.25},...]}
+// 一个阶段的所有路径写完后写出结束标记：
+//   {"stage":"dynamic","end":true,"vehicles":12,"tasks":190,"makespan":14.997,"cost":148.72}
+// arrival 没有时间时为 null。每行用一次 write 写出，不经过结果输出的缓冲区
+class RouteStream
+{
+public:
+    RouteStream() = default;
+    ~RouteStream();
+
+    RouteStream(const RouteStream&) = delete;
+    RouteStream& operator=(const RouteStream&) = delete;
+
+    // 打开输出目标（截断普通文件），失败返回false
+    bool open(const std::string &path);
+
+    // 写出一辆车的最终路径；可从多个线程调用
+    void emit(const char* stage, const VehiclePlan &vehicle);
+
+    // 写出阶段结束标记
+    void endStage(const char* stage, const DeliveryPlan &plan);
+
+    // 该阶段的路径回调：跳过无任务的路径，与文本输出和方案文件一致
+    RouteSink sink(const DeliveryProblem &problem, const char* stage);
+
+private:
+    void writeLine(const std::string &line);
+
+    int fd = -1;
+    bool broken = false;        // 读端已关闭或写出出错，之后的路径不再写出
+    std::mutex mutex;
+};
+
+#endif // ROUTE_STREAM_H
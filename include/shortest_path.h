@@ -0,0 +1,43 @@
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include "common.h"
+#include <cstdint>
+#include <vector>
+
+// 分块Floyd的默认块大小（64x64个double，正好放入L1/L2缓存）
+constexpr int APSP_BLOCK_SIZE = 64;
+
+// 分块（tiled）Floyd算法，按三阶段顺序处理各块，每阶段内相互独立的块多线程并行
+void blockedFloyd(RouteNetwork &network, int threadCount, int blockSize = APSP_BLOCK_SIZE);
+
+// 边列表的64位FNV-1a哈希，用于校验序列化的预处理结果是否对应同一路网
+uint64_t hashEdgeList(const std::vector<Edge> &edges);
+
+// 由边列表构建去除重边的CSR邻接表（重边保留最短长度）
+CsrGraph buildCsrGraph(const std::vector<Edge> &edges);
+
+// 单源Dijkstra，dist为按CSR索引的最短距离（不可达为无穷大）
+// targetSlot非空时，targetSlot[v] >= 0 的节点全部确定后提前结束
+// parent非空时记录最短路树：parent[v] 为源点到v的最短路上v的前一个节点（源点和不可达节点为-1）
+void dijkstra(const CsrGraph &graph, int source, std::vector<double> &dist,
+              const std::vector<int> *targetSlot = nullptr, int targetCount = 0,
+              std::vector<int> *parent = nullptr);
+
+// 收集所有任务点和配送中心对应的路网节点ID（去重，保持首次出现顺序；启用Hilbert重排时按曲线顺序）
+std::vector<int> collectTerminalNodes(const DeliveryProblem &problem);
+
+// 以每个终端节点为源点并行运行Dijkstra（每个线程一次处理一个源点），
+// 只把终端节点之间的距离写入 network 的稠密矩阵
+void terminalDijkstra(RouteNetwork &network, const std::vector<int> &terminalNodeIds, int threadCount);
+
+// 把稠密距离矩阵转换为只含上三角的紧凑量化存储，释放原矩阵（含内存映射）；不输出信息，增量补算矩阵行后也会调用
+void compactDistanceMatrix(RouteNetwork &network, MatrixStorage storage);
+
+// 输出紧凑存储的格式、占用内存与量化误差上限（未启用紧凑存储时不输出）
+void printCompactDistanceMatrix(const RouteNetwork &network);
+
+// 按 problem.config 选择的算法计算路网所有点对最短路径
+void computeShortestPaths(DeliveryProblem &problem);
+
+#endif // SHORTEST_PATH_H
@@ -0,0 +1,214 @@
+#ifndef SOLUTION_FORMAT_H
+#define SOLUTION_FORMAT_H
+
+// 二进制配送方案文件的格式定义与读取器（--solution-out=path 写出）
+// 本头文件只依赖标准库，下游调度系统可单独拷贝使用，不必链接求解器
+//
+// 文件布局（小端，定长记录）：
+//   SolutionHeader
+//   SolutionVehicle × vehicleCount      每辆有任务的车辆/无人机一条，stops 为其在停靠点数组中的区间
+//   SolutionStop × stopCount            所有车辆的停靠点依次排列
+// 停靠点ID与文本输出一致：配送中心为 20000+原ID，额外任务为 10000+原ID，协同点为 30000+任务ID
+//
+// 静态/动态阶段方案差异文件（--plan-diff-out=path 写出）只含路线有变化的车辆：
+//   PlanDiffHeader
+//   PlanDiffVehicle × changeCount       keptStops 为沿用的原路线前缀长度，之后的原停靠点由 stops 区间替换
+//   SolutionStop × stopCount            各车辆替换后的路线后缀依次排列
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+constexpr uint32_t SOLUTION_MAGIC = 0x50535256;    // "VRSP"
+constexpr uint32_t SOLUTION_VERSION = 1;
+constexpr uint32_t PLAN_DIFF_MAGIC = 0x44505256;   // "VRPD"
+constexpr uint32_t PLAN_DIFF_VERSION = 1;
+
+// 停靠点类型
+enum class StopKind : uint8_t
+{
+    Center = 0,         // 配送中心
+    Task = 1,           // 任务点
+    Collaboration = 2,  // 车机协同点
+};
+
+struct SolutionHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vehicleCount;
+    uint32_t stopCount;
+    uint32_t taskCount;         // 所有路径上的任务点停靠数
+    uint32_t reserved;
+    double makespan;            // 所有任务的最晚完成时间（小时）
+    double cost;                // 总成本（元）
+};
+
+struct SolutionVehicle
+{
+    int32_t vehicleId;
+    int32_t centerId;           // 所属配送中心ID
+    uint8_t drone;              // 1为无人机
+    uint8_t reserved[3];
+    uint32_t firstStop;         // 在停靠点数组中的起始下标
+    uint32_t stopCount;
+    uint32_t reserved2;
+};
+
+struct SolutionStop
+{
+    int32_t id;
+    StopKind kind;
+    uint8_t reserved[3];
+    double arrival;             // 到达/完成时间（小时），没有时间时为NaN
+};
+
+struct PlanDiffHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t changeCount;       // 路线有变化的车辆数
+    uint32_t stopCount;         // 所有替换后缀的停靠点总数
+    uint32_t unchangedCount;    // 路线不变、不需重新下发的车辆数
+    uint32_t reserved;
+};
+
+struct PlanDiffVehicle
+{
+    int32_t vehicleId;
+    int32_t centerId;
+    uint8_t drone;
+    uint8_t reserved[3];
+    uint32_t keptStops;         // 沿用的原路线前缀停靠点数（新增车辆为0）
+    uint32_t removedStops;      // 原路线中被替换的停靠点数（前缀之后的部分）
+    uint32_t firstStop;         // 替换后缀在停靠点数组中的起始下标
+    uint32_t stopCount;         // 替换后缀的停靠点数（路线被取消时为0）
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(SolutionHeader) == 40 && sizeof(SolutionVehicle) == 24 && sizeof(SolutionStop) == 16,
+              "方案文件记录布局");
+static_assert(sizeof(PlanDiffHeader) == 24 && sizeof(PlanDiffVehicle) == 32, "方案差异文件记录布局");
+
+// 读入整个文件（两种读取器的 open 共用）
+inline bool readWholeFile(const std::string &path, std::vector<char> &data)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    std::streamoff size = in.tellg();
+    if (size < 0) return false;
+    data.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    return (bool)in.read(data.data(), data.size());
+}
+
+// 方案文件读取器：open 读入整个文件，parse 直接解析调用方持有的内存（如mmap），两者都不做文本解析。
+// 记录指针指向读取器自己持有的缓冲区，不可复制；移动时缓冲区随之转移，指针仍然有效
+class SolutionReader
+{
+public:
+    SolutionReader() = default;
+    SolutionReader(const SolutionReader&) = delete;
+    SolutionReader& operator=(const SolutionReader&) = delete;
+    SolutionReader(SolutionReader&&) = default;
+    SolutionReader& operator=(SolutionReader&&) = default;
+
+    bool open(const std::string &path)
+    {
+        return readWholeFile(path, owned) && parse(owned.data(), owned.size());
+    }
+
+    // data需在读取器使用期间保持有效且按8字节对齐
+    bool parse(const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        if (size < sizeof(SolutionHeader)) return false;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (header.magic != SOLUTION_MAGIC || header.version != SOLUTION_VERSION) return false;
+        size_t vehicleBytes = (size_t)header.vehicleCount * sizeof(SolutionVehicle);
+        size_t stopBytes = (size_t)header.stopCount * sizeof(SolutionStop);
+        if (size < sizeof(SolutionHeader) + vehicleBytes + stopBytes) return false;
+        vehicleRecords = reinterpret_cast<const SolutionVehicle*>(bytes + sizeof(SolutionHeader));
+        stopRecords = reinterpret_cast<const SolutionStop*>(bytes + sizeof(SolutionHeader) + vehicleBytes);
+        for (uint32_t i = 0; i < header.vehicleCount; i++) {
+            const SolutionVehicle& vehicle = vehicleRecords[i];
+            if (vehicle.firstStop > header.stopCount || vehicle.stopCount > header.stopCount - vehicle.firstStop) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t vehicleCount() const { return header.vehicleCount; }
+    uint32_t taskCount() const { return header.taskCount; }
+    double makespan() const { return header.makespan; }
+    double cost() const { return header.cost; }
+
+    const SolutionVehicle& vehicle(uint32_t index) const { return vehicleRecords[index]; }
+
+    // 第index辆车的停靠点 [begin, end)
+    const SolutionStop* stopsBegin(uint32_t index) const { return stopRecords + vehicleRecords[index].firstStop; }
+    const SolutionStop* stopsEnd(uint32_t index) const { return stopsBegin(index) + vehicleRecords[index].stopCount; }
+
+private:
+    std::vector<char> owned;
+    SolutionHeader header = {};
+    const SolutionVehicle* vehicleRecords = nullptr;
+    const SolutionStop* stopRecords = nullptr;
+};
+
+// 方案差异文件读取器，用法及复制限制同 SolutionReader
+class PlanDiffReader
+{
+public:
+    PlanDiffReader() = default;
+    PlanDiffReader(const PlanDiffReader&) = delete;
+    PlanDiffReader& operator=(const PlanDiffReader&) = delete;
+    PlanDiffReader(PlanDiffReader&&) = default;
+    PlanDiffReader& operator=(PlanDiffReader&&) = default;
+
+    bool open(const std::string &path)
+    {
+        return readWholeFile(path, owned) && parse(owned.data(), owned.size());
+    }
+
+    // data需在读取器使用期间保持有效且按8字节对齐
+    bool parse(const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        if (size < sizeof(PlanDiffHeader)) return false;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (header.magic != PLAN_DIFF_MAGIC || header.version != PLAN_DIFF_VERSION) return false;
+        size_t vehicleBytes = (size_t)header.changeCount * sizeof(PlanDiffVehicle);
+        size_t stopBytes = (size_t)header.stopCount * sizeof(SolutionStop);
+        if (size < sizeof(PlanDiffHeader) + vehicleBytes + stopBytes) return false;
+        vehicleRecords = reinterpret_cast<const PlanDiffVehicle*>(bytes + sizeof(PlanDiffHeader));
+        stopRecords = reinterpret_cast<const SolutionStop*>(bytes + sizeof(PlanDiffHeader) + vehicleBytes);
+        for (uint32_t i = 0; i < header.changeCount; i++) {
+            const PlanDiffVehicle& vehicle = vehicleRecords[i];
+            if (vehicle.firstStop > header.stopCount || vehicle.stopCount > header.stopCount - vehicle.firstStop) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t changeCount() const { return header.changeCount; }
+    uint32_t unchangedCount() const { return header.unchangedCount; }
+
+    const PlanDiffVehicle& change(uint32_t index) const { return vehicleRecords[index]; }
+
+    // 第index辆车替换后的路线后缀 [begin, end)
+    const SolutionStop* stopsBegin(uint32_t index) const { return stopRecords + vehicleRecords[index].firstStop; }
+    const SolutionStop* stopsEnd(uint32_t index) const { return stopsBegin(index) + vehicleRecords[index].stopCount; }
+
+private:
+    std::vector<char> owned;
+    PlanDiffHeader header = {};
+    const PlanDiffVehicle* vehicleRecords = nullptr;
+    const SolutionStop* stopRecords = nullptr;
+};
+
+#endif // SOLUTION_FORMAT_H
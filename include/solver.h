@@ -9,11 +9,14 @@
 // 优化所有车辆的路径 - 修改返回类型为<车辆ID, <路径, 时间>>
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> static_optimizeAllPaths(
     const DeliveryProblem& problem,
-    const std::vector<std::pair<int, int>>& vehicleTaskAssignments);
+    const std::vector<std::pair<int, int>>& vehicleTaskAssignments,
+    const RouteSink& onRouteFinal = nullptr);
 
 // 求解静态配送问题 - 同样修改返回类型
+// onRouteFinal 非空时每辆车的最终路径一确定就回调
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveStaticProblem(
-    DeliveryProblem& problem);
+    DeliveryProblem& problem,
+    const RouteSink& onRouteFinal = nullptr);
 
 // 计算总完成时间和总成本 - 修改参数类型
 std::pair<double, double> calculateTotalTimeAndCost(
@@ -24,7 +27,8 @@ std::pair<double, double> calculateTotalTimeAndCost(
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveDynamicProblem(
     DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& staticPaths,
-    double staticMaxTime);
+    double staticMaxTime,
+    const RouteSink& onRouteFinal = nullptr);
 
 // 识别需要重新安排的任务 - 修改参数类型
 void identifyTasksForRescheduling(
@@ -0,0 +1,94 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "common.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// 路线构造的最近邻查询：一条路线的任务点坐标上建立均匀网格，访问过的点从网格删除。
+// 查询按格环由近到远枚举剩余的点，并给出环外点到查询点直线距离的下界；
+// 车辆按路网距离选点时，用标定的系数把直线距离换算为路网距离的下界（RouteNetwork::euclideanLowerBound），
+// 只对下界不超过当前最优值的点读取路网距离，其余点不再计算
+class TaskGrid
+{
+public:
+    // 以 x[i], y[i] 建立网格，点下标与坐标数组下标一致，平均每格约2个点
+    TaskGrid(const std::vector<double> &x, const std::vector<double> &y);
+
+    // 删除一个点（已访问），之后的查询不再枚举它
+    void remove(int point);
+    int remaining() const { return remainingCount; }
+
+    // 由近到远按格环枚举未删除的点：每环开始前调用 keepGoing(该环及更外各点到查询点的最小直线距离)，返回false时结束；
+    // 环内每个点调用 visit(点下标, 直线距离)，环内的顺序不保证由近到远
+    template <typename Visit, typename KeepGoing>
+    void search(double qx, double qy, Visit &&visit, KeepGoing &&keepGoing) const
+    {
+        int cx = (int)std::clamp(std::floor((qx - minX) / cellSize), 0.0, columns - 1.0);
+        int cy = (int)std::clamp(std::floor((qy - minY) / cellSize), 0.0, rows - 1.0);
+        int maxRing = std::max({cx, columns - 1 - cx, cy, rows - 1 - cy});
+        for (int ring = 0; ring <= maxRing && remainingCount > 0; ring++) {
+            if (!keepGoing(ringDistance(qx, qy, cx, cy, ring))) return;
+            int top = cy - ring, bottom = cy + ring;
+            for (int row = std::max(top, 0); row <= std::min(bottom, rows - 1); row++) {
+                // 环的上下两行整行扫描，中间各行只扫描左右两格
+                bool edgeRow = row == top || row == bottom;
+                int step = edgeRow ? 1 : 2 * ring;
+                for (int column = cx - ring; column <= cx + ring; column += step) {
+                    if (column < 0 || column >= columns) continue;
+                    scanCell(row * columns + column, qx, qy, visit);
+                }
+            }
+        }
+    }
+
+private:
+    template <typename Visit>
+    void scanCell(int cell, double qx, double qy, Visit &visit) const
+    {
+        if (cellLive[cell] == 0) return;
+        for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+            int point = points[k];
+            if (removed[point]) continue;
+            double dx = pointX[k] - qx;
+            double dy = pointY[k] - qy;
+            visit(point, std::sqrt(dx * dx + dy * dy));
+        }
+    }
+
+    // 第 ring 环及更外的格子都在以(cx, cy)为中心、边长 2*ring-1 格的方块之外，下界为查询点到方块各边的最近距离；
+    // 方块已到达网格边界的一侧没有更外的点，不计入。减去微小余量，抵消点按坐标分格时的舍入
+    double ringDistance(double qx, double qy, int cx, int cy, int ring) const
+    {
+        if (ring == 0) return 0.0;
+        const double none = std::numeric_limits<double>::infinity();
+        double left = cx - ring + 1 <= 0 ? none : qx - (minX + (cx - ring + 1) * cellSize);
+        double right = cx + ring - 1 >= columns - 1 ? none : minX + (cx + ring) * cellSize - qx;
+        double below = cy - ring + 1 <= 0 ? none : qy - (minY + (cy - ring + 1) * cellSize);
+        double above = cy + ring - 1 >= rows - 1 ? none : minY + (cy + ring) * cellSize - qy;
+        double gap = std::min({left, right, below, above});
+        return std::max(0.0, gap - cellSize * 1e-7);
+    }
+
+    double minX = 0.0, minY = 0.0;
+    double cellSize = 1.0;
+    int columns = 1, rows = 1;
+    std::vector<int> cellStart;         // 各格在 points 中的起始位置（CSR），共 columns*rows+1 项
+    std::vector<int> points;            // 按格排列的点下标
+    std::vector<double> pointX, pointY; // 与 points 同序的坐标
+    std::vector<int> cellOf;            // 点下标 -> 所在格
+    std::vector<int> cellLive;          // 各格未删除的点数
+    std::vector<char> removed;
+    int remainingCount = 0;
+};
+
+// 标定直线距离到路网距离的下界系数：任务点/配送中心两两之间 路网距离 / 直线距离 的最小值（留有舍入余量），
+// 写入 network.euclideanLowerBound。只在有稠密距离矩阵时标定（读取一次矩阵），收缩层次/lazy方式置0（不剪枝）
+void calibrateEuclideanLowerBound(DeliveryProblem &problem);
+
+// 新增任务点后只用它与其余各点的点对收紧系数（增量变更使用），未标定时不做处理
+void extendEuclideanLowerBound(DeliveryProblem &problem, NodeHandle added);
+
+#endif // SPATIAL_INDEX_H
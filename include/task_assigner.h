@@ -6,4 +6,7 @@
 // 将任务点分配给最近的配送中心
 void assignTasksToCenters(DeliveryProblem& problem);
 
+// 单个任务点的最近配送中心（按行驶时间，无人机中心需能往返），没有可用中心返回-1
+int findClosestCenter(const DeliveryProblem& problem, const TaskPoint& task);
+
 #endif // TASK_ASSIGNER_H 
\ No newline at end of file
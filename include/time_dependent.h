@@ -0,0 +1,79 @@
+#ifndef TIME_DEPENDENT_H
+#define TIME_DEPENDENT_H
+
+#include "common.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 时变行驶时间缓存的统计信息
+struct TimeDependentStats
+{
+    uint64_t hits = 0;          // 命中已缓存的行
+    uint64_t misses = 0;        // 需要运行时变Dijkstra计算新行
+    uint64_t evictions = 0;     // 因超出内存上限被淘汰的行
+    size_t cachedRows = 0;      // 当前缓存的行数
+    size_t capacityRows = 0;    // 内存上限对应的最大行数
+};
+
+// 时变最短路：高峰期系数按路段生效，车辆驶入每条路段时按当时所在时段计算该路段的行驶时间
+// （路段内跨越时段边界时按 legTravelTime 分段，保证先出发先到达，时变Dijkstra结果精确）。
+// 高峰期最快的路线可能与距离最短的路线不同，因此不能只对预计算的最短路整体乘以系数。
+//
+// 查询按 (源点, 出发时间桶) 缓存：某个源点在某个桶的起始时刻出发时，到全部目标节点（任务点/配送中心节点，
+// 与高峰期系数表的槽位一致）的行驶时间为一行，行按LRU缓存；任意出发时间在相邻两个桶之间线性插值
+class TimeDependentRoutes
+{
+public:
+    // targetNodes 为槽位 -> 路网节点ID；edgeFactors 中不是路段的节点对被忽略，没有系数的路段使用默认系数
+    TimeDependentRoutes(CsrGraph graph, const std::vector<EdgePeakFactor> &edgeFactors, TravelTimeProfile profile,
+                        std::vector<int> targetNodes, int bucketMinutes, size_t byteLimit);
+
+    // 两个槽位之间、departure时刻出发、车速为speed时的行驶时间（缓存插值），不可达返回无穷大
+    double travelTime(int sourceSlot, int targetSlot, double departure, double speed);
+
+    // 两个路网节点（节点ID）之间的精确时变行驶时间，直接运行一次时变Dijkstra，不使用缓存
+    double exactTravelTime(int sourceNodeId, int targetNodeId, double departure, double speed) const;
+
+    // 路网变化后在新邻接表上建立一份新的实例，本实例不变（它属于只读的交通快照，可能仍被其他读者使用）。
+    // 时刻表、目标节点、桶宽和缓存上限沿用本实例；edgeFactors 为完整的系数行，新增的路段也能对应到系数；统计计数延续
+    std::shared_ptr<TimeDependentRoutes> rebuilt(CsrGraph graph, const std::vector<EdgePeakFactor> &edgeFactors) const;
+
+    TimeDependentStats stats() const;
+    int bucketCount() const { return buckets; }
+
+private:
+    // 设置邻接表并清空全部已缓存的行
+    void reset(CsrGraph graph);
+    // 由节点对系数得到每条有向弧各时段的单位速度行驶时间
+    void buildArcTimes();
+    // 时变Dijkstra：arrival为departure时刻从source出发到各CSR节点的最早到达时刻
+    // targetSlot非空时全部目标节点确定后提前结束
+    void dijkstra(int source, double departure, double speed, std::vector<double> &arrival,
+                  const std::vector<int> *targetSlot, int targetCount) const;
+    // 读取（必要时计算）某个源点槽位在某个桶出发的行，需持有锁
+    const std::vector<double> &row(int sourceSlot, int bucket, double speed);
+
+    CsrGraph graph;
+    std::vector<EdgePeakFactor> edgeFactors;    // 只保留确实是路段的节点对，路网变化后重新对应到弧
+    std::vector<BandTravelTimes> arcTimes;      // 与 graph.targets 同下标
+    TravelTimeProfile profile;
+    std::vector<int> targetNodes;               // 槽位 -> 路网节点ID
+    std::vector<int> targetSlot;                // CSR索引 -> 槽位（-1表示不是目标节点）
+    int targetCount = 0;                        // 在路网中的目标节点数
+    int bucketMinutes;
+    int buckets;
+    double bucketHours;
+    size_t byteLimit;
+    size_t capacityRows;
+    double rowSpeed = 0.0;                      // 已缓存的行对应的车速，车速不同则清空重算
+    std::vector<std::vector<double>> rows;      // 源点槽位 * buckets + 桶 -> 到各槽位的行驶时间
+    std::list<int> recentRows;                  // 已缓存的行，表头为最近使用
+    std::vector<std::list<int>::iterator> position;
+    TimeDependentStats counters;
+    mutable std::mutex mutex;                   // 行计算也在锁内进行，多线程查询时串行化
+};
+
+#endif // TIME_DEPENDENT_H
@@ -0,0 +1,107 @@
+#ifndef TRAFFIC_FEED_H
+#define TRAFFIC_FEED_H
+
+#include "common.h"
+#include <atomic>
+#include <condition_variable>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 实时交通数据：高峰期系数可在求解过程中更新，不必重启。
+// 每组系数建立一份完整的只读快照（PeakFactorTable），按读-复制-更新方式发布：
+// 读者取得快照引用后一直使用同一版本，写者建好新快照后原子替换，旧版本在最后一个引用释放后回收
+
+// 建立交通快照所需的输入：由求解线程从 problem 复制一份，之后不再与 problem 共享任何状态，
+// 后台线程只读取这份副本（求解线程可同时修改 problem）；路网变化后求解线程复制新的一份交给发布点
+struct TrafficSnapshotInputs
+{
+    CsrGraph graph;                         // 时变最短路使用的邻接表
+    std::vector<double> slotDistances;      // 复制时各槽位对的最短距离（pairIndex下标），没有稠密double矩阵时为空
+    uint64_t distanceVersion = 0;           // 复制时的 network.distanceVersion
+    TravelTimeProfile travelProfile;
+    bool timeDependent = false;
+    int timeBucketMinutes = 15;
+    size_t rowCacheBytes = 0;
+};
+
+// 在求解线程中复制建立快照所需的输入，槽位取当前生效快照的槽位
+TrafficSnapshotInputs captureTrafficInputs(const DeliveryProblem &problem);
+
+// 由一组系数行建立一版交通快照：沿用layout的槽位，重新计算时段行驶时间表，启用时变最短路时按新系数重建。
+// 只读取 inputs，可在后台线程中调用；layout 的槽位多于复制距离时的槽位时不建立时段行驶时间表（按系数现算）
+std::shared_ptr<PeakFactorTable> buildTrafficSnapshot(const PeakFactorTable &layout, const TrafficSnapshotInputs &inputs,
+                                                      const std::vector<EdgePeakFactor> &lines);
+// 同上，直接读取 problem，只在求解线程中调用
+std::shared_ptr<PeakFactorTable> buildTrafficSnapshot(const PeakFactorTable &layout, const DeliveryProblem &problem,
+                                                      const std::vector<EdgePeakFactor> &lines);
+
+// 按一组系数行为各槽位节点建立时变最短路（--time-dependent）
+std::shared_ptr<TimeDependentRoutes> buildTimeDependentRoutes(const DeliveryProblem &problem,
+                                                              const std::vector<EdgePeakFactor> &lines,
+                                                              const std::vector<int> &slotNodes);
+
+// 解析一行 "节点1 节点2 早高峰系数 晚高峰系数"，格式错误返回false
+bool parseFactorLine(const std::string &line, EdgePeakFactor &factor);
+
+// 交通数据发布点，同时保存后台线程建立快照所用的输入
+class TrafficFeed
+{
+public:
+    explicit TrafficFeed(std::shared_ptr<const PeakFactorTable> initial);
+
+    // 当前已发布的快照
+    std::shared_ptr<const PeakFactorTable> snapshot() const;
+    // 当前建立快照所用的输入，没有设置过时为空
+    std::shared_ptr<const TrafficSnapshotInputs> snapshotInputs() const;
+
+    // 替换建立快照所用的输入（路网变化后由求解线程调用），此前按旧输入建立、尚未发布的快照不再能发布
+    void setSnapshotInputs(std::shared_ptr<const TrafficSnapshotInputs> inputs);
+
+    // 发布新快照，版本号为上一版加一，返回新版本号。
+    // builtOn/builtFrom 非空时只在它们仍是当前快照/当前输入时发布，否则不发布并返回0，由调用方取最新的快照和输入重建
+    uint64_t publish(std::shared_ptr<PeakFactorTable> table, const PeakFactorTable* builtOn = nullptr,
+                     const TrafficSnapshotInputs* builtFrom = nullptr);
+
+private:
+    std::shared_ptr<const PeakFactorTable> current;     // 只通过 std::atomic_load/atomic_store 访问
+    std::shared_ptr<const TrafficSnapshotInputs> inputs;  // 同上
+    std::mutex publishMutex;                            // 多个写者之间串行，保证版本号连续
+};
+
+// 后台更新线程：source为文件路径时定期检查修改时间和大小，变化后整体重读；
+// source为 "-" 时从标准输入读取，空行或输入结束为一组。每组系数在最新快照的槽位和发布点的最新输入上建立新快照后发布。
+// 构造时（求解线程中）复制建立快照所需的输入交给发布点，后台线程不访问 problem；
+// 路段更新（updateRoadEdge 的 DeliveryProblem 版本）替换发布点的输入，之后的快照建立在新路网上
+class TrafficWatcher
+{
+public:
+    TrafficWatcher(const DeliveryProblem &problem, std::shared_ptr<TrafficFeed> feed,
+                   std::string source, int pollMilliseconds = 1000);
+    ~TrafficWatcher();  // 停止并等待后台线程结束
+
+    TrafficWatcher(const TrafficWatcher&) = delete;
+    TrafficWatcher& operator=(const TrafficWatcher&) = delete;
+
+private:
+    void watchFile();
+    void readStandardInput();
+    void publish(const std::vector<EdgePeakFactor> &lines);
+    bool waitFor(int milliseconds);     // 等待指定时间，期间被要求停止返回false
+
+    std::shared_ptr<TrafficFeed> feed;
+    std::string source;
+    int pollMilliseconds;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+};
+
+// 由求解线程在两次优化之间调用：有新发布的版本时设为生效快照并返回true
+bool refreshTraffic(DeliveryProblem &problem);
+
+#endif // TRAFFIC_FEED_H
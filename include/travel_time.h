@@ -0,0 +1,25 @@
+#ifndef TRAVEL_TIME_H
+#define TRAVEL_TIME_H
+
+#include "common.h"
+#include <string>
+#include <vector>
+
+// 考虑高峰期的车辆行驶时间：把一天按高峰时间窗分段，段内车速不变，
+// 路段的到达时间是出发时间的分段线性函数，用累计“路程进度”的二分查找直接求出，不再逐段循环
+
+// 解析 "7-9,17-19" 形式的高峰时间窗（小时，可带小数），12点前开始的时间窗使用早高峰系数，其余使用晚高峰系数
+// 时间窗需满足 0 <= start < end <= 24 且互不重叠，否则输出错误并返回false
+bool parsePeakWindows(const std::string &spec, std::vector<PeakWindow> &windows);
+
+// 由高峰时间窗建立一天的分段时刻表（时间窗之外为非高峰期）
+TravelTimeProfile buildTravelTimeProfile(const std::vector<PeakWindow> &windows);
+
+// 一天中某时刻所属时段（超过24小时按天取模）
+TimeBand timeBandAt(const TravelTimeProfile &profile, double hour);
+
+// 路段各时段的单位速度行驶时间为times、车速为speed时，departure时刻出发所需的行驶时间
+// 路程不足0.0001时视为0，不可达时返回无穷大
+double legTravelTime(const TravelTimeProfile &profile, const BandTravelTimes &times, double speed, double departure);
+
+#endif // TRAVEL_TIME_H
@@ -1,13 +1,26 @@
 #include "common.h"
 #include "solver.h"  // 添加这一行以访问calculateTotalTimeAndCost函数
+#include "shortest_path.h"
+#include "contraction_hierarchy.h"
+#include "distance_rows.h"
+#include "road_path.h"
+#include "hilbert_order.h"
+#include "neighbor_lists.h"
+#include "spatial_index.h"
+#include "travel_time.h"
+#include "traffic_feed.h"
+#include "mapped_file.h"
+#include "input_parser.h"
+#include "instance_file.h"
+#include <future>
 #include <iostream>
 #include <iomanip>  // 用于设置输出精度
 #include <algorithm>  // 添加对 std::sort 的包含
 #include <unordered_map>  // 添加对 std::unordered_map 的包含
 #include <vector>
+#include <type_traits>
 using std::vector;
 using std::sqrt;
-using std::ifstream;
 using std::cout;
 using std::endl;
 using std::string;
@@ -15,52 +28,65 @@ using std::unordered_map;
 
 double droneSpeed, carSpeed, droneCost, vehicleCost, droneMaxLoad, droneMaxFuel, timeWeight;
 
-// 从文件加载问题数据
-bool loadProblemData(const string &filename, DeliveryProblem &problem)
+// 从文件加载问题数据：整个文件映射到内存后就地解析（二进制实例见 instance_file.h）
+bool loadProblemData(const string &filename, DeliveryProblem &problem, vector<EdgePeakFactor>* savedFactorLines)
 {
-    ifstream file(filename);
-    if (!file.is_open())
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(filename))
     {
         std::cerr << "无法打开文件: " << filename << std::endl;
         return false;
     }
+    // delivery_convert生成的二进制实例直接映射，不做文本解析
+    if (isInstanceFile(*file)) {
+        return loadInstanceFile(file, problem, savedFactorLines);
+    }
+    TokenScanner scanner(file->data(), file->data() + file->size());
+    auto formatError = [&filename](const char* section) {
+        std::cerr << "文件格式错误（" << section << "）: " << filename << std::endl;
+        return false;
+    };
+
+    // 高峰时间窗对应的一天分段时刻表
+    problem.travelProfile = buildTravelTimeProfile(problem.config.peakWindows);
+
+    // 最短路在后台线程计算，与其余部分的解析重叠；提前返回时future析构会等待其结束
+    std::future<void> shortestPaths;
+    auto startShortestPaths = [&shortestPaths, &problem]() {
+        shortestPaths = std::async(std::launch::async, [&problem]() { computeShortestPaths(problem); });
+    };
 
     try
     {
         // 读取基本问题参数
         int initialDemandCount, extraDemandCount, vehicleCenterCount, droneCenterCount;
-        file >> initialDemandCount >> extraDemandCount >> vehicleCenterCount >> droneCenterCount;
+        if (!scanner.readAll(initialDemandCount, extraDemandCount, vehicleCenterCount, droneCenterCount)) {
+            return formatError("需求点与配送中心数量");
+        }
         problem.initialDemandCount = initialDemandCount;
         problem.extraDemandCount = extraDemandCount;
 
         // 读取车辆和无人机的参数
-        file >> droneSpeed >> carSpeed >> droneCost >> vehicleCost >> droneMaxLoad >> droneMaxFuel >> timeWeight;
+        if (!scanner.readAll(droneSpeed, carSpeed, droneCost, vehicleCost, droneMaxLoad, droneMaxFuel, timeWeight)) {
+            return formatError("车辆参数");
+        }
         problem.timeWeight = timeWeight;
         droneMaxFuel = DeliveryProblem::DEFAULT_DRONE_FUEL;
         // 读取路网信息
         int edgeCount;
-        file >> edgeCount;
-        problem.network.edges.resize(edgeCount);
-
-        // 构建路网的边和距离矩阵
-        for (int i = 0; i < edgeCount; ++i)
-        {
-            int node1, node2;
-            double length;
-            file >> node1 >> node2 >> length;
-            
-            // 将米转换为公里
-            length /= 1000.0;
-            
-            
-            problem.network.edges[i] = {node1, node2, length};
-            problem.network.distances[node1][node2] = length;
-            problem.network.distances[node2][node1] = length;
-            
+        if (!scanner.read(edgeCount) || edgeCount < 0 ||
+            !parseEdgeSection(scanner, edgeCount, problem.network.edges, problem.config.threadCount)) {
+            return formatError("路网边");
         }
 
-        // 使用 Floyd算法计算所有点对最短路径
-        floyd(problem.network);
+        // 只依赖路网边的方式（Floyd/分块Floyd、lazy）此时即可开始计算最短路；
+        // Dijkstra与收缩层次需要终端节点，Hilbert重排需要任务点坐标，等任务点和配送中心读完再开始
+        ApspMethod method = problem.config.apspMethod;
+        bool edgesOnly = !problem.config.hilbertOrder &&
+                         (method == ApspMethod::Floyd || method == ApspMethod::Blocked || method == ApspMethod::Lazy);
+        if (edgesOnly) {
+            startShortestPaths();
+        }
 
         // 初始化任务点容器
         problem.tasks.resize(initialDemandCount + extraDemandCount);
@@ -70,7 +96,9 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
         {
             int id;
             double latitude, longitude, pickup_weight, delivery_weight;
-            file >> id >> longitude >> latitude >> pickup_weight >> delivery_weight;
+            if (!scanner.readAll(id, longitude, latitude, pickup_weight, delivery_weight)) {
+                return formatError("初始需求点");
+            }
             auto [x, y] = convertLatLongToXY(latitude, longitude);
             problem.tasks[i] = {
                 id, x, y, 0.0,    
@@ -82,6 +110,7 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
         }
 
         problem.centers.resize(vehicleCenterCount + droneCenterCount);
+        problem.vehicleCenterCount = vehicleCenterCount;
         int vehicleIdCounter = 1;  // 从1开始
         
         for (int i = 0; i < vehicleCenterCount; ++i)
@@ -90,7 +119,9 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
             double latitude, longitude;
             int vehicleCount;
             
-            file >> id >> longitude >> latitude >> vehicleCount;
+            if (!scanner.readAll(id, longitude, latitude, vehicleCount)) {
+                return formatError("车辆配送中心");
+            }
             id += 20000;//配送中心ID从20000开始
             auto [x, y] = convertLatLongToXY(latitude, longitude);
             
@@ -121,7 +152,9 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
             double latitude, longitude;
             int droneCount;
             
-            file >> id >> longitude >> latitude >> droneCount;
+            if (!scanner.readAll(id, longitude, latitude, droneCount)) {
+                return formatError("无人机配送中心");
+            }
             id += 20000;
             auto [x, y] = convertLatLongToXY(latitude, longitude);
 
@@ -150,7 +183,9 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
         {
             int id;
             double latitude, longitude, pickup_weight, delivery_weight, arrivaltime;
-            file >> id >> longitude >> latitude >> pickup_weight >> delivery_weight >> arrivaltime;
+            if (!scanner.readAll(id, longitude, latitude, pickup_weight, delivery_weight, arrivaltime)) {
+                return formatError("额外需求点");
+            }
             arrivaltime = arrivaltime / 60.0;//将分钟转换为小时
             auto [x, y] = convertLatLongToXY(latitude, longitude);
             
@@ -166,43 +201,20 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
             problem.coordinates[uniqueId] = {x, y};  // 存储坐标映射
         }
 
-        cout << "\n=====================================" << endl;
-        cout << "数据加载成功！" << endl;
-        cout << "初始需求点: " << initialDemandCount << ", 额外需求点: " << extraDemandCount << endl;
-        cout << "车辆数量: " << problem.vehicles.size() << endl;
-        
-        int droneCount = 0;
-        for (const auto& vehicle : problem.vehicles) {
-            if (vehicle.maxLoad > 0) droneCount++;
-        }
-        cout << "其中无人机数量: " << droneCount << endl;
-        
-        // 在读取中心数据后添加
-        for (size_t i = 0; i < problem.centers.size(); ++i) {
-            problem.centerIdToIndex[problem.centers[i].id] = i;
-            problem.centerIds.insert(problem.centers[i].id); // 添加到集合中
-        }
-        
-        for (size_t i = 0; i < problem.tasks.size(); i++) {
-            problem.taskIdToIndex[problem.tasks[i].id] = i;
-        }
-        
-        for (size_t i = 0; i < problem.vehicles.size(); i++) {
-            problem.vehicleIdToIndex[problem.vehicles[i].id] = i;
-        }
-        
-        // 读取早高峰和晚高峰速度系数
-        int node1, node2;
-        double morningFactor, eveningFactor;
-        while (file >> node1 >> node2 >> morningFactor >> eveningFactor) {
-            // 存储早高峰和晚高峰速度系数
-            for (int x = 0; x <= 2; x ++ ){
-                for (int y = 0; y <= 2; y ++ ){
-                    problem.network.peakFactors[node1 + x * 10000][node2 + y * 10000] = {morningFactor, eveningFactor};
-                    problem.network.peakFactors[node2 + y * 10000][node1 + x * 10000] = {morningFactor, eveningFactor};  // 双向存储
-                }
+        // 任务点和配送中心读取完毕后，其余方式开始计算最短路径，与速度系数的解析重叠
+        if (!edgesOnly) {
+            if (problem.config.hilbertOrder) {
+                sortTasksAlongHilbert(problem);
             }
+            startShortestPaths();
         }
+
+        // 早高峰和晚高峰速度系数读到文件末尾
+        vector<EdgePeakFactor> factorLines = parseFactorSection(scanner.position(), scanner.limit(),
+                                                                problem.config.threadCount);
+        shortestPaths.get();
+        finishProblemLoad(problem, factorLines);
+        if (savedFactorLines) *savedFactorLines = std::move(factorLines);
         
         return true;
     }
@@ -213,47 +225,163 @@ bool loadProblemData(const string &filename, DeliveryProblem &problem)
     }
 }
 
-// Floyd算法计算所有点对最短路径
-void floyd(RouteNetwork &network)
+// 文本与二进制实例共用的加载收尾：输出加载信息，建立ID映射、点位句柄和系数槽位，由系数行建立第一版交通快照
+void finishProblemLoad(DeliveryProblem &problem, const vector<EdgePeakFactor> &factorLines)
 {
-    // 收集所有节点ID
-    std::vector<int> nodes;
-    for (const auto& pair : network.distances) {
-        nodes.push_back(pair.first);
+#ifdef DEBUG_DISTANCE_MAP
+    buildDistanceMapView(problem.network);
+#endif
+
+    cout << "\n=====================================" << '\n';
+    cout << "数据加载成功！" << '\n';
+    cout << "初始需求点: " << problem.initialDemandCount << ", 额外需求点: " << problem.extraDemandCount << '\n';
+    cout << "车辆数量: " << problem.vehicles.size() << '\n';
+    
+    int droneCount = 0;
+    for (const auto& vehicle : problem.vehicles) {
+        if (vehicle.maxLoad > 0) droneCount++;
+    }
+    cout << "其中无人机数量: " << droneCount << '\n';
+    
+    // 在读取中心数据后添加
+    for (size_t i = 0; i < problem.centers.size(); ++i) {
+        problem.centerIdToIndex[problem.centers[i].id] = i;
+        problem.centerIds.insert(problem.centers[i].id); // 添加到集合中
+    }
+    
+    for (size_t i = 0; i < problem.tasks.size(); i++) {
+        problem.taskIdToIndex[problem.tasks[i].id] = i;
     }
     
-    // 节点数量
-    int n = nodes.size();
-
-    // 初始化距离矩阵 (确保每个点到自身的距离为0)
-    for (int i = 0; i < n; i++) {
-        if (network.distances.count(nodes[i])) {
-            network.distances.at(nodes[i])[nodes[i]] = 0.0;
-        }
-    }
-
-    // 标准的Floyd算法
-    for (int k = 0; k < n; k++) {
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                if (network.distances.count(nodes[i]) && 
-                    network.distances[nodes[i]].count(nodes[k]) &&
-                    network.distances.count(nodes[k]) && 
-                    network.distances[nodes[k]].count(nodes[j])) {
-                
-                    double throughK = network.distances[nodes[i]][nodes[k]] + 
-                                    network.distances[nodes[k]][nodes[j]];
-                    
-                    if (!network.distances[nodes[i]].count(nodes[j]) || 
-                        throughK < network.distances[nodes[i]][nodes[j]]) {
-                        network.distances[nodes[i]][nodes[j]] = throughK;
-                    }
+    for (size_t i = 0; i < problem.vehicles.size(); i++) {
+        problem.vehicleIdToIndex[problem.vehicles[i].id] = i;
+    }
+    buildNodeHandles(problem);
+    calibrateEuclideanLowerBound(problem);
+    if (problem.config.neighborCount > 0) {
+        problem.neighbors = buildNeighborLists(problem, problem.config.neighborCount);
+    }
+    initPeakFactorSlots(problem);
+    
+    // 由速度系数建立第一版交通快照
+    problem.network.peakFactors = buildTrafficSnapshot(*problem.network.peakFactors, problem, factorLines);
+}
+
+// 收集路网节点，建立节点ID到索引的映射并初始化距离矩阵
+void buildNodeIndex(RouteNetwork &network)
+{
+    int maxNodeId = -1;
+    for (const auto& edge : network.edges) {
+        maxNodeId = std::max(maxNodeId, std::max(edge.node1, edge.node2));
+    }
+
+    network.nodeIds.clear();
+    network.nodeIndex.assign(maxNodeId + 1, -1);
+    for (const auto& edge : network.edges) {
+        for (int nodeId : {edge.node1, edge.node2}) {
+            if (network.nodeIndex[nodeId] == -1) {
+                network.nodeIndex[nodeId] = network.nodeIds.size();
+                network.nodeIds.push_back(nodeId);
+            }
+        }
+    }
+    network.nodeCount = network.nodeIds.size();
+
+    // 初始化距离矩阵：自身为0，相邻节点为边长度（重边取较短者），其余为无穷大
+    size_t n = network.nodeCount;
+    network.distMatrix.assign(n * n, std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < n; i++) {
+        network.distMatrix[i * n + i] = 0.0;
+    }
+    for (const auto& edge : network.edges) {
+        size_t u = network.nodeIndex[edge.node1];
+        size_t v = network.nodeIndex[edge.node2];
+        double length = std::min(network.distMatrix[u * n + v], edge.length);
+        network.distMatrix[u * n + v] = length;
+        network.distMatrix[v * n + u] = length;
+    }
+}
+
+// 按buildNodeIndex建立的初始矩阵初始化下一跳：自身和相邻节点指向目标本身，其余不可达
+void initNextHops(RouteNetwork &network)
+{
+    size_t n = network.nodeCount;
+    NextHopMatrix& hops = network.nextHop;
+    hops = NextHopMatrix();
+    hops.nodeCount = n;
+    bool narrow = n < UINT16_MAX;
+    if (narrow) {
+        hops.hops16.assign(n * n, UINT16_MAX);
+    } else {
+        hops.hops32.assign(n * n, -1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (network.distMatrix[i * n + j] == std::numeric_limits<double>::infinity()) continue;
+            if (narrow) {
+                hops.hops16[i * n + j] = j;
+            } else {
+                hops.hops32[i * n + j] = j;
+            }
+        }
+    }
+}
+
+// Floyd主循环；HopPtr不是nullptr_t时同步记录下一跳：经k更短时 next[i][j] = next[i][k]
+template <typename HopPtr>
+static void floydKernel(double* dist, HopPtr hops, size_t n)
+{
+    constexpr bool recordHops = !std::is_same_v<HopPtr, std::nullptr_t>;
+    for (size_t k = 0; k < n; k++) {
+        const double* rowK = dist + k * n;
+        for (size_t i = 0; i < n; i++) {
+            double* rowI = dist + i * n;
+            double distIK = rowI[k];
+            if (distIK == std::numeric_limits<double>::infinity()) continue;
+            for (size_t j = 0; j < n; j++) {
+                double throughK = distIK + rowK[j];
+                if (throughK < rowI[j]) {
+                    rowI[j] = throughK;
+                    if constexpr (recordHops) hops[i * n + j] = hops[i * n + k];
                 }
             }
         }
     }
 }
 
+// Floyd算法计算所有点对最短路径（在稠密矩阵上原地进行），已初始化下一跳时一并记录
+void floyd(RouteNetwork &network)
+{
+    size_t n = network.nodeCount;
+    double* dist = network.distMatrix.data();
+    NextHopMatrix& hops = network.nextHop;
+
+    if (hops.nodeCount == (int)n && !hops.hops16.empty()) {
+        floydKernel(dist, hops.hops16.data(), n);
+    } else if (hops.nodeCount == (int)n && !hops.hops32.empty()) {
+        floydKernel(dist, hops.hops32.data(), n);
+    } else {
+        floydKernel(dist, nullptr, n);
+    }
+}
+
+#ifdef DEBUG_DISTANCE_MAP
+// 由稠密矩阵生成按节点ID索引的调试视图（仅包含可达点对）
+void buildDistanceMapView(RouteNetwork &network)
+{
+    network.distances.clear();
+    for (int i = 0; i < network.nodeCount; i++) {
+        auto& row = network.distances[network.nodeIds[i]];
+        for (int j = 0; j < network.nodeCount; j++) {
+            double distance = network.distanceAt(i, j);
+            if (distance < std::numeric_limits<double>::infinity()) {
+                row[network.nodeIds[j]] = distance;
+            }
+        }
+    }
+}
+#endif
+
 // 计算两点间距离
 double getDistance(int id1, int id2, const DeliveryProblem& problem, bool isDrone)
 {
@@ -275,18 +403,178 @@ double getDistance(int id1, int id2, const DeliveryProblem& problem, bool isDron
         return euclideanDist;
     } else {
         // 车辆优先使用路网最短距离
-        if (id1 > 20000) id1 -= 20000;
-        if (id2 > 20000) id2 -= 20000;
-        if (id1 > 10000) id1 -= 10000;
-        if (id2 > 10000) id2 -= 10000;
-        if (problem.network.distances.count(id1) && problem.network.distances.at(id1).count(id2)) {
-            return problem.network.distances.at(id1).at(id2);
+        if (problem.network.hierarchy) {
+            return hierarchyDistance(*problem.network.hierarchy, toRoadNodeId(id1), toRoadNodeId(id2));
+        }
+        if (problem.network.lazyRows) {
+            return problem.network.lazyRows->distance(toRoadNodeId(id1), toRoadNodeId(id2));
+        }
+        int index1 = problem.network.indexOf(toRoadNodeId(id1));
+        int index2 = problem.network.indexOf(toRoadNodeId(id2));
+        if (index1 < 0 || index2 < 0) {
+            return std::numeric_limits<double>::infinity();//如果路网中没有这两点，设置为无穷大
+        }
+
+        return problem.network.distanceAt(index1, index2);//不可达的点对在矩阵中即为无穷大
+    }
+}
+
+// 解析每个任务点和配送中心的距离矩阵索引
+void buildNodeHandles(DeliveryProblem &problem)
+{
+    problem.taskMatrixIndex.resize(problem.tasks.size());
+    for (size_t i = 0; i < problem.tasks.size(); i++) {
+        problem.taskMatrixIndex[i] = problem.network.indexOf(toRoadNodeId(problem.tasks[i].id));
+    }
+    problem.centerMatrixIndex.resize(problem.centers.size());
+    for (size_t i = 0; i < problem.centers.size(); i++) {
+        problem.centerMatrixIndex[i] = problem.network.indexOf(toRoadNodeId(problem.centers[i].id));
+    }
+}
+
+// 为任务点和配送中心所在的路网节点分配高峰期系数表槽位，生效的快照暂时只含槽位（系数均为默认）
+void initPeakFactorSlots(DeliveryProblem &problem)
+{
+    auto layout = std::make_shared<PeakFactorTable>();
+    PeakFactorTable& table = *layout;
+    int maxNodeId = -1;
+    for (const auto& task : problem.tasks) maxNodeId = std::max(maxNodeId, toRoadNodeId(task.id));
+    for (const auto& center : problem.centers) maxNodeId = std::max(maxNodeId, toRoadNodeId(center.id));
+
+    table.slotOf.assign(maxNodeId + 1, -1);
+    table.slotNodes.clear();
+    auto assignSlot = [&table](int pointId) {
+        int node = toRoadNodeId(pointId);
+        if (node < 0) return -1;
+        if (table.slotOf[node] < 0) {
+            table.slotOf[node] = (int)table.slotNodes.size();
+            table.slotNodes.push_back(node);
+        }
+        return table.slotOf[node];
+    };
+    problem.taskFactorSlot.resize(problem.tasks.size());
+    for (size_t i = 0; i < problem.tasks.size(); i++) {
+        problem.taskFactorSlot[i] = assignSlot(problem.tasks[i].id);
+    }
+    problem.centerFactorSlot.resize(problem.centers.size());
+    for (size_t i = 0; i < problem.centers.size(); i++) {
+        problem.centerFactorSlot[i] = assignSlot(problem.centers[i].id);
+    }
+
+    table.slotCount = (int)table.slotNodes.size();
+    table.factors.assign((size_t)table.slotCount * (table.slotCount + 1) / 2, PeakFactor());
+    problem.network.peakFactors = layout;
+}
+
+// 一个槽位对的各时段单位速度行驶时间，没有系数的路段使用默认系数
+static BandTravelTimes pairBandTimes(double distance, const PeakFactor& factor)
+{
+    double morning = factor.valid() ? factor.morning : DeliveryProblem::DEFAULT_MORNING_PEAK_FACTOR;
+    double evening = factor.valid() ? factor.evening : DeliveryProblem::DEFAULT_EVENING_PEAK_FACTOR;
+    return {{distance, distance / morning, distance / evening}};
+}
+
+// 是否为各槽位对预计算行驶时间：只在距离矩阵为稠密double存储时建立
+static bool hasDenseMatrix(const RouteNetwork &network)
+{
+    if (network.hierarchy || network.lazyRows || network.compact.storage != MatrixStorage::Double) return false;
+    return !network.distMatrix.empty() || network.mappedMatrix;
+}
+
+vector<double> slotPairDistances(const vector<int> &slotNodes, const RouteNetwork &network)
+{
+    if (!hasDenseMatrix(network)) return {};
+    int slotCount = (int)slotNodes.size();
+    vector<int> matrixIndex(slotCount);
+    for (int s = 0; s < slotCount; s++) {
+        matrixIndex[s] = network.indexOf(slotNodes[s]);
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    vector<double> distances((size_t)slotCount * (slotCount + 1) / 2);
+    for (int b = 0; b < slotCount; b++) {
+        for (int a = 0; a <= b; a++) {
+            distances[PeakFactorTable::pairIndex(a, b)] = (matrixIndex[a] < 0 || matrixIndex[b] < 0) ? inf
+                : network.distanceAt(matrixIndex[a], matrixIndex[b]);
         }
- 
-        return std::numeric_limits<double>::infinity();//如果路网中没有这两点间的距离，设置为无穷大
+    }
+    return distances;
+}
+
+void buildBandTravelTimes(PeakFactorTable &table, const vector<double> &pairDistances, uint64_t distanceVersion)
+{
+    table.bandTimes.clear();
+    table.bandDistanceVersion = distanceVersion;
+    if (pairDistances.empty() || pairDistances.size() < table.factors.size()) return;
+    table.bandTimes.resize(table.factors.size());
+    for (size_t k = 0; k < table.factors.size(); k++) {
+        table.bandTimes[k] = pairBandTimes(pairDistances[k], table.factors[k]);
+    }
+}
+
+// 按槽位对预计算各时段的单位速度行驶时间
+// 只在距离矩阵为稠密double存储时建立；收缩层次/lazy/紧凑存储方式下保持为空，查询时按系数现算
+void buildBandTravelTimes(PeakFactorTable &table, const RouteNetwork &network)
+{
+    buildBandTravelTimes(table, slotPairDistances(table.slotNodes, network), network.distanceVersion);
+}
+
+// 新加入的最后一个槽位：上三角按较大槽位分组，新槽位的各点对正好追加在末尾，已有点对不必重算
+void appendBandTravelTimes(PeakFactorTable &table, const RouteNetwork &network, int slot)
+{
+    if (table.bandTimes.empty() || !hasDenseMatrix(network)) return;
+    if (table.bandDistanceVersion != network.distanceVersion) {
+        // 已有的表按旧距离建立，整体重建（已含新槽位）
+        buildBandTravelTimes(table, network);
+        return;
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    int self = network.indexOf(table.slotNodes[slot]);
+    table.bandTimes.resize(table.factors.size());
+    for (int a = 0; a <= slot; a++) {
+        int other = network.indexOf(table.slotNodes[a]);
+        double distance = (self < 0 || other < 0) ? inf : network.distanceAt(other, self);
+        size_t k = PeakFactorTable::pairIndex(a, slot);
+        table.bandTimes[k] = pairBandTimes(distance, table.factors[k]);
     }
 }
 
+// 对外ID -> 句柄（协同点还原为对应任务点），未知ID返回无效句柄
+NodeHandle resolveNodeHandle(const DeliveryProblem& problem, int pointId)
+{
+    NodeHandle handle;
+    if (pointId > 30000) {
+        handle.collaboration = true;
+        pointId -= 30000;
+    }
+    auto center = problem.centerIdToIndex.find(pointId);
+    if (center != problem.centerIdToIndex.end()) {
+        handle.kind = NodeKind::Center;
+        handle.index = center->second;
+        return handle;
+    }
+    auto task = problem.taskIdToIndex.find(pointId);
+    if (task != problem.taskIdToIndex.end()) {
+        handle.index = task->second;
+    }
+    return handle;
+}
+
+std::vector<NodeHandle> resolveNodeHandles(const DeliveryProblem& problem, const std::vector<int>& pointIds)
+{
+    std::vector<NodeHandle> handles;
+    handles.reserve(pointIds.size());
+    for (int pointId : pointIds) handles.push_back(resolveNodeHandle(problem, pointId));
+    return handles;
+}
+
+// 句柄 -> 对外ID
+int nodeHandleId(const DeliveryProblem& problem, NodeHandle handle)
+{
+    int id = handle.kind == NodeKind::Task ? problem.tasks[handle.index].id : problem.centers[handle.index].id;
+    return handle.collaboration ? id + 30000 : id;
+}
+
 // 经纬度转换为直角坐标系（单位：公里）
 std::pair<double, double> convertLatLongToXY(double latitude, double longitude) {
     // 将经纬度转换为弧度
@@ -302,24 +590,24 @@ std::pair<double, double> convertLatLongToXY(double latitude, double longitude)
 
 // 打印初始阶段的信息
 void printInitialInfo(const DeliveryProblem& problem) {
-    std::cout << "========== 初始阶段信息 ==========" << std::endl;
+    std::cout << "========== 初始阶段信息 ==========" << '\n';
     
     // 输出基本参数
-    std::cout << "Car速度: " << carSpeed << " km/h" << std::endl;
-    std::cout << "Drone速度: " << droneSpeed << " km/h" << std::endl;
-    std::cout << "Drone载重: " << droneMaxLoad << " kg" << std::endl;
-    std::cout << "Drone电量: " << droneMaxFuel << " h" << std::endl;
-    std::cout << "时间权重: " << problem.timeWeight << std::endl;
-    std::cout << "延迟任务惩罚系数: " << DeliveryProblem::DEFAULT_DELAY_PENALTY << std::endl;
-    std::cout << "早高峰时间: [" << DeliveryProblem::MORNING_PEAK_START << ", " 
-              << DeliveryProblem::MORNING_PEAK_END << "], 默认速度系数: " 
-              << problem.morningPeakFactor << std::endl;
-    std::cout << "晚高峰时间: [" << DeliveryProblem::EVENING_PEAK_START << ", " 
-              << DeliveryProblem::EVENING_PEAK_END << "], 默认速度系数: " 
-              << problem.eveningPeakFactor << std::endl;
+    std::cout << "Car速度: " << carSpeed << " km/h" << '\n';
+    std::cout << "Drone速度: " << droneSpeed << " km/h" << '\n';
+    std::cout << "Drone载重: " << droneMaxLoad << " kg" << '\n';
+    std::cout << "Drone电量: " << droneMaxFuel << " h" << '\n';
+    std::cout << "时间权重: " << problem.timeWeight << '\n';
+    std::cout << "延迟任务惩罚系数: " << DeliveryProblem::DEFAULT_DELAY_PENALTY << '\n';
+    for (const auto& window : problem.config.peakWindows) {
+        bool morning = window.band == MorningPeak;
+        std::cout << (morning ? "早高峰时间: [" : "晚高峰时间: [") << window.start << ", " 
+                  << window.end << "], 默认速度系数: " 
+                  << (morning ? problem.morningPeakFactor : problem.eveningPeakFactor) << '\n';
+    }
     
     // 输出配送中心信息
-    std::cout << "配送中心数量: " << problem.centers.size() << "个" << std::endl;
+    std::cout << "配送中心数量: " << problem.centers.size() << "个" << '\n';
     for (const auto& center : problem.centers) {
         // 确定配送中心类型
         std::string centerType;
@@ -339,96 +627,220 @@ void printInitialInfo(const DeliveryProblem& problem) {
             if (i > 0) std::cout << ", ";
             std::cout << center.vehicles[i];
         }
-        std::cout << std::endl;
+        std::cout << '\n';
     }
     
     // 输出任务点信息
-    std::cout << "任务点数量: " << problem.tasks.size() << "个" << std::endl;
-    std::cout << "初始任务点数量: " << problem.initialDemandCount << "个" << std::endl;
+    std::cout << "任务点数量: " << problem.tasks.size() << "个" << '\n';
+    std::cout << "初始任务点数量: " << problem.initialDemandCount << "个" << '\n';
     for (size_t i = 0; i < problem.initialDemandCount; ++i) {
         const auto& task = problem.tasks[i];
         std::cout << "任务点坐标: (" << task.x << ", " << task.y << "), ID: " << task.id 
-                  << ", 取货重量: " << task.pickweight << ", 送货重量: " << task.sendWeight << std::endl;
+                  << ", 取货重量: " << task.pickweight << ", 送货重量: " << task.sendWeight << '\n';
     }
     
     // 输出额外任务点信息
     int extraCount = problem.tasks.size() - problem.initialDemandCount;
-    std::cout << "额外任务点数量: " << extraCount << "个" << std::endl;
+    std::cout << "额外任务点数量: " << extraCount << "个" << '\n';
     for (size_t i = problem.initialDemandCount; i < problem.tasks.size(); ++i) {
         const auto& task = problem.tasks[i];
         std::cout << "任务点坐标: (" << task.x << ", " << task.y << "), ID: " << task.id 
                   << ", 到达时间: " << task.arrivaltime << "h, 取货重量: " << task.pickweight 
-                  << ", 送货重量: " << task.sendWeight << std::endl;
+                  << ", 送货重量: " << task.sendWeight << '\n';
     }
     
-    std::cout << "========== 初始阶段信息结束 ==========" << std::endl;
+    std::cout << "========== 初始阶段信息结束 ==========" << '\n';
 }
 
-void Print_DeliveryResults(
+VehiclePlan buildVehiclePlan(const DeliveryProblem& problem, int vehicleId,
+                             const std::vector<int>& path, const std::vector<double>& completionTimes)
+{
+    const auto& vehicle = problem.vehicles[problem.vehicleIdToIndex.at(vehicleId)];
+    VehiclePlan vehiclePlan{vehicleId, vehicle.centerId, vehicle.maxLoad > 0, {}};
+    vehiclePlan.stops.reserve(path.size());
+    
+    // 区分配送中心和任务点还有车机协同的车辆任务点；只有一个时间的路径不记录时间
+    bool timed = completionTimes.size() >= 2;
+    for (size_t i = 0; i < path.size(); ++i) {
+        int pointId = path[i];
+        StopKind kind = problem.centerIds.count(pointId) > 0 ? StopKind::Center
+                      : pointId > 30000 ? StopKind::Collaboration : StopKind::Task;
+        double arrival = timed && i < completionTimes.size() ? completionTimes[i]
+                                                             : std::numeric_limits<double>::quiet_NaN();
+        vehiclePlan.stops.push_back({pointId, kind, arrival});
+    }
+    return vehiclePlan;
+}
+
+DeliveryPlan buildDeliveryPlan(
     const DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& allPaths)
 {
-    cout << "\n=== 具体配送路径与时间 ===" << endl;
-    double totalTaskCount = 0;
-    
+    DeliveryPlan plan;
     for (const auto& [vehicleId, pathData] : allPaths) {
         const auto& [path, completionTimes] = pathData;
         if (path.size() <= 2) continue;  // 跳过无任务的路径
         
-        // 查找车辆索引
-        int vehicleIndex = problem.vehicleIdToIndex.at(vehicleId);
-        const auto& vehicle = problem.vehicles[vehicleIndex];
-        
+        plan.vehicles.push_back(buildVehiclePlan(problem, vehicleId, path, completionTimes));
+        for (const auto& stop : plan.vehicles.back().stops) {
+            if (stop.kind == StopKind::Task) plan.taskCount++;
+        }
+    }
+    
+    // 计算总时间和成本
+    auto [totalTime, totalCost] = calculateTotalTimeAndCost(problem, allPaths);
+    plan.makespan = totalTime;
+    plan.cost = totalCost;
+    return plan;
+}
+
+// 文本输出中停靠点ID前的类型标记
+static const char* stopLabel(StopKind kind)
+{
+    switch (kind) {
+    case StopKind::Center: return "中心#";
+    case StopKind::Collaboration: return "协同点#";
+    case StopKind::Task: return "任务#";
+    }
+    return "任务#";
+}
+
+void printDeliveryPlan(const DeliveryProblem& problem, const DeliveryPlan& plan, Verbosity totalsLevel)
+{
+    cout << "\n=== 具体配送路径与时间 ===" << '\n';
+    
+    for (const auto& vehicle : plan.vehicles) {
+        const auto& stops = vehicle.stops;
         // 使用英文统一输出车辆类型
-        bool isDrone = (vehicle.maxLoad > 0);
-        cout << (isDrone ? "Drone" : "Car") << " #" << vehicleId << " 的路径: ";
+        cout << (vehicle.drone ? "Drone" : "Car") << " #" << vehicle.vehicleId << " 的路径: ";
         
         // 输出路径上的每个点
-        for (size_t i = 0; i < path.size(); ++i) {
-            int pointId = path[i];
-            
-            // 区分配送中心和任务点还有车机协同的车辆任务点
-            if (problem.centerIds.count(pointId) > 0) {
-                cout << "中心#" << pointId;
-            }
-            else if (pointId > 30000){
-                cout << "协同点#" << pointId;
-            }
-            else{
-                cout << "任务#" << pointId;
-                totalTaskCount++;
-            }
-            
-            if (i < path.size() - 1) {
+        for (size_t i = 0; i < stops.size(); ++i) {
+            cout << stopLabel(stops[i].kind) << stops[i].id;
+            if (i < stops.size() - 1) {
                 cout << " -> ";
             }
         }
-        cout << endl;
+        cout << '\n';
+
+        // 记录了下一跳时，展开车辆每段行程经过的路网节点
+        if (!vehicle.drone && !problem.network.nextHop.empty()) {
+            cout << "  路网节点: ";
+            int lastNode = -1;  // 相邻两段在路径点处衔接，衔接节点只输出一次
+            for (size_t i = 0; i + 1 < stops.size(); ++i) {
+                RoadLeg leg(problem.network, stops[i].id, stops[i + 1].id);
+                if (leg.empty()) {
+                    cout << (i > 0 ? " -> " : "") << "(" << stops[i].id << "->" << stops[i + 1].id << " 不可达)";
+                    lastNode = -1;
+                    continue;
+                }
+                for (int nodeId : leg) {
+                    if (nodeId == lastNode) continue;
+                    cout << (lastNode != -1 || i > 0 ? " -> " : "") << nodeId;
+                    lastNode = nodeId;
+                }
+            }
+            cout << '\n';
+        }
         
         // 打印完成时间
-        if (completionTimes.size() >= 2) {
+        if (!stops.empty() && !std::isnan(stops[0].arrival)) {
             cout << "  完成时间: ";
-            for (size_t i = 0; i < completionTimes.size(); ++i) {
-                cout << " " << completionTimes[i] << "h";
-                if (i < completionTimes.size() - 1) {
+            for (size_t i = 0; i < stops.size(); ++i) {
+                cout << " " << stops[i].arrival << "h";
+                if (i < stops.size() - 1) {
                     cout << ",";
                 }
             }
-            cout << endl;
+            cout << '\n';
         }
     }
     
-    cout << "\n总共配送任务数: " << totalTaskCount << endl;
+    std::ostream& totals = output(totalsLevel);
+    totals << "\n总共配送任务数: " << (double)plan.taskCount << '\n';  // 沿用原先按浮点数输出的格式
+    totals << "所有任务的最晚完成时间: " << plan.makespan << " 小时" << '\n';
+    totals << "总成本: " << plan.cost << " 元" << '\n';
+}
+
+PlanDiff diffDeliveryPlans(const DeliveryPlan &before, const DeliveryPlan &after)
+{
+    std::unordered_map<int, const VehiclePlan*> previous;
+    previous.reserve(before.vehicles.size());
+    for (const auto& vehicle : before.vehicles) previous[vehicle.vehicleId] = &vehicle;
     
-    // 计算总时间和成本
-    auto [totalTime, totalCost] = calculateTotalTimeAndCost(problem, allPaths);
-    cout << "所有任务的最晚完成时间: " << totalTime << " 小时" << endl;
-    cout << "总成本: " << totalCost << " 元" << endl;
+    PlanDiff diff;
+    for (const auto& vehicle : after.vehicles) {
+        const std::vector<PlanStop>* oldStops = nullptr;
+        auto it = previous.find(vehicle.vehicleId);
+        if (it != previous.end()) {
+            oldStops = &it->second->stops;
+            previous.erase(it);
+        }
+        
+        // 停靠点ID和类型都相同才算同一停靠点
+        size_t kept = 0;
+        size_t oldCount = oldStops ? oldStops->size() : 0;
+        while (kept < oldCount && kept < vehicle.stops.size()
+               && (*oldStops)[kept].id == vehicle.stops[kept].id && (*oldStops)[kept].kind == vehicle.stops[kept].kind) {
+            kept++;
+        }
+        if (oldStops && kept == oldCount && kept == vehicle.stops.size()) {
+            diff.unchangedCount++;
+            continue;
+        }
+        diff.changes.push_back({vehicle.vehicleId, vehicle.centerId, vehicle.drone, (int)kept, (int)(oldCount - kept),
+                                std::vector<PlanStop>(vehicle.stops.begin() + kept, vehicle.stops.end())});
+    }
+    
+    // 新方案中不再有任务的车辆：整条路线取消，按原方案顺序
+    for (const auto& vehicle : before.vehicles) {
+        if (previous.count(vehicle.vehicleId)) {
+            diff.changes.push_back({vehicle.vehicleId, vehicle.centerId, vehicle.drone, 0, (int)vehicle.stops.size(), {}});
+        }
+    }
+    return diff;
+}
+
+void printPlanDiff(const PlanDiff &diff)
+{
+    cout << "\n=== 静态到动态阶段的路线变化 ===" << '\n';
+    cout << "路线变化车辆数: " << diff.changes.size() << ", 路线不变车辆数: " << diff.unchangedCount << '\n';
+    for (const auto& change : diff.changes) {
+        cout << (change.drone ? "Drone" : "Car") << " #" << change.vehicleId;
+        if (change.suffix.empty()) {
+            if (change.keptStops == 0) {
+                cout << " 路线取消（原 " << change.removedStops << " 个停靠点）" << '\n';
+            } else {
+                cout << " 保留前 " << change.keptStops << " 个停靠点，删除其后 " << change.removedStops << " 个" << '\n';
+            }
+            continue;
+        }
+        if (change.keptStops == 0 && change.removedStops == 0) {
+            cout << " 新增路线: ";
+        } else {
+            cout << " 保留前 " << change.keptStops << " 个停靠点，替换其后 " << change.removedStops << " 个为: ";
+        }
+        for (size_t i = 0; i < change.suffix.size(); ++i) {
+            const PlanStop& stop = change.suffix[i];
+            cout << stopLabel(stop.kind) << stop.id;
+            if (!std::isnan(stop.arrival)) cout << "(" << stop.arrival << "h)";
+            if (i < change.suffix.size() - 1) cout << " -> ";
+        }
+        cout << '\n';
+    }
+}
+
+void Print_DeliveryResults(
+    const DeliveryProblem& problem,
+    const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& allPaths,
+    Verbosity totalsLevel)
+{
+    printDeliveryPlan(problem, buildDeliveryPlan(problem, allPaths), totalsLevel);
 }
 
 // 输出配送中心的车辆分配和任务分配情况
 void printCenterAssignments(const DeliveryProblem& problem) {
-    cout << "配送中心任务分配结果：" << endl;
+    cout << "配送中心任务分配结果：" << '\n';
     
     // 创建配送中心到车辆的映射
     std::unordered_map<int, std::vector<int>> centerToVehicles;
@@ -464,7 +876,7 @@ void printCenterAssignments(const DeliveryProblem& problem) {
             if (i > 0) cout << ", ";
             cout << centerToVehicles[center.id][i];
         }
-        cout << endl;
+        cout << '\n';
         
         // 输出任务分配情况
         auto tasksIt = problem.centerToTasks.find(center.id);
@@ -477,9 +889,9 @@ void printCenterAssignments(const DeliveryProblem& problem) {
             if (tasksIt->second.size() > 10) {
                 cout << "...";
             }
-            cout << endl;
+            cout << '\n';
         } else {
-            cout << "  没有分配任务" << endl;
+            cout << "  没有分配任务" << '\n';
         }
     }
 }
@@ -0,0 +1,470 @@
+#include "contraction_hierarchy.h"
+#include "parallel.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <utility>
+
+using std::vector;
+using std::pair;
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr int WITNESS_SETTLE_LIMIT = 100;   // 见证搜索最多确定的节点数，超出则保守地添加捷径
+constexpr uint32_t CH_FILE_MAGIC = 0x48435256;  // "VRCH"
+constexpr uint32_t CH_FILE_VERSION = 1;
+
+struct Arc
+{
+    int to;
+    double length;
+};
+
+struct Shortcut
+{
+    int from, to;
+    double length;
+};
+
+// 见证搜索使用的线程局部临时数组，只重置被访问过的节点
+struct WitnessScratch
+{
+    vector<double> dist;
+    vector<int> isTarget;       // 节点在当前被收缩节点邻居列表中的位置，-1表示不是邻居
+    vector<int> touched;
+    vector<pair<double, int>> heap;
+
+    void prepare(int nodeCount) {
+        if ((int)dist.size() != nodeCount) {
+            dist.assign(nodeCount, INF);
+            isTarget.assign(nodeCount, -1);
+        }
+    }
+    void reset() {
+        for (int v : touched) dist[v] = INF;
+        touched.clear();
+        heap.clear();
+    }
+};
+
+// 模拟收缩节点v：对v的每对相邻节点(u, x)做见证搜索，
+// 若不经过v和excluded节点时找不到不长于 u-v-x 的路径，则需要捷径边
+void findShortcuts(const vector<vector<Arc>> &adj, int v, const vector<char> &excluded,
+                   vector<Shortcut> &shortcuts)
+{
+    shortcuts.clear();
+    thread_local WitnessScratch scratch;
+    scratch.prepare(adj.size());
+    auto cmp = std::greater<pair<double, int>>();
+
+    thread_local vector<Arc> neighbors;
+    neighbors.clear();
+    double maxOut = 0.0;
+    for (const Arc& arc : adj[v]) {
+        if (excluded[arc.to] || arc.to == v) continue;
+        neighbors.push_back(arc);
+        maxOut = std::max(maxOut, arc.length);
+    }
+
+    for (size_t i = 0; i < neighbors.size(); i++) scratch.isTarget[neighbors[i].to] = i;
+
+    for (size_t a = 0; a + 1 < neighbors.size(); a++) {
+        int source = neighbors[a].to;
+        double limit = neighbors[a].length + maxOut;
+
+        // 从source出发的受限Dijkstra
+        scratch.dist[source] = 0.0;
+        scratch.touched.push_back(source);
+        scratch.heap.push_back({0.0, source});
+        int settled = 0;
+        int targetsLeft = neighbors.size() - a - 1;
+        while (!scratch.heap.empty() && settled < WITNESS_SETTLE_LIMIT && targetsLeft > 0) {
+            std::pop_heap(scratch.heap.begin(), scratch.heap.end(), cmp);
+            auto [d, u] = scratch.heap.back();
+            scratch.heap.pop_back();
+            if (d > scratch.dist[u]) continue;
+            if (d > limit) break;
+            settled++;
+            if (scratch.isTarget[u] > (int)a) targetsLeft--;  // 剩余的相邻节点都已确定即可结束
+            for (const Arc& arc : adj[u]) {
+                if (arc.to == v || excluded[arc.to]) continue;
+                double nd = d + arc.length;
+                if (nd < scratch.dist[arc.to]) {
+                    if (scratch.dist[arc.to] == INF) scratch.touched.push_back(arc.to);
+                    scratch.dist[arc.to] = nd;
+                    scratch.heap.push_back({nd, arc.to});
+                    std::push_heap(scratch.heap.begin(), scratch.heap.end(), cmp);
+                }
+            }
+        }
+
+        for (size_t b = a + 1; b < neighbors.size(); b++) {
+            double viaV = neighbors[a].length + neighbors[b].length;
+            if (scratch.dist[neighbors[b].to] > viaV) {
+                shortcuts.push_back({source, neighbors[b].to, viaV});
+            }
+        }
+        scratch.reset();
+    }
+    for (const Arc& arc : neighbors) scratch.isTarget[arc.to] = -1;
+}
+
+// 在邻接表中插入或缩短一条无向边
+void addOrShorten(vector<vector<Arc>> &adj, int u, int v, double length)
+{
+    for (Arc& arc : adj[u]) {
+        if (arc.to == v) {
+            arc.length = std::min(arc.length, length);
+            return;
+        }
+    }
+    adj[u].push_back({v, length});
+}
+
+void removeArc(vector<Arc> &arcs, int to)
+{
+    for (size_t i = 0; i < arcs.size(); i++) {
+        if (arcs[i].to == to) {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
+
+// CH查询使用的线程局部临时数组，用时间戳代替每次查询的全量重置
+struct QueryScratch
+{
+    const ContractionHierarchy* owner = nullptr;
+    vector<double> dist[2];
+    vector<unsigned int> stamp[2];
+    unsigned int current = 0;
+    vector<pair<double, int>> heap[2];
+
+    void prepare(const ContractionHierarchy &ch) {
+        if (owner != &ch || (int)dist[0].size() != ch.nodeCount) {
+            owner = &ch;
+            for (int side = 0; side < 2; side++) {
+                dist[side].assign(ch.nodeCount, INF);
+                stamp[side].assign(ch.nodeCount, 0);
+            }
+            current = 0;
+        }
+        if (++current == 0) {  // 时间戳回绕时全部清零
+            for (int side = 0; side < 2; side++) stamp[side].assign(ch.nodeCount, 0);
+            current = 1;
+        }
+        heap[0].clear();
+        heap[1].clear();
+    }
+    double get(int side, int v) const {
+        return stamp[side][v] == current ? dist[side][v] : INF;
+    }
+    void set(int side, int v, double d) {
+        stamp[side][v] = current;
+        dist[side][v] = d;
+    }
+};
+
+template <typename T>
+void writeArray(std::ofstream &out, const vector<T> &data)
+{
+    out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+
+template <typename T>
+bool readArray(std::ifstream &in, vector<T> &data, size_t count)
+{
+    data.resize(count);
+    in.read(reinterpret_cast<char*>(data.data()), count * sizeof(T));
+    return bool(in);
+}
+
+} // namespace
+
+// 构建收缩层次
+ContractionHierarchy buildContractionHierarchy(const CsrGraph &graph, int threadCount)
+{
+    int n = graph.nodeCount;
+    vector<vector<Arc>> adj(n);
+    for (int u = 0; u < n; u++) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            adj[u].push_back({graph.targets[e], graph.weights[e]});
+        }
+    }
+
+    vector<char> contracted(n, 0);
+    vector<int> deletedNeighbors(n, 0);
+    vector<int> level(n, 0);
+    vector<int> priority(n, 0);
+    vector<int> rank(n, -1);
+    vector<vector<Arc>> upward(n);
+
+    // 优先级 = 2 * 边差（添加的捷径数 - 删除的边数） + 已收缩的相邻节点数 + 层级
+    auto computePriority = [&](int v) {
+        thread_local vector<Shortcut> shortcuts;
+        findShortcuts(adj, v, contracted, shortcuts);
+        int degree = 0;
+        for (const Arc& arc : adj[v]) {
+            if (!contracted[arc.to]) degree++;
+        }
+        priority[v] = 2 * ((int)shortcuts.size() - degree) + deletedNeighbors[v] + level[v];
+    };
+    parallelFor(0, n, threadCount, computePriority);
+
+    vector<int> remaining(n);
+    for (int v = 0; v < n; v++) remaining[v] = v;
+    vector<char> selected(n, 0);
+    vector<char> excluded(n, 0);
+    int nextRank = 0;
+
+    while (!remaining.empty()) {
+        // 选出优先级在相邻未收缩节点中严格最小的节点，这些节点两两不相邻
+        vector<int> batch;
+        for (int v : remaining) {
+            bool isLocalMin = true;
+            for (const Arc& arc : adj[v]) {
+                int u = arc.to;
+                if (contracted[u]) continue;
+                if (priority[u] < priority[v] || (priority[u] == priority[v] && u < v)) {
+                    isLocalMin = false;
+                    break;
+                }
+            }
+            if (isLocalMin) {
+                batch.push_back(v);
+                selected[v] = 1;
+            }
+        }
+
+        // 并行见证搜索：同一轮要收缩的节点都不能作为见证路径的中间点
+        for (int v = 0; v < n; v++) excluded[v] = contracted[v] | selected[v];
+        vector<vector<Shortcut>> batchShortcuts(batch.size());
+        parallelFor(0, batch.size(), threadCount, [&](int i) {
+            findShortcuts(adj, batch[i], excluded, batchShortcuts[i]);
+        });
+
+        // 顺序收缩：记录向上边，删除节点并加入捷径
+        vector<int> affected;
+        for (size_t i = 0; i < batch.size(); i++) {
+            int v = batch[i];
+            rank[v] = nextRank++;
+            for (const Arc& arc : adj[v]) {
+                if (contracted[arc.to]) continue;
+                upward[v].push_back(arc);
+                removeArc(adj[arc.to], v);
+                deletedNeighbors[arc.to]++;
+                level[arc.to] = std::max(level[arc.to], level[v] + 1);
+                affected.push_back(arc.to);
+            }
+            contracted[v] = 1;
+            selected[v] = 0;
+            adj[v].clear();
+            adj[v].shrink_to_fit();
+            for (const Shortcut& s : batchShortcuts[i]) {
+                addOrShorten(adj, s.from, s.to, s.length);
+                addOrShorten(adj, s.to, s.from, s.length);
+            }
+        }
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                       [&](int v) { return contracted[v]; }),
+                        remaining.end());
+
+        // 并行更新受影响节点的优先级
+        std::sort(affected.begin(), affected.end());
+        affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+        parallelFor(0, affected.size(), threadCount, [&](int i) { computePriority(affected[i]); });
+    }
+
+    ContractionHierarchy ch;
+    ch.nodeCount = n;
+    ch.nodeIds = graph.nodeIds;
+    ch.nodeIndex = graph.nodeIndex;
+    ch.rank = rank;
+    ch.upOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        ch.upOffsets[v + 1] = ch.upOffsets[v] + upward[v].size();
+    }
+    ch.upTargets.reserve(ch.upOffsets[n]);
+    ch.upWeights.reserve(ch.upOffsets[n]);
+    for (int v = 0; v < n; v++) {
+        for (const Arc& arc : upward[v]) {
+            ch.upTargets.push_back(arc.to);
+            ch.upWeights.push_back(arc.length);
+        }
+    }
+    return ch;
+}
+
+// 双向CH查询
+double queryContractionHierarchy(const ContractionHierarchy &ch, int sourceNodeId, int targetNodeId)
+{
+    int source = ch.indexOf(sourceNodeId);
+    int target = ch.indexOf(targetNodeId);
+    if (source < 0 || target < 0) return INF;
+    if (source == target) return 0.0;
+
+    thread_local QueryScratch scratch;
+    scratch.prepare(ch);
+    auto cmp = std::greater<pair<double, int>>();
+
+    scratch.set(0, source, 0.0);
+    scratch.heap[0].push_back({0.0, source});
+    scratch.set(1, target, 0.0);
+    scratch.heap[1].push_back({0.0, target});
+    double best = INF;
+
+    while (true) {
+        double minKey[2];
+        for (int side = 0; side < 2; side++) {
+            minKey[side] = scratch.heap[side].empty() ? INF : scratch.heap[side].front().first;
+        }
+        if (std::min(minKey[0], minKey[1]) >= best) break;
+
+        // 交替推进键值较小的一侧
+        int side = minKey[0] <= minKey[1] ? 0 : 1;
+        auto& heap = scratch.heap[side];
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        auto [d, u] = heap.back();
+        heap.pop_back();
+        if (d > scratch.get(side, u)) continue;
+
+        best = std::min(best, d + scratch.get(1 - side, u));
+
+        // 按需停滞（stall-on-demand）：若能从更高层节点以更短距离到达u，则u不会在最短路上，不再扩展
+        bool stalled = false;
+        for (int e = ch.upOffsets[u]; e < ch.upOffsets[u + 1]; e++) {
+            if (scratch.get(side, ch.upTargets[e]) + ch.upWeights[e] < d) {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled) continue;
+
+        for (int e = ch.upOffsets[u]; e < ch.upOffsets[u + 1]; e++) {
+            int v = ch.upTargets[e];
+            double nd = d + ch.upWeights[e];
+            if (nd < scratch.get(side, v)) {
+                scratch.set(side, v, nd);
+                heap.push_back({nd, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+    return best;
+}
+
+// 建立终端查询缓存
+void attachTerminalMemo(ContractionHierarchy &ch, const std::vector<int> &terminalNodeIds)
+{
+    ch.terminalSlot.assign(ch.nodeCount, -1);
+    ch.terminalCount = 0;
+    for (int nodeId : terminalNodeIds) {
+        int v = ch.indexOf(nodeId);
+        if (v >= 0 && ch.terminalSlot[v] < 0) ch.terminalSlot[v] = ch.terminalCount++;
+    }
+    size_t size = (size_t)ch.terminalCount * ch.terminalCount;
+    ch.terminalMemo.reset(new std::atomic<double>[size]);
+    for (size_t i = 0; i < size; i++) ch.terminalMemo[i].store(-1.0, std::memory_order_relaxed);
+}
+
+// 带终端缓存的距离查询
+double hierarchyDistance(const ContractionHierarchy &ch, int sourceNodeId, int targetNodeId)
+{
+    int source = ch.indexOf(sourceNodeId);
+    int target = ch.indexOf(targetNodeId);
+    if (source < 0 || target < 0 || !ch.terminalMemo) {
+        return queryContractionHierarchy(ch, sourceNodeId, targetNodeId);
+    }
+    int a = ch.terminalSlot[source], b = ch.terminalSlot[target];
+    if (a < 0 || b < 0) {
+        return queryContractionHierarchy(ch, sourceNodeId, targetNodeId);
+    }
+
+    // 多个线程可能同时计算同一点对，结果相同，重复写入无害
+    std::atomic<double>& cell = ch.terminalMemo[(size_t)a * ch.terminalCount + b];
+    double cached = cell.load(std::memory_order_relaxed);
+    if (cached >= 0.0) return cached;
+    double distance = queryContractionHierarchy(ch, sourceNodeId, targetNodeId);
+    cell.store(distance, std::memory_order_relaxed);
+    ch.terminalMemo[(size_t)b * ch.terminalCount + a].store(distance, std::memory_order_relaxed);
+    return distance;
+}
+
+// 保存收缩层次
+bool saveContractionHierarchy(const ContractionHierarchy &ch, const std::string &path)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    int32_t header[3] = {ch.nodeCount, (int32_t)ch.nodeIndex.size(), (int32_t)ch.upTargets.size()};
+    out.write(reinterpret_cast<const char*>(&CH_FILE_MAGIC), sizeof(CH_FILE_MAGIC));
+    out.write(reinterpret_cast<const char*>(&CH_FILE_VERSION), sizeof(CH_FILE_VERSION));
+    out.write(reinterpret_cast<const char*>(&ch.edgeHash), sizeof(ch.edgeHash));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(out, ch.nodeIds);
+    writeArray(out, ch.rank);
+    writeArray(out, ch.upOffsets);
+    writeArray(out, ch.upTargets);
+    writeArray(out, ch.upWeights);
+    return bool(out);
+}
+
+// 加载收缩层次，文件不存在、格式不符、边列表哈希不一致或内容损坏（长度/下标越界）时返回false
+bool loadContractionHierarchy(const std::string &path, uint64_t expectedEdgeHash, ContractionHierarchy &ch)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0;
+    uint64_t edgeHash = 0;
+    int32_t header[3] = {0, 0, 0};
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&edgeHash), sizeof(edgeHash));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || magic != CH_FILE_MAGIC || version != CH_FILE_VERSION || edgeHash != expectedEdgeHash) {
+        return false;
+    }
+
+    // 各数组长度由头部给出，先核对不为负且不超过文件剩余长度，避免按损坏的长度分配内存
+    if (header[0] < 0 || header[1] < 0 || header[2] < 0) return false;
+    std::streampos dataStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    uint64_t remaining = (uint64_t)(in.tellg() - dataStart);
+    in.seekg(dataStart);
+    uint64_t n = header[0], m = header[2];
+    uint64_t expected = (3 * n + 1 + m) * sizeof(int32_t) + m * sizeof(double);
+    if (!in || remaining < expected) return false;
+
+    ContractionHierarchy loaded;
+    loaded.nodeCount = header[0];
+    loaded.edgeHash = edgeHash;
+    if (!readArray(in, loaded.nodeIds, n) ||
+        !readArray(in, loaded.rank, n) ||
+        !readArray(in, loaded.upOffsets, n + 1) ||
+        !readArray(in, loaded.upTargets, m) ||
+        !readArray(in, loaded.upWeights, m)) {
+        return false;
+    }
+
+    // 查询直接按下标访问，节点ID、边区间和边终点必须在范围内
+    if (loaded.upOffsets[0] != 0 || loaded.upOffsets[n] != header[2]) return false;
+    for (uint64_t i = 0; i < n; i++) {
+        if (loaded.upOffsets[i] > loaded.upOffsets[i + 1]) return false;
+    }
+    for (int target : loaded.upTargets) {
+        if (target < 0 || target >= loaded.nodeCount) return false;
+    }
+    loaded.nodeIndex.assign(header[1], -1);
+    for (int i = 0; i < loaded.nodeCount; i++) {
+        int nodeId = loaded.nodeIds[i];
+        if (nodeId < 0 || nodeId >= header[1]) return false;
+        loaded.nodeIndex[nodeId] = i;
+    }
+    ch = std::move(loaded);
+    return true;
+}
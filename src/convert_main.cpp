@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "common.h"
+#include "instance_file.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+
+// 文本输入转换为二进制实例：delivery_convert <input_file> <output_file> [--matrix=floyd|blocked|dijkstra] [--threads=N]
+// 指定--matrix时按该方式计算距离矩阵并一并写入，加载时直接映射
+int main(int argc, char* argv[])
+{
+    string input, output;
+    DeliveryProblem problem;
+    problem.config.apspMethod = ApspMethod::Lazy;  // 不写矩阵时无需计算最短路
+    bool includeMatrix = false;
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--matrix=", 0) == 0) {
+            string method = arg.substr(9);
+            includeMatrix = true;
+            if (method == "floyd") {
+                problem.config.apspMethod = ApspMethod::Floyd;
+            } else if (method == "blocked") {
+                problem.config.apspMethod = ApspMethod::Blocked;
+            } else if (method == "dijkstra") {
+                problem.config.apspMethod = ApspMethod::Dijkstra;
+            } else {
+                std::cerr << "未知的最短路算法: " << method << endl;
+                valid = false;
+            }
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            problem.config.threadCount = std::atoi(arg.c_str() + 10);
+            valid = valid && problem.config.threadCount > 0;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "未知参数: " << arg << endl;
+            valid = false;
+        } else if (input.empty()) {
+            input = arg;
+        } else if (output.empty()) {
+            output = arg;
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || input.empty() || output.empty()) {
+        cout << "Usage: " << argv[0] << " <input_file> <output_file> [--matrix=floyd|blocked|dijkstra] [--threads=N]" << endl;
+        cout << "Example: " << argv[0] << " ../test/output_data_weighted.txt instance.bin --matrix=dijkstra" << endl;
+        return 1;
+    }
+
+    std::vector<EdgePeakFactor> factorLines;
+    if (!loadProblemData(input, problem, &factorLines)) {
+        cout << "加载数据失败，程序退出。" << endl;
+        return 1;
+    }
+    if (!saveInstanceFile(output, problem, factorLines, includeMatrix)) {
+        std::cerr << "无法写入二进制实例: " << output << endl;
+        return 1;
+    }
+    cout << "已写入二进制实例: " << output << (includeMatrix ? "（含距离矩阵）" : "") << endl;
+    return 0;
+}
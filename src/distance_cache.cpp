@@ -0,0 +1,113 @@
+#include "distance_cache.h"
+#include "mapped_file.h"
+#include "shortest_path.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+constexpr uint32_t DISTANCE_CACHE_MAGIC = 0x4d445256;  // "VRDM"
+constexpr uint32_t DISTANCE_CACHE_VERSION = 1;
+constexpr uint64_t DISTANCE_CACHE_ALIGN = 64;          // 矩阵起始偏移按缓存行对齐
+
+struct DistanceCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    int32_t nodeCount;
+    int32_t nodeIndexSize;     // 节点ID上界+1，用于重建 nodeIndex
+    uint64_t matrixOffset;     // 矩阵相对文件起始的字节偏移
+};
+
+// 在FNV-1a哈希上继续混入数据
+static void mixHash(uint64_t &hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+uint64_t distanceCacheKey(const DeliveryProblem &problem)
+{
+    uint64_t key = hashEdgeList(problem.network.edges);
+    // Floyd与分块Floyd得到同一张全节点矩阵，共用缓存；Dijkstra只含终端节点
+    uint32_t terminalOnly = problem.config.apspMethod == ApspMethod::Dijkstra ? 1 : 0;
+    mixHash(key, &terminalOnly, sizeof(terminalOnly));
+    if (terminalOnly) {
+        for (int nodeId : collectTerminalNodes(problem)) {
+            mixHash(key, &nodeId, sizeof(nodeId));
+        }
+    } else {
+        uint32_t hilbert = problem.config.hilbertOrder ? 1 : 0;  // 全节点矩阵的节点顺序
+        mixHash(key, &hilbert, sizeof(hilbert));
+    }
+    return key;
+}
+
+std::string distanceCachePath(const std::string &dir, uint64_t key)
+{
+    char name[40];
+    snprintf(name, sizeof(name), "distances_%016llx.bin", (unsigned long long)key);
+    return dir.empty() ? std::string(name) : dir + "/" + name;
+}
+
+bool loadDistanceCache(const std::string &path, uint64_t key, RouteNetwork &network)
+{
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(DistanceCacheHeader)) return false;
+
+    DistanceCacheHeader header;
+    memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != DISTANCE_CACHE_MAGIC || header.version != DISTANCE_CACHE_VERSION ||
+        header.key != key || header.nodeCount < 0 || header.nodeIndexSize < 0) {
+        return false;
+    }
+    size_t n = header.nodeCount;
+    size_t idsEnd = sizeof(header) + n * sizeof(int32_t);
+    if (header.matrixOffset < idsEnd || header.matrixOffset % DISTANCE_CACHE_ALIGN != 0 ||
+        file->size() < header.matrixOffset + n * n * sizeof(double)) {
+        return false;
+    }
+
+    std::vector<int> nodeIds(n);
+    memcpy(nodeIds.data(), file->data() + sizeof(header), n * sizeof(int32_t));
+    std::vector<int> nodeIndex(header.nodeIndexSize, -1);
+    for (size_t i = 0; i < n; i++) {
+        if (nodeIds[i] < 0 || nodeIds[i] >= header.nodeIndexSize) return false;
+        nodeIndex[nodeIds[i]] = i;
+    }
+
+    network.nodeCount = n;
+    network.nodeIds = std::move(nodeIds);
+    network.nodeIndex = std::move(nodeIndex);
+    network.distMatrix.clear();
+    network.distMatrix.shrink_to_fit();
+    network.mappedMatrix = reinterpret_cast<const double*>(file->data() + header.matrixOffset);
+    network.matrixFile = file;
+    return true;
+}
+
+bool saveDistanceCache(const std::string &path, uint64_t key, const RouteNetwork &network)
+{
+    size_t n = network.nodeCount;
+    DistanceCacheHeader header = {};
+    header.magic = DISTANCE_CACHE_MAGIC;
+    header.version = DISTANCE_CACHE_VERSION;
+    header.key = key;
+    header.nodeCount = n;
+    header.nodeIndexSize = network.nodeIndex.size();
+    uint64_t idsEnd = sizeof(header) + n * sizeof(int32_t);
+    header.matrixOffset = (idsEnd + DISTANCE_CACHE_ALIGN - 1) / DISTANCE_CACHE_ALIGN * DISTANCE_CACHE_ALIGN;
+
+    // 多个进程可能同时写同一缓存
+    return writeFileAtomically(path, [&](std::ofstream &out) {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(network.nodeIds.data()), n * sizeof(int32_t));
+        static const char padding[DISTANCE_CACHE_ALIGN] = {};
+        out.write(padding, header.matrixOffset - idsEnd);
+        const double* matrix = network.mappedMatrix ? network.mappedMatrix : network.distMatrix.data();
+        out.write(reinterpret_cast<const char*>(matrix), n * n * sizeof(double));
+    });
+}
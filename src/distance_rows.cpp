@@ -0,0 +1,68 @@
+#include "distance_rows.h"
+#include "shortest_path.h"
+#include <algorithm>
+#include <limits>
+
+LazyDistanceRows::LazyDistanceRows(CsrGraph graph, size_t byteLimit)
+    : graph(std::move(graph)), byteLimit(byteLimit)
+{
+    size_t bytesPerRow = std::max<size_t>(rowBytes(), 1);
+    capacityRows = std::max<size_t>(byteLimit / bytesPerRow, 1);
+    rows.resize(this->graph.nodeCount);
+    position.resize(this->graph.nodeCount, recentSources.end());
+    counters.capacityRows = capacityRows;
+}
+
+double LazyDistanceRows::distance(int sourceNodeId, int targetNodeId)
+{
+    int u = graph.indexOf(sourceNodeId);
+    int v = graph.indexOf(targetNodeId);
+    if (u < 0 || v < 0) return std::numeric_limits<double>::infinity();
+    if (u == v) return 0.0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // 任一端的行已缓存即可直接读取，并移到LRU表头
+    for (auto [row, column] : {std::pair<int, int>{u, v}, {v, u}}) {
+        if (!rows[row].empty()) {
+            counters.hits++;
+            recentSources.splice(recentSources.begin(), recentSources, position[row]);
+            return rows[row][column];
+        }
+    }
+
+    // 未命中：以查询的第一个节点为源点计算新行，超出上限时淘汰最久未使用的行并复用其内存
+    counters.misses++;
+    std::vector<double> buffer;
+    if (recentSources.size() >= capacityRows) {
+        int victim = recentSources.back();
+        recentSources.pop_back();
+        position[victim] = recentSources.end();
+        buffer.swap(rows[victim]);
+        counters.evictions++;
+    }
+    dijkstra(graph, u, buffer);
+    rows[u].swap(buffer);
+    recentSources.push_front(u);
+    position[u] = recentSources.begin();
+    return rows[u][v];
+}
+
+void LazyDistanceRows::reset(CsrGraph graph)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->graph = std::move(graph);
+    capacityRows = std::max<size_t>(byteLimit / std::max<size_t>(rowBytes(), 1), 1);
+    counters.capacityRows = capacityRows;
+    rows.assign(this->graph.nodeCount, std::vector<double>());
+    recentSources.clear();
+    position.assign(this->graph.nodeCount, recentSources.end());
+}
+
+DistanceRowStats LazyDistanceRows::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    DistanceRowStats result = counters;
+    result.cachedRows = recentSources.size();
+    return result;
+}
@@ -0,0 +1,135 @@
+#include "drone_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DRONE_KERNEL_X86 1
+#endif
+
+static void scanScalar(const DroneCandidates &c, const DroneScanState &s, size_t begin,
+                       double* distance, uint8_t* status)
+{
+    for (size_t i = begin; i < c.size(); i++) {
+        status[i] = droneCandidateStatus(c, s, i, distance[i]);
+    }
+}
+
+#ifdef DRONE_KERNEL_X86
+
+// 由两个比较结果的位掩码写出每个候选点的状态：可访问时能返回为1、不能返回为2，不用分支（可行性随机分布时分支难以预测）
+static inline void writeStatus(int feasibleBits, int returnBits, int lanes, uint8_t* status)
+{
+    for (int lane = 0; lane < lanes; lane++) {
+        status[lane] = (feasibleBits >> lane & 1) * (2 - (returnBits >> lane & 1));
+    }
+}
+
+static void scanSse2(const DroneCandidates &c, const DroneScanState &s, double* distance, uint8_t* status)
+{
+    const __m128d fromX = _mm_set1_pd(s.fromX), fromY = _mm_set1_pd(s.fromY);
+    const __m128d speed = _mm_set1_pd(s.speed), battery = _mm_set1_pd(s.battery);
+    const __m128d minBattery = _mm_set1_pd(s.minBattery), time = _mm_set1_pd(s.time);
+    const __m128d load = _mm_set1_pd(s.load), processLoad = _mm_set1_pd(s.maxProcessLoad);
+    const __m128d maxLoad = _mm_set1_pd(s.maxLoad), slack = _mm_set1_pd(0.000001), zero = _mm_setzero_pd();
+
+    size_t n = c.size(), i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(&c.x[i]), fromX);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(&c.y[i]), fromY);
+        __m128d d = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+        __m128d toTask = _mm_div_pd(d, speed);
+        __m128d send = _mm_loadu_pd(&c.sendWeight[i]);
+        __m128d pick = _mm_loadu_pd(&c.pickWeight[i]);
+
+        __m128d ok = _mm_or_pd(_mm_cmpngt_pd(send, zero), _mm_cmpngt_pd(_mm_add_pd(processLoad, send), maxLoad));
+        ok = _mm_and_pd(ok, _mm_or_pd(_mm_cmpngt_pd(pick, zero), _mm_cmpngt_pd(_mm_add_pd(load, pick), maxLoad)));
+        ok = _mm_and_pd(ok, _mm_cmpnlt_pd(_mm_add_pd(_mm_add_pd(time, toTask), slack), _mm_loadu_pd(&c.readyTime[i])));
+        ok = _mm_and_pd(ok, _mm_cmpngt_pd(toTask, battery));
+        ok = _mm_and_pd(ok, _mm_cmpnlt_pd(_mm_sub_pd(battery, toTask), minBattery));
+        __m128d back = _mm_cmple_pd(_mm_add_pd(toTask, _mm_loadu_pd(&c.returnTime[i])), battery);
+
+        _mm_storeu_pd(&distance[i], d);
+        writeStatus(_mm_movemask_pd(ok), _mm_movemask_pd(back), 2, &status[i]);
+    }
+    scanScalar(c, s, i, distance, status);
+}
+
+__attribute__((target("avx2")))
+static void scanAvx2(const DroneCandidates &c, const DroneScanState &s, double* distance, uint8_t* status)
+{
+    const __m256d fromX = _mm256_set1_pd(s.fromX), fromY = _mm256_set1_pd(s.fromY);
+    const __m256d speed = _mm256_set1_pd(s.speed), battery = _mm256_set1_pd(s.battery);
+    const __m256d minBattery = _mm256_set1_pd(s.minBattery), time = _mm256_set1_pd(s.time);
+    const __m256d load = _mm256_set1_pd(s.load), processLoad = _mm256_set1_pd(s.maxProcessLoad);
+    const __m256d maxLoad = _mm256_set1_pd(s.maxLoad), slack = _mm256_set1_pd(0.000001);
+    const __m256d zero = _mm256_setzero_pd();
+
+    size_t n = c.size(), i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&c.x[i]), fromX);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&c.y[i]), fromY);
+        // 乘加分开计算（不启用FMA），舍入与标量代码一致
+        __m256d d = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        __m256d toTask = _mm256_div_pd(d, speed);
+        __m256d send = _mm256_loadu_pd(&c.sendWeight[i]);
+        __m256d pick = _mm256_loadu_pd(&c.pickWeight[i]);
+
+        __m256d ok = _mm256_or_pd(_mm256_cmp_pd(send, zero, _CMP_NGT_UQ),
+                                  _mm256_cmp_pd(_mm256_add_pd(processLoad, send), maxLoad, _CMP_NGT_UQ));
+        ok = _mm256_and_pd(ok, _mm256_or_pd(_mm256_cmp_pd(pick, zero, _CMP_NGT_UQ),
+                                            _mm256_cmp_pd(_mm256_add_pd(load, pick), maxLoad, _CMP_NGT_UQ)));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_add_pd(_mm256_add_pd(time, toTask), slack),
+                                             _mm256_loadu_pd(&c.readyTime[i]), _CMP_NLT_UQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(toTask, battery, _CMP_NGT_UQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_sub_pd(battery, toTask), minBattery, _CMP_NLT_UQ));
+        __m256d back = _mm256_cmp_pd(_mm256_add_pd(toTask, _mm256_loadu_pd(&c.returnTime[i])), battery, _CMP_LE_OQ);
+
+        _mm256_storeu_pd(&distance[i], d);
+        writeStatus(_mm256_movemask_pd(ok), _mm256_movemask_pd(back), 4, &status[i]);
+    }
+    scanScalar(c, s, i, distance, status);
+}
+
+#endif // DRONE_KERNEL_X86
+
+DroneKernel activeDroneKernel()
+{
+#ifdef DRONE_KERNEL_X86
+    static const DroneKernel kernel = __builtin_cpu_supports("avx2") ? DroneKernel::Avx2
+                                    : __builtin_cpu_supports("sse2") ? DroneKernel::Sse2 : DroneKernel::Scalar;
+    return kernel;
+#else
+    return DroneKernel::Scalar;
+#endif
+}
+
+const char* droneKernelName(DroneKernel kernel)
+{
+    switch (kernel) {
+    case DroneKernel::Avx2: return "AVX2";
+    case DroneKernel::Sse2: return "SSE2";
+    default: return "标量";
+    }
+}
+
+void scanDroneCandidates(const DroneCandidates &candidates, const DroneScanState &state,
+                         double* distance, uint8_t* status)
+{
+    scanDroneCandidates(candidates, state, distance, status, activeDroneKernel());
+}
+
+void scanDroneCandidates(const DroneCandidates &candidates, const DroneScanState &state,
+                         double* distance, uint8_t* status, DroneKernel kernel)
+{
+#ifdef DRONE_KERNEL_X86
+    DroneKernel available = activeDroneKernel();
+    if (kernel == DroneKernel::Avx2 && available == DroneKernel::Avx2) {
+        scanAvx2(candidates, state, distance, status);
+        return;
+    }
+    if (kernel != DroneKernel::Scalar && available != DroneKernel::Scalar) {
+        scanSse2(candidates, state, distance, status);
+        return;
+    }
+#endif
+    scanScalar(candidates, state, 0, distance, status);
+}
@@ -26,12 +26,14 @@ double calculateDynamicFitness(
     double timeWeight,
     double staticMaxTime)
 {
+    TrafficPin traffic(problem);  // 一次适应度计算内各路线使用同一版交通系数
     static int callCount = 0;
     callCount++;
 
-    // 每1000次调用输出一次状态
-    if (callCount % 1000 == 0) {
-        std::cout << "适应度计算次数: " << callCount << std::endl;
+    // 每1000次调用检查一次，进度行限速输出，只有真正输出时才刷新
+    static ProgressThrottle progress;
+    if (callCount % 1000 == 0 && progress.ready()) {
+        std::cout << "适应度计算次数: " << callCount << '\n' << std::flush;
     }
 
     // 使用映射检查车辆ID有效性
@@ -178,10 +180,11 @@ vector<pair<int, int>> dynamicGeneticAlgorithm(
     while (population.size() < populationSize && attempts < maxAttempts) {
         attempts++;
         
-        // 每100次尝试输出进度
-        if (attempts % 100 == 0) {
+        // 每100次尝试检查一次，进度行限速输出
+        static ProgressThrottle progress;
+        if (attempts % 100 == 0 && progress.ready()) {
             std::cout << "正在生成初始种群，当前尝试: " << attempts 
-                      << ", 成功: " << population.size() << "/" << populationSize << std::endl;
+                      << ", 成功: " << population.size() << "/" << populationSize << '\n' << std::flush;
         }
         
         vector<int> solution(allTaskIds.size());  // 存储车辆ID
@@ -214,7 +217,7 @@ vector<pair<int, int>> dynamicGeneticAlgorithm(
     }
     
     if (population.empty()) {
-        cout << "无法生成有效的初始种群" << endl;
+        cout << "无法生成有效的初始种群" << '\n';
         return {};
     }
     
@@ -0,0 +1,141 @@
+#include "hilbert_order.h"
+#include "shortest_path.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+uint64_t hilbertIndex(uint32_t x, uint32_t y, int order)
+{
+    uint64_t index = 0;
+    for (uint32_t s = 1u << (order - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        index += (uint64_t)s * s * ((3 * rx) ^ ry);
+        // 旋转象限，使子曲线首尾相接
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+        x &= s - 1;
+        y &= s - 1;
+    }
+    return index;
+}
+
+std::vector<uint64_t> hilbertKeys(const std::vector<std::pair<double, double>> &points)
+{
+    std::vector<uint64_t> keys(points.size(), 0);
+    if (points.empty()) return keys;
+
+    double minX = std::numeric_limits<double>::max(), maxX = std::numeric_limits<double>::lowest();
+    double minY = minX, maxY = maxX;
+    for (const auto& [x, y] : points) {
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    const double gridMax = (1u << 16) - 1;
+    double extent = std::max(maxX - minX, maxY - minY);
+    double scale = extent > 0.0 ? gridMax / extent : 0.0;
+    for (size_t i = 0; i < points.size(); i++) {
+        uint32_t gx = (uint32_t)((points[i].first - minX) * scale);
+        uint32_t gy = (uint32_t)((points[i].second - minY) * scale);
+        keys[i] = hilbertIndex(gx, gy);
+    }
+    return keys;
+}
+
+void sortTasksAlongHilbert(DeliveryProblem &problem)
+{
+    std::vector<std::pair<double, double>> points;
+    points.reserve(problem.tasks.size());
+    for (const auto& task : problem.tasks) points.push_back({task.x, task.y});
+    std::vector<uint64_t> keys = hilbertKeys(points);
+
+    std::vector<int> order(problem.tasks.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto byKey = [&](int a, int b) { return keys[a] < keys[b]; };
+    auto split = order.begin() + problem.initialDemandCount;
+    std::stable_sort(order.begin(), split, byKey);
+    std::stable_sort(split, order.end(), byKey);
+
+    std::vector<TaskPoint> sorted;
+    sorted.reserve(order.size());
+    for (int index : order) sorted.push_back(problem.tasks[index]);
+    problem.tasks = std::move(sorted);
+}
+
+std::vector<int> hilbertNodeOrder(const DeliveryProblem &problem, const std::vector<int> &nodeIds)
+{
+    // 有坐标的路网节点：任务点和配送中心所在节点
+    std::vector<std::pair<double, double>> points;
+    std::vector<int> pointNodes;
+    for (const auto& task : problem.tasks) {
+        points.push_back({task.x, task.y});
+        pointNodes.push_back(toRoadNodeId(task.id));
+    }
+    for (const auto& center : problem.centers) {
+        points.push_back({center.x, center.y});
+        pointNodes.push_back(toRoadNodeId(center.id));
+    }
+    std::vector<uint64_t> pointKeys = hilbertKeys(points);
+
+    // 多源BFS：从有坐标的节点出发，把序号传播给最近的无坐标节点
+    CsrGraph graph = buildCsrGraph(problem.network.edges);
+    const uint64_t noKey = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> nodeKey(graph.nodeCount, noKey);
+    std::vector<int> hops(graph.nodeCount, -1);
+    std::vector<int> queue;
+    for (size_t p = 0; p < points.size(); p++) {
+        int v = graph.indexOf(pointNodes[p]);
+        if (v < 0 || hops[v] == 0) continue;
+        nodeKey[v] = pointKeys[p];
+        hops[v] = 0;
+        queue.push_back(v);
+    }
+    for (size_t head = 0; head < queue.size(); head++) {
+        int u = queue[head];
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            int v = graph.targets[e];
+            if (hops[v] >= 0) continue;
+            hops[v] = hops[u] + 1;
+            nodeKey[v] = nodeKey[u];
+            queue.push_back(v);
+        }
+    }
+
+    // 同一序号的节点按到有坐标节点的跳数排列
+    std::vector<std::pair<uint64_t, int>> sortKey(nodeIds.size(), {noKey, 0});
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        int v = graph.indexOf(nodeIds[i]);
+        if (v >= 0 && hops[v] >= 0) sortKey[i] = {nodeKey[v], hops[v]};
+    }
+    std::vector<int> order(nodeIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return sortKey[a] < sortKey[b]; });
+    return order;
+}
+
+void permuteMatrixNodes(RouteNetwork &network, const std::vector<int> &order)
+{
+    size_t n = network.nodeCount;
+    std::vector<double> permuted(n * n);
+    std::vector<int> nodeIds(n);
+    for (size_t i = 0; i < n; i++) {
+        const double* source = network.distMatrix.data() + (size_t)order[i] * n;
+        double* target = permuted.data() + i * n;
+        for (size_t j = 0; j < n; j++) {
+            target[j] = source[order[j]];
+        }
+        nodeIds[i] = network.nodeIds[order[i]];
+    }
+    network.distMatrix = std::move(permuted);
+    network.nodeIds = std::move(nodeIds);
+    for (size_t i = 0; i < n; i++) {
+        network.nodeIndex[network.nodeIds[i]] = i;
+    }
+}
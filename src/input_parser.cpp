@@ -0,0 +1,152 @@
+#include "input_parser.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstring>
+
+// 每块至少解析的边数/字节数，块太小时线程调度的开销超过解析本身
+static const int MIN_CHUNK_EDGES = 4096;
+static const size_t MIN_CHUNK_BYTES = 128 * 1024;
+
+static int chunkCountFor(size_t work, size_t minChunk, int threadCount)
+{
+    if (threadCount <= 1) return 1;
+    size_t chunks = std::min<size_t>((size_t)threadCount * 4, work / minChunk);
+    return std::max<int>(1, (int)chunks);
+}
+
+// [begin, end) 内是否有非空白字符
+static bool hasToken(const char* begin, const char* end)
+{
+    for (const char* p = begin; p < end; p++) {
+        if (*p != ' ' && *p != '\r' && *p != '\t' && *p != '\v' && *p != '\f') return true;
+    }
+    return false;
+}
+
+static const char* lineEnd(const char* begin, const char* end)
+{
+    const void* newline = memchr(begin, '\n', end - begin);
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+static bool readEdge(TokenScanner &scanner, Edge &edge)
+{
+    int node1, node2;
+    double length;
+    if (!scanner.readAll(node1, node2, length)) return false;
+    if (node1 < 0 || node2 < 0) return false;  // 节点索引按ID直接下标，ID不能为负
+    edge = {node1, node2, length / 1000.0};  // 将米转换为公里
+    return true;
+}
+
+bool parseEdgeSection(TokenScanner &scanner, int count, std::vector<Edge> &edges, int threadCount)
+{
+    edges.resize(count);
+    int chunkCount = chunkCountFor(count, MIN_CHUNK_EDGES, threadCount);
+
+    if (chunkCount > 1) {
+        // 按非空行计数，记下第 k*count/chunkCount 条边所在行的行首（memchr扫描远快于数字转换）
+        std::vector<const char*> starts;
+        std::vector<int> firstEdge;
+        starts.reserve(chunkCount + 1);
+        firstEdge.reserve(chunkCount + 1);
+        const char* p = scanner.position();
+        const char* end = scanner.limit();
+        int line = 0;
+        while (line < count && p < end) {
+            const char* eol = lineEnd(p, end);
+            if (hasToken(p, eol)) {
+                if (line == (long long)starts.size() * count / chunkCount) {
+                    starts.push_back(p);
+                    firstEdge.push_back(line);
+                }
+                line++;
+            }
+            p = eol < end ? eol + 1 : end;
+        }
+
+        if (line == count) {
+            starts.push_back(p);
+            firstEdge.push_back(count);
+            int chunks = (int)starts.size() - 1;
+            std::vector<char> ok(chunks, 0);
+            parallelFor(0, chunks, threadCount, [&](int k) {
+                TokenScanner chunk(starts[k], starts[k + 1]);
+                for (int i = firstEdge[k]; i < firstEdge[k + 1]; i++) {
+                    if (!readEdge(chunk, edges[i])) return;
+                }
+                ok[k] = chunk.atEnd();  // 每行恰好一条边
+            });
+            if (std::all_of(ok.begin(), ok.end(), [](char v) { return v != 0; })) {
+                scanner.seek(p);
+                return true;
+            }
+        }
+    }
+
+    // 顺序读取（单线程，或边没有按一行一条排列时）
+    for (int i = 0; i < count; i++) {
+        if (!readEdge(scanner, edges[i])) return false;
+    }
+    return true;
+}
+
+// 读到不完整的记录时退回该记录开头，使块末尾跨越块边界的记录不被当作读完
+static void readFactors(TokenScanner &scanner, std::vector<EdgePeakFactor> &lines)
+{
+    int node1, node2;
+    double morningFactor, eveningFactor;
+    while (true) {
+        const char* recordStart = scanner.position();
+        if (!scanner.readAll(node1, node2, morningFactor, eveningFactor)) {
+            scanner.seek(recordStart);
+            return;
+        }
+        lines.push_back({node1, node2, {morningFactor, eveningFactor}});
+    }
+}
+
+std::vector<EdgePeakFactor> parseFactorSection(const char* begin, const char* end, int threadCount)
+{
+    std::vector<EdgePeakFactor> lines;
+    size_t bytes = end - begin;
+    int chunkCount = chunkCountFor(bytes, MIN_CHUNK_BYTES, threadCount);
+    if (chunkCount <= 1) {
+        TokenScanner scanner(begin, end);
+        readFactors(scanner, lines);
+        return lines;
+    }
+
+    // 块边界从均分位置后移到下一行行首
+    std::vector<const char*> bounds(chunkCount + 1);
+    bounds[0] = begin;
+    bounds[chunkCount] = end;
+    for (int k = 1; k < chunkCount; k++) {
+        const char* p = std::max(begin + bytes * k / chunkCount, bounds[k - 1]);
+        const char* eol = lineEnd(p, end);
+        bounds[k] = eol < end ? eol + 1 : end;
+    }
+
+    std::vector<std::vector<EdgePeakFactor>> parts(chunkCount);
+    std::vector<char> complete(chunkCount, 0);
+    parallelFor(0, chunkCount, threadCount, [&](int k) {
+        TokenScanner scanner(bounds[k], bounds[k + 1]);
+        readFactors(scanner, parts[k]);
+        complete[k] = scanner.atEnd();
+    });
+
+    // 第一个没有完整读完的块（格式错误或记录跨越块边界）及其后的部分按顺序重新读取，结果与逐个读取一致
+    // 之前的块都恰好读完，所以该块的起点一定是记录开头
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    lines.reserve(total);
+    for (int k = 0; k < chunkCount; k++) {
+        if (!complete[k]) {
+            TokenScanner scanner(bounds[k], end);
+            readFactors(scanner, lines);
+            break;
+        }
+        lines.insert(lines.end(), parts[k].begin(), parts[k].end());
+    }
+    return lines;
+}
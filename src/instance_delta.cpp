@@ -0,0 +1,265 @@
+#include "instance_delta.h"
+#include "neighbor_lists.h"
+#include "network_update.h"
+#include "spatial_index.h"
+#include "task_assigner.h"
+#include "traffic_feed.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using std::endl;
+using std::string;
+using std::vector;
+
+// 解析一行增量变更，空行和注释行返回true且不产生变更
+static bool parseDeltaLine(const string &text, vector<DeltaOp> &ops)
+{
+    std::istringstream stream(text);
+    string keyword;
+    if (!(stream >> keyword) || keyword[0] == '#') return true;
+
+    DeltaOp op;
+    bool parsed = false;
+    if (keyword == "task" || keyword == "extra") {
+        int id;
+        double longitude, latitude, pickup, delivery, minutes = 0.0;
+        parsed = (bool)(stream >> id >> longitude >> latitude >> pickup >> delivery);
+        op.extra = keyword == "extra";
+        if (parsed && op.extra) parsed = (bool)(stream >> minutes);
+        parsed = parsed && id >= 0 && id < 10000;  // 与输入文件相同：原始ID不超过10000
+        if (parsed) {
+            auto [x, y] = convertLatLongToXY(latitude, longitude);
+            op.kind = DeltaKind::AddTask;
+            op.task = {op.extra ? id + 10000 : id, x, y, op.extra ? minutes / 60.0 : 0.0,
+                       DeliveryProblem::DEFAULT_CENTER_ID, pickup, delivery};
+        }
+    } else if (keyword == "cancel") {
+        op.kind = DeltaKind::CancelTask;
+        parsed = (bool)(stream >> op.id);
+    } else if (keyword == "move") {
+        op.kind = DeltaKind::MoveVehicle;
+        parsed = (bool)(stream >> op.id >> op.centerId);
+    }
+    string rest;
+    if (!parsed || (stream >> rest && rest[0] != '#')) return false;
+    ops.push_back(op);
+    return true;
+}
+
+bool loadDeltaFile(const string &path, vector<DeltaOp> &ops)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "无法打开增量文件: " << path << endl;
+        return false;
+    }
+    string text;
+    int lineNumber = 0;
+    while (std::getline(file, text)) {
+        lineNumber++;
+        if (!parseDeltaLine(text, ops)) {
+            std::cerr << "增量文件格式错误: " << path << " 第 " << lineNumber << " 行: " << text << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// position 及之后的任务点下标发生了变化，重建它们的ID映射
+static void reindexTasks(DeliveryProblem &problem, size_t position)
+{
+    for (size_t i = position; i < problem.tasks.size(); i++) {
+        problem.taskIdToIndex[problem.tasks[i].id] = i;
+    }
+}
+
+// 在current上为node追加一个槽位：复制快照（快照只读），补齐新节点与已有槽位之间的系数和行驶时间
+static std::shared_ptr<PeakFactorTable> withFactorSlot(const DeliveryProblem &problem, const PeakFactorTable &current,
+                                                       int node)
+{
+    auto table = std::make_shared<PeakFactorTable>(current);
+    int slot = table->slotCount++;
+    if (node >= (int)table->slotOf.size()) table->slotOf.resize(node + 1, -1);
+    table->slotOf[node] = slot;
+    table->slotNodes.push_back(node);
+    table->factors.resize((size_t)table->slotCount * (table->slotCount + 1) / 2, PeakFactor());
+    if (table->lines) {
+        // 与 buildTrafficSnapshot 相同：同一点对以后出现的行为准
+        for (const auto& line : *table->lines) {
+            int slot1 = table->slotOfPoint(line.node1);
+            int slot2 = table->slotOfPoint(line.node2);
+            if (slot1 < 0 || slot2 < 0 || (slot1 != slot && slot2 != slot)) continue;
+            table->factors[PeakFactorTable::pairIndex(slot1, slot2)] = line.factor;
+        }
+    }
+    appendBandTravelTimes(*table, problem.network, slot);
+    if (table->timeDependent) {
+        // 时变最短路的目标节点按槽位排列，加入槽位后重建（已缓存的行驶时间随之清空）
+        table->timeDependent = buildTimeDependentRoutes(problem, table->lines ? *table->lines : vector<EdgePeakFactor>(),
+                                                        table->slotNodes);
+    }
+    return table;
+}
+
+// 路网节点的系数槽位，没有时追加一个后替换生效快照
+static int ensureFactorSlot(DeliveryProblem &problem, int node)
+{
+    int slot = problem.network.peakFactors->slotOfNode(node);
+    if (slot >= 0) return slot;
+
+    if (!problem.trafficFeed) {
+        auto table = withFactorSlot(problem, *problem.network.peakFactors, node);
+        table->version = problem.network.peakFactors->version + 1;
+        problem.network.peakFactors = std::move(table);
+        return problem.network.peakFactors->slotOfNode(node);
+    }
+
+    // 实时交通更新以已发布的版本为槽位布局，新槽位也要经发布点生效：
+    // 在发布点的最新快照（可能含尚未 refreshTraffic 的新系数）上追加，期间后台线程发布了新版本时在其上重建
+    std::shared_ptr<const PeakFactorTable> published;
+    while (!published) {
+        std::shared_ptr<const PeakFactorTable> latest = problem.trafficFeed->snapshot();
+        auto table = withFactorSlot(problem, *latest, node);
+        std::shared_ptr<const PeakFactorTable> candidate = table;
+        if (problem.trafficFeed->publish(std::move(table), latest.get())) published = candidate;
+    }
+    problem.network.peakFactors = published;
+    return published->slotOfNode(node);
+}
+
+bool addTask(DeliveryProblem &problem, const TaskPoint &task, bool extra)
+{
+    if (task.id < 0 || task.id > 30000 || problem.taskIdToIndex.count(task.id) || problem.centerIds.count(task.id)) {
+        std::cerr << "无效或重复的任务ID: " << task.id << endl;
+        return false;
+    }
+
+    int node = toRoadNodeId(task.id);
+    int matrixIndex = problem.network.indexOf(node);
+    if (matrixIndex < 0) matrixIndex = addMatrixNode(problem.network, node);
+    if (matrixIndex < 0 && !problem.network.nextHop.empty()) {
+        // --road-paths 的全路网矩阵已含全部路网节点，不在其中说明任务点不在路网上，无法展开路段
+        std::cerr << "任务点 " << task.id << " 所在节点不在路网中" << endl;
+        return false;
+    }
+    int slot = problem.network.peakFactors ? ensureFactorSlot(problem, node) : -1;
+
+    // 初始需求点在前、额外需求点在后的划分保持不变
+    size_t position = extra ? problem.tasks.size() : problem.initialDemandCount;
+    problem.tasks.insert(problem.tasks.begin() + position, task);
+    problem.taskMatrixIndex.insert(problem.taskMatrixIndex.begin() + position, matrixIndex);
+    problem.taskFactorSlot.insert(problem.taskFactorSlot.begin() + position, slot);
+    reindexTasks(problem, position);
+    problem.coordinates[task.id] = {task.x, task.y};
+    extendEuclideanLowerBound(problem, {NodeKind::Task, false, (int)position});
+    problem.neighbors.reset();
+    if (extra) {
+        problem.extraDemandCount++;
+    } else {
+        problem.initialDemandCount++;
+    }
+
+    // 已分配过配送中心时，新的初始需求点按同样规则分配（额外需求点在动态阶段分配）
+    if (!extra && !problem.centerToTasks.empty()) {
+        TaskPoint& added = problem.tasks[position];
+        int centerId = findClosestCenter(problem, added);
+        if (centerId == -1) {
+            std::cerr << "任务点 " << task.id << " 没有可到达的配送中心" << endl;
+            cancelTask(problem, task.id);
+            return false;
+        }
+        added.centerId = centerId;
+        problem.centerToTasks[centerId].push_back(added.id);
+    }
+    return true;
+}
+
+bool cancelTask(DeliveryProblem &problem, int taskId)
+{
+    auto it = problem.taskIdToIndex.find(taskId);
+    if (it == problem.taskIdToIndex.end()) {
+        std::cerr << "未知的任务ID: " << taskId << endl;
+        return false;
+    }
+    size_t position = it->second;
+    int centerId = problem.tasks[position].centerId;
+    problem.taskIdToIndex.erase(it);
+
+    problem.tasks.erase(problem.tasks.begin() + position);
+    problem.taskMatrixIndex.erase(problem.taskMatrixIndex.begin() + position);
+    problem.taskFactorSlot.erase(problem.taskFactorSlot.begin() + position);
+    reindexTasks(problem, position);
+    problem.coordinates.erase(taskId);
+    problem.neighbors.reset();
+    if ((int)position < problem.initialDemandCount) {
+        problem.initialDemandCount--;
+    } else {
+        problem.extraDemandCount--;
+    }
+
+    auto assigned = problem.centerToTasks.find(centerId);
+    if (assigned != problem.centerToTasks.end()) {
+        auto& taskIds = assigned->second;
+        taskIds.erase(std::remove(taskIds.begin(), taskIds.end(), taskId), taskIds.end());
+    }
+    return true;
+}
+
+bool moveVehicle(DeliveryProblem &problem, int vehicleId, int centerId)
+{
+    auto vehicleIt = problem.vehicleIdToIndex.find(vehicleId);
+    auto centerIt = problem.centerIdToIndex.find(centerId);
+    if (vehicleIt == problem.vehicleIdToIndex.end() || centerIt == problem.centerIdToIndex.end()) {
+        std::cerr << "未知的车辆或配送中心: " << vehicleId << " -> " << centerId << endl;
+        return false;
+    }
+    Vehicle& vehicle = problem.vehicles[vehicleIt->second];
+    if (vehicle.centerId == centerId) return true;
+
+    // 与车辆/无人机配送中心的划分一致：车辆只能调到车辆配送中心，无人机只能调到无人机配送中心
+    bool drone = vehicle.maxLoad > 0;
+    if (drone != (centerIt->second >= problem.vehicleCenterCount)) {
+        std::cerr << (drone ? "无人机 " : "车辆 ") << vehicleId << " 不能调到" << (drone ? "车辆" : "无人机")
+                  << "配送中心 " << centerId << endl;
+        return false;
+    }
+    DistributionCenter& from = problem.centers[problem.centerIdToIndex.at(vehicle.centerId)];
+    from.vehicles.erase(std::remove(from.vehicles.begin(), from.vehicles.end(), vehicleId), from.vehicles.end());
+    (drone ? from.droneCount : from.carCount)--;
+
+    DistributionCenter& to = problem.centers[centerIt->second];
+    to.vehicles.push_back(vehicleId);
+    (drone ? to.droneCount : to.carCount)++;
+    vehicle.centerId = centerId;
+    return true;
+}
+
+bool applyDelta(DeliveryProblem &problem, const vector<DeltaOp> &ops)
+{
+    for (size_t i = 0; i < ops.size(); i++) {
+        const DeltaOp& op = ops[i];
+        bool applied = false;
+        switch (op.kind) {
+        case DeltaKind::AddTask:
+            applied = addTask(problem, op.task, op.extra);
+            break;
+        case DeltaKind::CancelTask:
+            applied = cancelTask(problem, op.id);
+            break;
+        case DeltaKind::MoveVehicle:
+            applied = moveVehicle(problem, op.id, op.centerId);
+            break;
+        }
+        if (!applied) {
+            std::cerr << "第 " << i + 1 << " 项增量变更应用失败，之后的变更未应用" << endl;
+            return false;
+        }
+    }
+    // 任务点增删后近邻表的下标已失效，全部变更应用后重建一次
+    if (!problem.neighbors && problem.config.neighborCount > 0) {
+        problem.neighbors = buildNeighborLists(problem, problem.config.neighborCount);
+    }
+    return true;
+}
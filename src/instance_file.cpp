@@ -0,0 +1,405 @@
+#include "instance_file.h"
+#include "shortest_path.h"
+#include "hilbert_order.h"
+#include "travel_time.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using std::cout;
+using std::endl;
+
+// 定义于common.cpp，由文本加载同样设置
+extern double droneSpeed, carSpeed, droneCost, vehicleCost, droneMaxLoad, droneMaxFuel, timeWeight;
+
+constexpr uint32_t INSTANCE_MAGIC = 0x49525256;        // "VRRI"
+constexpr uint32_t INSTANCE_VERSION = 1;
+constexpr uint64_t INSTANCE_ALIGN = 64;                // 各段起始偏移按缓存行对齐
+
+// 段表下标
+enum InstanceSection
+{
+    SectionTasks,           // TaskRecord，初始需求点在前、额外需求点在后（文件原始顺序）
+    SectionCenters,         // CenterRecord，车辆配送中心在前
+    SectionVehicles,        // VehicleRecord，按车辆ID顺序
+    SectionEdges,           // EdgeRecord，长度单位公里
+    SectionGraphNodeIds,    // CSR邻接表：int32 索引 -> 节点ID
+    SectionGraphNodeIndex,  // int32 节点ID -> 索引
+    SectionGraphOffsets,    // int32 × (节点数+1)
+    SectionGraphTargets,    // int32
+    SectionGraphWeights,    // double
+    SectionFactors,         // FactorRecord，文件中的高峰期系数行
+    SectionMatrixNodeIds,   // int32 距离矩阵索引 -> 节点ID（可选）
+    SectionMatrix,          // double 行主序距离矩阵（可选）
+    SectionCount
+};
+
+struct InstanceSectionEntry
+{
+    uint64_t offset;        // 相对文件起始的字节偏移
+    uint64_t count;         // 记录数
+};
+
+struct InstanceHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    int32_t initialDemandCount;
+    int32_t extraDemandCount;
+    int32_t vehicleCenterCount;
+    int32_t droneCenterCount;
+    double droneSpeed, carSpeed, droneCost, vehicleCost, droneMaxLoad, droneMaxFuel, timeWeight;
+    int32_t matrixNodeIndexSize;    // 距离矩阵节点ID上界+1，用于重建 nodeIndex
+    int32_t reserved;
+    InstanceSectionEntry sections[SectionCount];
+};
+
+struct TaskRecord
+{
+    int32_t id;
+    int32_t reserved;
+    double x, y;
+    double arrivalTime;     // 小时
+    double pickupWeight;
+    double deliveryWeight;
+};
+
+struct CenterRecord
+{
+    int32_t id;             // 已加20000偏移
+    int32_t carCount;
+    int32_t droneCount;
+    int32_t reserved;
+    double x, y;
+};
+
+struct VehicleRecord
+{
+    int32_t id;
+    int32_t centerId;
+    double speed, cost, maxLoad, maxFuel;
+};
+
+struct EdgeRecord
+{
+    int32_t node1, node2;
+    double length;
+};
+
+struct FactorRecord
+{
+    int32_t node1, node2;
+    double morning, evening;
+};
+
+static_assert(sizeof(TaskRecord) == 48 && sizeof(CenterRecord) == 32 && sizeof(VehicleRecord) == 40 &&
+              sizeof(EdgeRecord) == 16 && sizeof(FactorRecord) == 24, "实例文件记录布局");
+
+bool isInstanceFile(const MappedFile &file)
+{
+    uint32_t magic = 0;
+    if (file.size() < sizeof(magic)) return false;
+    memcpy(&magic, file.data(), sizeof(magic));
+    return magic == INSTANCE_MAGIC;
+}
+
+// 段的只读视图，越界或未对齐时返回false
+template <typename T>
+static bool sectionView(const MappedFile &file, const InstanceHeader &header, InstanceSection section,
+                        const T* &data, size_t &count)
+{
+    const InstanceSectionEntry& entry = header.sections[section];
+    count = entry.count;
+    data = reinterpret_cast<const T*>(file.data() + entry.offset);
+    return entry.offset % INSTANCE_ALIGN == 0 && entry.offset <= file.size() &&
+           entry.count <= (file.size() - entry.offset) / sizeof(T);
+}
+
+template <typename T>
+static bool sectionVector(const MappedFile &file, const InstanceHeader &header, InstanceSection section,
+                          std::vector<T> &values)
+{
+    const T* data = nullptr;
+    size_t count = 0;
+    if (!sectionView(file, header, section, data, count)) return false;
+    values.assign(data, data + count);
+    return true;
+}
+
+// 邻接表各段互相一致：偏移从0开始单调不减并止于边数，邻接节点是合法索引，节点ID与ID->索引表互逆
+static bool validGraph(const CsrGraph &graph)
+{
+    size_t n = graph.nodeIds.size();
+    if (graph.offsets[0] != 0 || graph.offsets[n] != (int)graph.targets.size()) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (graph.offsets[i] > graph.offsets[i + 1]) return false;
+    }
+    for (int target : graph.targets) {
+        if (target < 0 || target >= (int)n) return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        int nodeId = graph.nodeIds[i];
+        if (nodeId < 0 || nodeId >= (int)graph.nodeIndex.size() || graph.nodeIndex[nodeId] != (int)i) return false;
+    }
+    for (size_t nodeId = 0; nodeId < graph.nodeIndex.size(); nodeId++) {
+        int index = graph.nodeIndex[nodeId];
+        if (index != -1 && (index < 0 || index >= (int)n || graph.nodeIds[index] != (int)nodeId)) return false;
+    }
+    return true;
+}
+
+bool loadInstanceFile(std::shared_ptr<const MappedFile> file, DeliveryProblem &problem,
+                      std::vector<EdgePeakFactor>* savedFactorLines)
+{
+    InstanceHeader header;
+    if (file->size() < sizeof(header)) return false;
+    memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != INSTANCE_MAGIC || header.version != INSTANCE_VERSION) {
+        std::cerr << "二进制实例版本不匹配（文件 " << header.version << "，当前 " << INSTANCE_VERSION << "）" << endl;
+        return false;
+    }
+
+    const TaskRecord* tasks = nullptr;
+    const CenterRecord* centers = nullptr;
+    const VehicleRecord* vehicles = nullptr;
+    const EdgeRecord* edges = nullptr;
+    const FactorRecord* factors = nullptr;
+    const int32_t* matrixNodeIds = nullptr;
+    const double* matrix = nullptr;
+    size_t taskCount = 0, centerCount = 0, vehicleCount = 0, edgeCount = 0, factorCount = 0;
+    size_t matrixNodeCount = 0, matrixSize = 0;
+    RouteNetwork& network = problem.network;
+    CsrGraph& graph = network.graph;
+    bool valid = sectionView(*file, header, SectionTasks, tasks, taskCount) &&
+                 sectionView(*file, header, SectionCenters, centers, centerCount) &&
+                 sectionView(*file, header, SectionVehicles, vehicles, vehicleCount) &&
+                 sectionView(*file, header, SectionEdges, edges, edgeCount) &&
+                 sectionView(*file, header, SectionFactors, factors, factorCount) &&
+                 sectionView(*file, header, SectionMatrixNodeIds, matrixNodeIds, matrixNodeCount) &&
+                 sectionView(*file, header, SectionMatrix, matrix, matrixSize) &&
+                 sectionVector(*file, header, SectionGraphNodeIds, graph.nodeIds) &&
+                 sectionVector(*file, header, SectionGraphNodeIndex, graph.nodeIndex) &&
+                 sectionVector(*file, header, SectionGraphOffsets, graph.offsets) &&
+                 sectionVector(*file, header, SectionGraphTargets, graph.targets) &&
+                 sectionVector(*file, header, SectionGraphWeights, graph.weights);
+    graph.nodeCount = graph.nodeIds.size();
+    valid = valid && header.initialDemandCount >= 0 && header.extraDemandCount >= 0 &&
+            header.vehicleCenterCount >= 0 && header.droneCenterCount >= 0 &&
+            taskCount == (size_t)header.initialDemandCount + header.extraDemandCount &&
+            centerCount == (size_t)header.vehicleCenterCount + header.droneCenterCount &&
+            graph.offsets.size() == graph.nodeIds.size() + 1 && graph.targets.size() == graph.weights.size() &&
+            matrixSize == matrixNodeCount * matrixNodeCount;
+    if (!valid) {
+        std::cerr << "二进制实例段表损坏" << endl;
+        graph = CsrGraph();
+        return false;
+    }
+    if (!validGraph(graph)) {
+        std::cerr << "二进制实例的路网邻接表损坏" << endl;
+        graph = CsrGraph();
+        return false;
+    }
+
+    // 高峰时间窗对应的一天分段时刻表
+    problem.travelProfile = buildTravelTimeProfile(problem.config.peakWindows);
+
+    droneSpeed = header.droneSpeed;
+    carSpeed = header.carSpeed;
+    droneCost = header.droneCost;
+    vehicleCost = header.vehicleCost;
+    droneMaxLoad = header.droneMaxLoad;
+    droneMaxFuel = header.droneMaxFuel;
+    timeWeight = header.timeWeight;
+    problem.timeWeight = header.timeWeight;
+    problem.initialDemandCount = header.initialDemandCount;
+    problem.extraDemandCount = header.extraDemandCount;
+
+    problem.tasks.resize(taskCount);
+    for (size_t i = 0; i < taskCount; i++) {
+        const TaskRecord& task = tasks[i];
+        problem.tasks[i] = {task.id, task.x, task.y, task.arrivalTime, DeliveryProblem::DEFAULT_CENTER_ID,
+                            task.pickupWeight, task.deliveryWeight};
+    }
+    problem.centers.resize(centerCount);
+    problem.vehicleCenterCount = header.vehicleCenterCount;
+    std::unordered_map<int, int> centerIndex;
+    for (size_t i = 0; i < centerCount; i++) {
+        const CenterRecord& center = centers[i];
+        problem.centers[i] = {center.id, center.x, center.y, center.carCount, center.droneCount, {}};
+        centerIndex[center.id] = i;
+    }
+    problem.vehicles.resize(vehicleCount);
+    for (size_t i = 0; i < vehicleCount; i++) {
+        const VehicleRecord& vehicle = vehicles[i];
+        problem.vehicles[i] = {vehicle.id, vehicle.speed, vehicle.cost, vehicle.maxLoad, vehicle.maxFuel,
+                               vehicle.centerId};
+        auto it = centerIndex.find(vehicle.centerId);
+        if (it == centerIndex.end()) {
+            std::cerr << "二进制实例中车辆 " << vehicle.id << " 的配送中心不存在" << endl;
+            return false;
+        }
+        problem.centers[it->second].vehicles.push_back(vehicle.id);
+        (it->second < header.vehicleCenterCount ? problem.allCarIds : problem.allDroneIds).push_back(vehicle.id);
+    }
+
+    // 坐标映射按文本加载的插入顺序：初始需求点、配送中心、额外需求点
+    for (int i = 0; i < header.initialDemandCount; i++) {
+        problem.coordinates[problem.tasks[i].id] = {problem.tasks[i].x, problem.tasks[i].y};
+    }
+    for (const auto& center : problem.centers) {
+        problem.coordinates[center.id] = {center.x, center.y};
+    }
+    for (size_t i = header.initialDemandCount; i < taskCount; i++) {
+        problem.coordinates[problem.tasks[i].id] = {problem.tasks[i].x, problem.tasks[i].y};
+    }
+
+    network.edges.resize(edgeCount);
+    for (size_t i = 0; i < edgeCount; i++) {
+        network.edges[i] = {edges[i].node1, edges[i].node2, edges[i].length};
+    }
+    std::vector<EdgePeakFactor> factorLines(factorCount);
+    for (size_t i = 0; i < factorCount; i++) {
+        factorLines[i] = {factors[i].node1, factors[i].node2, {factors[i].morning, factors[i].evening}};
+    }
+
+    // 预计算的距离矩阵只在当前方式使用同样的稠密矩阵时直接映射；Hilbert重排和下一跳矩阵需要重新计算
+    ApspMethod method = problem.config.apspMethod;
+    bool useMatrix = matrixNodeCount > 0 && !problem.config.hilbertOrder && !problem.config.recordRoadPaths &&
+                     (method == ApspMethod::Floyd || method == ApspMethod::Blocked || method == ApspMethod::Dijkstra);
+    if (useMatrix) {
+        network.nodeCount = matrixNodeCount;
+        network.nodeIds.assign(matrixNodeIds, matrixNodeIds + matrixNodeCount);
+        network.nodeIndex.assign(std::max(header.matrixNodeIndexSize, 0), -1);
+        for (size_t i = 0; i < matrixNodeCount; i++) {
+            if (network.nodeIds[i] < 0 || network.nodeIds[i] >= (int)network.nodeIndex.size()) {
+                std::cerr << "二进制实例的距离矩阵节点ID越界" << endl;
+                return false;
+            }
+            network.nodeIndex[network.nodeIds[i]] = i;
+        }
+        network.mappedMatrix = matrix;
+        network.matrixFile = file;
+        cout << "已从二进制实例映射距离矩阵，节点数: " << network.nodeCount << '\n';
+        compactDistanceMatrix(network, problem.config.matrixStorage);
+        printCompactDistanceMatrix(network);
+    } else {
+        if (problem.config.hilbertOrder) {
+            sortTasksAlongHilbert(problem);
+        }
+        computeShortestPaths(problem);
+    }
+
+    finishProblemLoad(problem, factorLines);
+    if (savedFactorLines) *savedFactorLines = std::move(factorLines);
+    return true;
+}
+
+// 按段写出：记录段前补齐到对齐边界
+class SectionWriter
+{
+public:
+    SectionWriter(std::ofstream &out, InstanceHeader &header) : out(out), header(header) {}
+
+    template <typename T>
+    void write(InstanceSection section, const T* data, size_t count)
+    {
+        static const char padding[INSTANCE_ALIGN] = {};
+        uint64_t offset = (position + INSTANCE_ALIGN - 1) / INSTANCE_ALIGN * INSTANCE_ALIGN;
+        out.write(padding, offset - position);
+        out.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+        header.sections[section] = {offset, count};
+        position = offset + count * sizeof(T);
+    }
+
+    template <typename T>
+    void write(InstanceSection section, const std::vector<T> &values)
+    {
+        write(section, values.data(), values.size());
+    }
+
+private:
+    std::ofstream &out;
+    InstanceHeader &header;
+    uint64_t position = sizeof(InstanceHeader);
+};
+
+bool saveInstanceFile(const std::string &path, const DeliveryProblem &problem,
+                      const std::vector<EdgePeakFactor> &factorLines, bool includeMatrix)
+{
+    const RouteNetwork& network = problem.network;
+
+    InstanceHeader header = {};
+    header.magic = INSTANCE_MAGIC;
+    header.version = INSTANCE_VERSION;
+    header.initialDemandCount = problem.initialDemandCount;
+    header.extraDemandCount = problem.extraDemandCount;
+    header.vehicleCenterCount = problem.vehicleCenterCount;
+    header.droneCenterCount = problem.centers.size() - problem.vehicleCenterCount;
+    header.droneSpeed = droneSpeed;
+    header.carSpeed = carSpeed;
+    header.droneCost = droneCost;
+    header.vehicleCost = vehicleCost;
+    header.droneMaxLoad = droneMaxLoad;
+    header.droneMaxFuel = droneMaxFuel;
+    header.timeWeight = problem.timeWeight;
+
+    std::vector<TaskRecord> tasks;
+    tasks.reserve(problem.tasks.size());
+    for (const auto& task : problem.tasks) {
+        tasks.push_back({task.id, 0, task.x, task.y, task.arrivaltime, task.pickweight, task.sendWeight});
+    }
+    std::vector<CenterRecord> centers;
+    centers.reserve(problem.centers.size());
+    for (const auto& center : problem.centers) {
+        centers.push_back({center.id, center.carCount, center.droneCount, 0, center.x, center.y});
+    }
+    std::vector<VehicleRecord> vehicles;
+    vehicles.reserve(problem.vehicles.size());
+    for (const auto& vehicle : problem.vehicles) {
+        vehicles.push_back({vehicle.id, vehicle.centerId, vehicle.speed, vehicle.cost, vehicle.maxLoad, vehicle.maxfuel});
+    }
+    std::vector<EdgeRecord> edges;
+    edges.reserve(network.edges.size());
+    for (const auto& edge : network.edges) {
+        edges.push_back({edge.node1, edge.node2, edge.length});
+    }
+    std::vector<FactorRecord> factors;
+    factors.reserve(factorLines.size());
+    for (const auto& line : factorLines) {
+        factors.push_back({line.node1, line.node2, line.factor.morning, line.factor.evening});
+    }
+    CsrGraph graph = network.graph.nodeCount > 0 ? network.graph : buildCsrGraph(network.edges);
+
+    // 只写入稠密double矩阵（收缩层次、lazy行缓存和紧凑存储没有可直接映射的矩阵）
+    const double* matrix = network.mappedMatrix ? network.mappedMatrix : network.distMatrix.data();
+    bool writeMatrix = includeMatrix && network.nodeCount > 0 && !network.hierarchy && !network.lazyRows &&
+                       network.compact.storage == MatrixStorage::Double &&
+                       (network.mappedMatrix || !network.distMatrix.empty());
+    if (writeMatrix) {
+        header.matrixNodeIndexSize = network.nodeIndex.size();
+    }
+
+    return writeFileAtomically(path, [&](std::ofstream &out) {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        SectionWriter writer(out, header);
+        writer.write(SectionTasks, tasks);
+        writer.write(SectionCenters, centers);
+        writer.write(SectionVehicles, vehicles);
+        writer.write(SectionEdges, edges);
+        writer.write(SectionGraphNodeIds, graph.nodeIds);
+        writer.write(SectionGraphNodeIndex, graph.nodeIndex);
+        writer.write(SectionGraphOffsets, graph.offsets);
+        writer.write(SectionGraphTargets, graph.targets);
+        writer.write(SectionGraphWeights, graph.weights);
+        writer.write(SectionFactors, factors);
+        if (writeMatrix) {
+            size_t n = network.nodeCount;
+            writer.write(SectionMatrixNodeIds, network.nodeIds);
+            writer.write(SectionMatrix, matrix, n * n);
+        }
+        // 段表写完后回填头部
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    });
+}
@@ -3,9 +3,16 @@
 #include <limits>
 #include <string>
 #include <cmath>
+#include <cstdlib>
 #include "common.h"
 #include "solver.h"
 #include "path_validator.h"
+#include "distance_rows.h"
+#include "travel_time.h"
+#include "time_dependent.h"
+#include "traffic_feed.h"
+#include "route_stream.h"
+#include "instance_delta.h"
 
 using std::vector;
 using std::pair;
@@ -13,40 +20,179 @@ using std::cout;
 using std::endl;
 using std::string;
 
-// 声明全局变量
-vector<int> delayedTasks, newTasks;
+// 全局变量（定义于solver.cpp）
+extern vector<int> delayedTasks, newTasks;
+
+// 解析命令行参数：<input_file> [--apsp=floyd|blocked|dijkstra|ch|lazy] [--ch-file=path] [--distance-cache=dir] [--row-cache-mb=N]
+//                [--matrix-storage=double|float|fixed16|fixed32] [--road-paths] [--hilbert] [--peak-windows=7-9,17-19]
+//                [--time-dependent] [--td-bucket-min=N] [--traffic-feed=path|-] [--threads=N] [--spatial-index-min=N] [--neighbors=K] [--quiet|--verbose]
+//                [--solution-out=path] [--route-stream=path] [--plan-diff] [--plan-diff-out=path] [--delta=path ...]
+static bool parseArguments(int argc, char* argv[], string& filename, SolverConfig& config)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--apsp=", 0) == 0) {
+            string method = arg.substr(7);
+            if (method == "floyd") {
+                config.apspMethod = ApspMethod::Floyd;
+            } else if (method == "blocked") {
+                config.apspMethod = ApspMethod::Blocked;
+            } else if (method == "dijkstra") {
+                config.apspMethod = ApspMethod::Dijkstra;
+            } else if (method == "ch") {
+                config.apspMethod = ApspMethod::Hierarchy;
+            } else if (method == "lazy") {
+                config.apspMethod = ApspMethod::Lazy;
+            } else {
+                std::cerr << "未知的最短路算法: " << method << endl;
+                return false;
+            }
+        } else if (arg.rfind("--ch-file=", 0) == 0) {
+            config.hierarchyFile = arg.substr(10);
+        } else if (arg.rfind("--distance-cache=", 0) == 0) {
+            config.distanceCacheDir = arg.substr(17);
+        } else if (arg.rfind("--matrix-storage=", 0) == 0) {
+            string storage = arg.substr(17);
+            if (storage == "double") {
+                config.matrixStorage = MatrixStorage::Double;
+            } else if (storage == "float") {
+                config.matrixStorage = MatrixStorage::Float;
+            } else if (storage == "fixed16") {
+                config.matrixStorage = MatrixStorage::Fixed16;
+            } else if (storage == "fixed32") {
+                config.matrixStorage = MatrixStorage::Fixed32;
+            } else {
+                std::cerr << "未知的距离矩阵存储格式: " << storage << endl;
+                return false;
+            }
+        } else if (arg == "--hilbert") {
+            config.hilbertOrder = true;
+        } else if (arg == "--road-paths") {
+            config.recordRoadPaths = true;
+        } else if (arg.rfind("--peak-windows=", 0) == 0) {
+            if (!parsePeakWindows(arg.substr(15), config.peakWindows)) {
+                return false;
+            }
+        } else if (arg == "--time-dependent") {
+            config.timeDependent = true;
+        } else if (arg.rfind("--td-bucket-min=", 0) == 0) {
+            config.timeBucketMinutes = std::atoi(arg.c_str() + 16);
+            if (config.timeBucketMinutes <= 0 || config.timeBucketMinutes > 1440) {
+                std::cerr << "时间桶宽度必须为1~1440分钟: " << arg << endl;
+                return false;
+            }
+        } else if (arg.rfind("--traffic-feed=", 0) == 0) {
+            config.trafficFeed = arg.substr(15);
+        } else if (arg.rfind("--row-cache-mb=", 0) == 0) {
+            int megabytes = std::atoi(arg.c_str() + 15);
+            if (megabytes <= 0) {
+                std::cerr << "距离行缓存大小必须为正整数: " << arg << endl;
+                return false;
+            }
+            config.rowCacheBytes = (size_t)megabytes << 20;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            config.threadCount = std::atoi(arg.c_str() + 10);
+            if (config.threadCount <= 0) {
+                std::cerr << "线程数必须为正整数: " << arg << endl;
+                return false;
+            }
+        } else if (arg.rfind("--spatial-index-min=", 0) == 0) {
+            config.spatialIndexMinTasks = std::atoi(arg.c_str() + 20);
+            if (config.spatialIndexMinTasks < 0) {
+                std::cerr << "网格索引的任务数阈值不能为负: " << arg << endl;
+                return false;
+            }
+        } else if (arg.rfind("--neighbors=", 0) == 0) {
+            config.neighborCount = std::atoi(arg.c_str() + 12);
+            if (config.neighborCount < 0) {
+                std::cerr << "近邻数不能为负: " << arg << endl;
+                return false;
+            }
+        } else if (arg.rfind("--solution-out=", 0) == 0) {
+            config.solutionFile = arg.substr(15);
+        } else if (arg.rfind("--route-stream=", 0) == 0) {
+            config.routeStream = arg.substr(15);
+        } else if (arg.rfind("--delta=", 0) == 0) {
+            config.deltaFiles.push_back(arg.substr(8));
+        } else if (arg == "--plan-diff") {
+            config.planDiff = true;
+        } else if (arg.rfind("--plan-diff-out=", 0) == 0) {
+            config.planDiffFile = arg.substr(16);
+        } else if (arg == "--quiet") {
+            config.verbosity = Verbosity::Quiet;
+        } else if (arg == "--verbose") {
+            config.verbosity = Verbosity::Verbose;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "未知参数: " << arg << endl;
+            return false;
+        } else {
+            filename = arg;
+        }
+    }
+    return !filename.empty();
+}
 
 int main(int argc, char* argv[])
 {
     // 初始化随机数生成器
     srand(time(0));
     
-    // 检查命令行参数
-    if (argc < 2) {
-        cout << "Usage: " << argv[0] << " <input_file>" << endl;
-        cout << "Example: " << argv[0] << " ../test/output_data_weighted.txt" << endl;
+    // 检查并解析命令行参数
+    string filename;
+    DeliveryProblem problem;
+    if (!parseArguments(argc, argv, filename, problem.config)) {
+        cout << "Usage: " << argv[0] << " <input_file> [--apsp=floyd|blocked|dijkstra|ch|lazy] [--ch-file=path] [--distance-cache=dir] [--row-cache-mb=N] [--matrix-storage=double|float|fixed16|fixed32] [--road-paths] [--hilbert] [--peak-windows=7-9,17-19] [--time-dependent] [--td-bucket-min=N] [--traffic-feed=path|-] [--threads=N] [--spatial-index-min=N] [--neighbors=K] [--quiet|--verbose] [--solution-out=path] [--route-stream=path] [--plan-diff] [--plan-diff-out=path] [--delta=path ...]" << '\n';
+        cout << "Example: " << argv[0] << " ../test/output_data_weighted.txt --apsp=blocked --threads=8" << '\n';
         return 1;
     }
     
-    // 获取输入文件路径
-    string filename = argv[1];
+    // 结果输出经缓冲区写出，--quiet 时只输出最终汇总
+    initOutput(problem.config.verbosity);
     
-    // 初始化并加载配送问题数据
-    DeliveryProblem problem;
+    // 加载配送问题数据
     if (!loadProblemData(filename, problem)) {
-        cout << "加载数据失败，程序退出。" << endl;
+        std::cerr << "加载数据失败，程序退出。" << endl;
         return 1;
     }
     
+    // 日内变更：按顺序就地应用增量文件，不重新加载实例
+    for (const auto& deltaFile : problem.config.deltaFiles) {
+        std::vector<DeltaOp> ops;
+        if (!loadDeltaFile(deltaFile, ops) || !applyDelta(problem, ops)) {
+            std::cerr << "应用增量文件失败，程序退出。" << endl;
+            return 1;
+        }
+        cout << "已应用增量文件: " << deltaFile << "（" << ops.size() << " 项变更），初始需求点: "
+             << problem.initialDemandCount << ", 额外需求点: " << problem.extraDemandCount << '\n';
+    }
+    
+    // 实时交通数据：后台线程发布新系数，动态阶段开始前切换到最新版本
+    std::unique_ptr<TrafficWatcher> trafficWatcher;
+    if (!problem.config.trafficFeed.empty()) {
+        problem.trafficFeed = std::make_shared<TrafficFeed>(problem.network.peakFactors);
+        trafficWatcher = std::make_unique<TrafficWatcher>(problem, problem.trafficFeed, problem.config.trafficFeed);
+    }
+    
+    // 逐车输出最终路径：在求解前打开，FIFO在此等待调度端连接
+    std::unique_ptr<RouteStream> routeStream;
+    if (!problem.config.routeStream.empty()) {
+        routeStream = std::make_unique<RouteStream>();
+        if (!routeStream->open(problem.config.routeStream)) {
+            std::cerr << "无法打开路径流: " << problem.config.routeStream << endl;
+            return 1;
+        }
+    }
+    
     // 打印初始信息
     printInitialInfo(problem);
+    flushOutput();
     
     
     // 求解静态配送问题
-    cout << "\n========== 静态阶段求解 ==========" << endl;
+    cout << "\n========== 静态阶段求解 ==========" << '\n';
     
-    auto staticPaths = solveStaticProblem(problem);
-    cout << "\n========== 配送中心车辆和任务分配 ==========" << endl;
+    auto staticPaths = solveStaticProblem(problem, routeStream ? routeStream->sink(problem, "static") : nullptr);
+    cout << "\n========== 配送中心车辆和任务分配 ==========" << '\n';
     printCenterAssignments(problem);
     
     // 计算静态阶段的最大完成时间
@@ -58,13 +204,31 @@ int main(int argc, char* argv[])
         }
     }
     // 输出静态阶段结果
-    Print_DeliveryResults(problem, staticPaths);
+    DeliveryPlan staticPlan = buildDeliveryPlan(problem, staticPaths);
+    if (routeStream) routeStream->endStage("static", staticPlan);
+    printDeliveryPlan(problem, staticPlan);
+    flushOutput();
     
     // 解决动态配送问题
-    auto dynamicPaths = solveDynamicProblem(problem, staticPaths, staticMaxTime);
+    auto dynamicPaths = solveDynamicProblem(problem, staticPaths, staticMaxTime,
+                                            routeStream ? routeStream->sink(problem, "dynamic") : nullptr);
     
-    // 输出动态阶段配送结果详情
-    Print_DeliveryResults(problem, dynamicPaths);
+    // 输出动态阶段配送结果详情，最终的任务数、完成时间和成本在Quiet模式下也输出
+    DeliveryPlan dynamicPlan = buildDeliveryPlan(problem, dynamicPaths);
+    if (routeStream) routeStream->endStage("dynamic", dynamicPlan);
+    printDeliveryPlan(problem, dynamicPlan, Verbosity::Quiet);
+    if (!problem.config.solutionFile.empty() && !saveSolutionFile(problem.config.solutionFile, dynamicPlan)) {
+        std::cerr << "无法写入方案文件: " << problem.config.solutionFile << endl;
+    }
+    
+    // 只下发路线有变化的车辆及其变化的后缀
+    if (problem.config.planDiff || !problem.config.planDiffFile.empty()) {
+        PlanDiff planDiff = diffDeliveryPlans(staticPlan, dynamicPlan);
+        if (problem.config.planDiff) printPlanDiff(planDiff);
+        if (!problem.config.planDiffFile.empty() && !savePlanDiffFile(problem.config.planDiffFile, planDiff)) {
+            std::cerr << "无法写入路线变化文件: " << problem.config.planDiffFile << endl;
+        }
+    }
     
     auto [dynamicPathValid, dynamicErrorMsg] = validateDynamicPathLegality(
         problem, dynamicPaths, newTasks);
@@ -77,11 +241,31 @@ int main(int argc, char* argv[])
     auto [isValid, errorMessage] = validateAllPaths(problem, staticPaths, dynamicPaths, staticMaxTime, newTasks);
     
     if (isValid) {
-        cout << "路径验证通过，所有约束条件满足！" << endl;
+        output(Verbosity::Quiet) << "路径验证通过，所有约束条件满足！" << '\n';
     } else {
-        cout << "路径验证失败，请检查详细错误信息！" << endl;
+        output(Verbosity::Quiet) << "路径验证失败，请检查详细错误信息！" << '\n';
+        flushOutput();  // 错误信息写到标准错误，先写出之前的结果保持顺序
         std::cerr << errorMessage << endl;  // 输出详细错误信息
     }
+
+    // lazy方式下输出距离行缓存的命中情况
+    if (problem.network.lazyRows) {
+        DistanceRowStats stats = problem.network.lazyRows->stats();
+        uint64_t queries = stats.hits + stats.misses;
+        cout << "距离行缓存: 命中 " << stats.hits << ", 未命中 " << stats.misses
+             << ", 淘汰 " << stats.evictions << ", 命中率 "
+             << (queries ? 100.0 * stats.hits / queries : 0.0) << "%" << '\n';
+    }
+
+    // 时变最短路的行驶时间缓存命中情况
+    if (problem.network.peakFactors->timeDependent) {
+        TimeDependentStats stats = problem.network.peakFactors->timeDependent->stats();
+        uint64_t queries = stats.hits + stats.misses;
+        cout << "时变行驶时间缓存: 命中 " << stats.hits << ", 未命中 " << stats.misses
+             << ", 淘汰 " << stats.evictions << ", 命中率 "
+             << (queries ? 100.0 * stats.hits / queries : 0.0) << "%" << '\n';
+    }
     
+    flushOutput();
     return 0;
 }
@@ -0,0 +1,62 @@
+#include "mapped_file.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// 映射整个文件
+bool MappedFile::open(const std::string &path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // 映射建立后文件描述符即可关闭
+    if (mapped == MAP_FAILED) return false;
+
+    address = mapped;
+    length = info.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (address) {
+        munmap(address, length);
+        address = nullptr;
+        length = 0;
+    }
+}
+
+bool writeFileAtomically(const std::string &path, const std::function<void(std::ofstream &)> &write)
+{
+    std::string tempPath = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        if (!out.is_open()) return false;
+        write(out);
+        if (!out) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
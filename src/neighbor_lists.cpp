@@ -0,0 +1,64 @@
+#include "neighbor_lists.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using std::vector;
+
+// 从 (距离, 任务下标) 中取最近的 k 个写入一行，不足 k 个时以-1补齐
+static void fillRow(vector<std::pair<double, int>> &candidates, int k, int* tasks, double* distances)
+{
+    size_t count = std::min(candidates.size(), (size_t)k);
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    for (size_t n = 0; n < (size_t)k; n++) {
+        tasks[n] = n < count ? candidates[n].second : -1;
+        distances[n] = n < count ? candidates[n].first : std::numeric_limits<double>::infinity();
+    }
+}
+
+std::shared_ptr<const NeighborLists> buildNeighborLists(const DeliveryProblem &problem, int k)
+{
+    auto lists = std::make_shared<NeighborLists>();
+    lists->k = k;
+    lists->taskCount = (int)problem.tasks.size();
+    lists->pointCount = lists->taskCount + (int)problem.centers.size();
+    const RouteNetwork& network = problem.network;
+    lists->hasRoad = !network.hierarchy && !network.lazyRows && network.nodeCount > 0;
+    lists->distanceVersion = network.distanceVersion;
+
+    size_t cells = (size_t)lists->pointCount * k;
+    lists->straightTasks.resize(cells);
+    lists->straightDistances.resize(cells);
+    if (lists->hasRoad) {
+        lists->roadTasks.resize(cells);
+        lists->roadDistances.resize(cells);
+    }
+
+    NeighborLists& out = *lists;
+    parallelFor(0, out.pointCount, problem.config.threadCount, [&](int point) {
+        NodeHandle from = point < out.taskCount ? NodeHandle{NodeKind::Task, false, point}
+                                                : NodeHandle{NodeKind::Center, false, point - out.taskCount};
+        double fromX, fromY;
+        handlePosition(problem, from, fromX, fromY);
+
+        thread_local vector<std::pair<double, int>> candidates;
+        candidates.clear();
+        for (int task = 0; task < out.taskCount; task++) {
+            if (from.kind == NodeKind::Task && task == point) continue;
+            // 与无人机候选点扫描相同的算式，距离逐位一致
+            double dx = problem.tasks[task].x - fromX;
+            double dy = problem.tasks[task].y - fromY;
+            candidates.push_back({std::sqrt(dx * dx + dy * dy), task});
+        }
+        size_t row = (size_t)point * out.k;
+        fillRow(candidates, out.k, &out.straightTasks[row], &out.straightDistances[row]);
+
+        if (!out.hasRoad) return;
+        for (auto& [distance, task] : candidates) {
+            distance = handleDistance(problem, from, {NodeKind::Task, false, task}, false);
+        }
+        fillRow(candidates, out.k, &out.roadTasks[row], &out.roadDistances[row]);
+    });
+    return lists;
+}
@@ -0,0 +1,262 @@
+#include "network_update.h"
+#include "shortest_path.h"
+#include "distance_rows.h"
+#include "time_dependent.h"
+#include "parallel.h"
+#include "traffic_feed.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using std::endl;
+
+// 判断 a + b 与 c 是否在浮点误差内相等（各距离来自不同的求和顺序）
+static bool nearlyEqual(double sum, double target)
+{
+    return std::abs(sum - target) <= 1e-9 * std::max(1.0, target);
+}
+
+static void setNextHop(NextHopMatrix &hops, size_t i, size_t j, int hop)
+{
+    size_t k = i * hops.nodeCount + j;
+    if (!hops.hops16.empty()) {
+        hops.hops16[k] = hop < 0 ? UINT16_MAX : hop;
+    } else {
+        hops.hops32[k] = hop;
+    }
+}
+
+// 把映射文件或紧凑存储中的矩阵还原为可写的稠密矩阵
+static void materializeMatrix(RouteNetwork &network)
+{
+    if (!network.mappedMatrix && network.compact.storage == MatrixStorage::Double) return;
+    size_t n = network.nodeCount;
+    std::vector<double> dense(n * n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            dense[i * n + j] = network.distanceAt(i, j);
+        }
+    }
+    network.distMatrix = std::move(dense);
+    network.mappedMatrix = nullptr;
+    network.matrixFile.reset();
+    network.compact = CompactDistanceMatrix();
+}
+
+// 交通快照只读（可能同时被交通数据发布点和其他读者持有），路网变化后复制一份：
+// 时变最短路换成新邻接表上的新实例，时段行驶时间表按新距离重建
+static std::shared_ptr<PeakFactorTable> rebuiltTrafficSnapshot(const PeakFactorTable &current, const RouteNetwork &network)
+{
+    auto traffic = std::make_shared<PeakFactorTable>(current);
+    if (traffic->timeDependent) {
+        traffic->timeDependent = traffic->timeDependent->rebuilt(
+            network.graph, traffic->lines ? *traffic->lines : std::vector<EdgePeakFactor>());
+    }
+    buildBandTravelTimes(*traffic, network);
+    return traffic;
+}
+
+// 更新路段并修复距离，不处理交通快照；长度变化时 distanceVersion 递增
+static bool updateDistances(RouteNetwork &network, int nodeId1, int nodeId2, double length, int threadCount)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    if (network.hierarchy) {
+        std::cerr << "收缩层次不支持增量更新路段，请重新构建" << endl;
+        return false;
+    }
+    if (nodeId1 == nodeId2 || !(length >= 0.0)) {
+        std::cerr << "无效的路段更新: " << nodeId1 << " - " << nodeId2 << ", 长度 " << length << endl;
+        return false;
+    }
+
+    if (network.graph.nodeCount == 0) network.graph = buildCsrGraph(network.edges);
+    CsrGraph oldGraph = std::move(network.graph);
+    int u = oldGraph.indexOf(nodeId1);
+    int v = oldGraph.indexOf(nodeId2);
+    if (u < 0 || v < 0) {
+        network.graph = std::move(oldGraph);
+        std::cerr << "路段端点不在路网中: " << nodeId1 << " - " << nodeId2 << endl;
+        return false;
+    }
+
+    // 当前生效的长度（CSR中重边已取最短）
+    double oldLength = inf;
+    for (int e = oldGraph.offsets[u]; e < oldGraph.offsets[u + 1]; e++) {
+        if (oldGraph.targets[e] == v) oldLength = oldGraph.weights[e];
+    }
+
+    // 更新边列表并重建邻接表
+    auto& edges = network.edges;
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const Edge& edge) {
+        return (edge.node1 == nodeId1 && edge.node2 == nodeId2) ||
+               (edge.node1 == nodeId2 && edge.node2 == nodeId1);
+    }), edges.end());
+    if (length != inf) edges.push_back({nodeId1, nodeId2, length});
+    network.graph = buildCsrGraph(edges);
+    if (length == oldLength) return true;
+    // 路段变短后原有的直线距离下界可能不再成立，需重新标定（calibrateEuclideanLowerBound），此前不剪枝
+    network.euclideanLowerBound = 0.0;
+    network.distanceVersion++;
+
+    if (network.lazyRows || network.nodeCount == 0) {
+        if (network.lazyRows) network.lazyRows->reset(network.graph);
+        return true;
+    }
+
+    // 修改前以两个端点为源点的最短距离（无向图，即各节点到端点的距离）
+    std::vector<double> distU, distV;
+    dijkstra(oldGraph, u, distU);
+    dijkstra(oldGraph, v, distV);
+
+    size_t n = network.nodeCount;
+    std::vector<int> oldSlot(n), newSlot(n);
+    for (size_t a = 0; a < n; a++) {
+        oldSlot[a] = oldGraph.indexOf(network.nodeIds[a]);
+        newSlot[a] = network.graph.indexOf(network.nodeIds[a]);
+    }
+
+    MatrixStorage storage = network.compact.storage;
+    materializeMatrix(network);
+    double* matrix = network.distMatrix.data();
+
+    // 记录了下一跳时，变短的情况也逐行重算，以便同时得到新的最短路树
+    bool recordHops = network.nextHop.nodeCount == (int)n;
+    if (length < oldLength && !recordHops) {
+        // 变短：新最短路至多经过该路段一次，d[a][b] = min(d[a][b], d[a][u]+w+d[v][b], d[a][v]+w+d[u][b])
+        parallelFor(0, (int)n, threadCount, [&](int a) {
+            int sa = oldSlot[a];
+            if (sa < 0) return;
+            double viaU = distU[sa] + length;  // a -> u -> v
+            double viaV = distV[sa] + length;  // a -> v -> u
+            if (viaU >= distV[sa] && viaV >= distU[sa]) return;  // 该行不经过新路段
+            double* row = matrix + (size_t)a * n;
+            for (size_t b = 0; b < n; b++) {
+                int sb = oldSlot[b];
+                if (sb < 0) continue;
+                double candidate = std::min(viaU + distV[sb], viaV + distU[sb]);
+                if (candidate < row[b]) row[b] = candidate;
+            }
+        });
+    } else {
+        // 变长或封路：只有以a为源的最短路树经过该路段的行可能变化；变短：只有经新路段更近的行变化
+        std::vector<int> affectedRows;
+        for (size_t a = 0; a < n; a++) {
+            int sa = oldSlot[a];
+            if (sa < 0) continue;
+            bool affected = length < oldLength
+                ? distU[sa] + length < distV[sa] || distV[sa] + length < distU[sa]
+                : nearlyEqual(distU[sa] + oldLength, distV[sa]) || nearlyEqual(distV[sa] + oldLength, distU[sa]);
+            if (affected) affectedRows.push_back(a);
+        }
+
+        std::vector<int> matrixSlot(network.graph.nodeCount, -1);  // CSR索引 -> 矩阵索引
+        for (size_t a = 0; a < n; a++) {
+            if (newSlot[a] >= 0) matrixSlot[newSlot[a]] = a;
+        }
+
+        // 受影响的行重新运行Dijkstra；路网无向，最短路树同时给出第a列的下一跳 next[b][a] = parent[b]
+        // （受影响的点对两端的行都会被重算，各线程只写各自的行与列）
+        parallelFor(0, (int)affectedRows.size(), threadCount, [&](int k) {
+            thread_local std::vector<double> dist;
+            thread_local std::vector<int> parent;
+            int a = affectedRows[k];
+            double* row = matrix + (size_t)a * n;
+            std::fill(row, row + n, inf);
+            row[a] = 0.0;
+            if (newSlot[a] >= 0) {
+                dijkstra(network.graph, newSlot[a], dist, nullptr, 0, recordHops ? &parent : nullptr);
+                for (size_t b = 0; b < n; b++) {
+                    if (newSlot[b] >= 0) row[b] = dist[newSlot[b]];
+                }
+            }
+            if (!recordHops) return;
+            for (size_t b = 0; b < n; b++) {
+                int hop = -1;
+                if (b == (size_t)a) {
+                    hop = a;
+                } else if (row[b] != inf) {
+                    hop = matrixSlot[parent[newSlot[b]]];
+                }
+                setNextHop(network.nextHop, b, a, hop);
+            }
+        });
+    }
+
+    compactDistanceMatrix(network, storage);
+#ifdef DEBUG_DISTANCE_MAP
+    buildDistanceMapView(network);
+#endif
+    return true;
+}
+
+bool updateRoadEdge(RouteNetwork &network, int nodeId1, int nodeId2, double length, int threadCount)
+{
+    uint64_t version = network.distanceVersion;
+    if (!updateDistances(network, nodeId1, nodeId2, length, threadCount)) return false;
+    if (network.distanceVersion != version && network.peakFactors) {
+        network.peakFactors = rebuiltTrafficSnapshot(*network.peakFactors, network);
+    }
+    return true;
+}
+
+bool updateRoadEdge(DeliveryProblem &problem, int nodeId1, int nodeId2, double length, int threadCount)
+{
+    if (!problem.trafficFeed) return updateRoadEdge(problem.network, nodeId1, nodeId2, length, threadCount);
+
+    RouteNetwork& network = problem.network;
+    uint64_t version = network.distanceVersion;
+    if (!updateDistances(network, nodeId1, nodeId2, length, threadCount)) return false;
+    if (network.distanceVersion == version || !network.peakFactors) return true;
+
+    // 先替换后台线程的输入，再在发布点的最新快照（可能含尚未 refreshTraffic 的新系数）上重建并发布；
+    // 期间后台线程发布了新版本时在其上重建，保证新系数和新路网都不丢失
+    problem.trafficFeed->setSnapshotInputs(std::make_shared<const TrafficSnapshotInputs>(captureTrafficInputs(problem)));
+    std::shared_ptr<const PeakFactorTable> published;
+    while (!published) {
+        std::shared_ptr<const PeakFactorTable> latest = problem.trafficFeed->snapshot();
+        auto table = rebuiltTrafficSnapshot(*latest, network);
+        std::shared_ptr<const PeakFactorTable> candidate = table;
+        if (problem.trafficFeed->publish(std::move(table), latest.get())) published = candidate;
+    }
+    network.peakFactors = published;
+    return true;
+}
+
+int addMatrixNode(RouteNetwork &network, int nodeId)
+{
+    int existing = network.indexOf(nodeId);
+    if (existing >= 0) return existing;
+    if (network.hierarchy || network.lazyRows || !network.nextHop.empty()) return -1;
+
+    if (network.graph.nodeCount == 0) network.graph = buildCsrGraph(network.edges);
+    const CsrGraph& graph = network.graph;
+    int source = graph.indexOf(nodeId);
+    if (source < 0) return -1;
+    std::vector<double> dist;
+    dijkstra(graph, source, dist);
+
+    MatrixStorage storage = network.compact.storage;
+    materializeMatrix(network);
+    size_t n = network.nodeCount, grown = n + 1;
+    std::vector<double> matrix(grown * grown);
+    for (size_t i = 0; i < n; i++) {
+        std::copy(network.distMatrix.begin() + i * n, network.distMatrix.begin() + (i + 1) * n, matrix.begin() + i * grown);
+    }
+    for (size_t j = 0; j < n; j++) {
+        double d = dist[graph.indexOf(network.nodeIds[j])];
+        matrix[j * grown + n] = d;
+        matrix[n * grown + j] = d;
+    }
+    matrix[n * grown + n] = 0.0;
+
+    network.distMatrix = std::move(matrix);
+    if (nodeId >= (int)network.nodeIndex.size()) network.nodeIndex.resize(nodeId + 1, -1);
+    network.nodeIndex[nodeId] = n;
+    network.nodeIds.push_back(nodeId);
+    network.nodeCount = grown;
+    compactDistanceMatrix(network, storage);
+#ifdef DEBUG_DISTANCE_MAP
+    buildDistanceMapView(network);
+#endif
+    return n;
+}
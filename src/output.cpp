@@ -0,0 +1,96 @@
+#include "output.h"
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+#include <unistd.h>
+
+// 写到标准输出文件描述符的缓冲区，sync（flush/endl）时整块写出
+class OutputBuffer : public std::streambuf
+{
+public:
+    OutputBuffer() { setp(buffer, buffer + sizeof(buffer)); }
+
+    int sync() override { return writeOut() ? 0 : -1; }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!writeOut()) return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    bool writeOut()
+    {
+        const char* data = pbase();
+        size_t remaining = pptr() - pbase();
+        while (remaining > 0) {
+            ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            remaining -= written;
+        }
+        setp(buffer, buffer + sizeof(buffer));
+        return true;
+    }
+
+    char buffer[1 << 16];
+};
+
+static Verbosity currentLevel = Verbosity::Normal;
+static OutputBuffer* sink = nullptr;       // 程序结束前一直有效，不析构（静态对象析构后仍可能有输出）
+static std::ostream nullStream(nullptr);   // 无缓冲区的流：写入直接失败，不做格式化
+static std::ostream* summaryStream = nullptr;
+
+void initOutput(Verbosity level)
+{
+    currentLevel = level;
+    if (!sink) {
+        sink = new OutputBuffer();
+        summaryStream = new std::ostream(sink);
+        std::atexit(flushOutput);
+    }
+    // 结果输出不再与C标准输出交替，std::cout 不必逐次同步
+    std::ios::sync_with_stdio(false);
+    std::cout.rdbuf(level == Verbosity::Quiet ? nullptr : sink);
+}
+
+Verbosity outputVerbosity()
+{
+    return currentLevel;
+}
+
+std::ostream& output(Verbosity level)
+{
+    if (level > currentLevel) return nullStream;
+    if (!std::cout.rdbuf() && summaryStream) {
+        // std::cout 已静音：沿用其格式设置（精度、定点等）写到同一缓冲区
+        summaryStream->copyfmt(std::cout);
+        return *summaryStream;
+    }
+    return std::cout;
+}
+
+void flushOutput()
+{
+    if (sink) sink->pubsync();
+    std::cout.flush();
+}
+
+bool ProgressThrottle::ready()
+{
+    if (currentLevel == Verbosity::Verbose) return true;
+    auto now = std::chrono::steady_clock::now();
+    if (started && std::chrono::duration<double>(now - last).count() < interval) return false;
+    started = true;
+    last = now;
+    return true;
+}
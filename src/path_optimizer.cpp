@@ -1,5 +1,10 @@
 #include "path_optimizer.h"
 #include "common.h"
+#include "travel_time.h"
+#include "time_dependent.h"
+#include "drone_kernel.h"
+#include "spatial_index.h"
+#include "neighbor_lists.h"
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -7,12 +12,170 @@
 #include <set>
 #include <unordered_map>
 #include <iterator>
+#include <optional>
 
 using std::vector;
 using std::numeric_limits;
 using std::unordered_map;
 using std::pair;
 
+// 无人机最近邻构造的候选点扫描暂存区，每个线程一份，各条路线复用
+struct DroneScanBuffers
+{
+    DroneCandidates candidates;
+    vector<double> distance;
+    vector<uint8_t> status;
+};
+
+static DroneScanBuffers& droneScanBuffers()
+{
+    thread_local DroneScanBuffers buffers;
+    return buffers;
+}
+
+// 路线构造开始时建立候选点数组；useArrivalTime 时额外需求点以出现时间为最早可访问时刻
+static DroneScanBuffers& prepareDroneScan(const DeliveryProblem& problem, const vector<TaskPoint>& tasks,
+                                          const vector<NodeHandle>& taskHandles, NodeHandle centerHandle,
+                                          double speed, bool useArrivalTime)
+{
+    DroneScanBuffers& scan = droneScanBuffers();
+    DroneCandidates& candidates = scan.candidates;
+    candidates.resize(taskHandles.size());
+    scan.distance.resize(taskHandles.size());
+    scan.status.resize(taskHandles.size());
+    for (size_t i = 0; i < taskHandles.size(); i++) {
+        const TaskPoint& task = tasks[taskHandles[i].index];
+        handlePosition(problem, taskHandles[i], candidates.x[i], candidates.y[i]);
+        candidates.returnTime[i] = handleDistance(problem, taskHandles[i], centerHandle, true) / speed;
+        candidates.sendWeight[i] = task.sendWeight;
+        candidates.pickWeight[i] = task.pickweight;
+        bool extra = useArrivalTime && taskHandles[i].index >= problem.initialDemandCount;
+        candidates.readyTime[i] = extra ? task.arrivaltime : -numeric_limits<double>::infinity();
+    }
+    return scan;
+}
+
+// 路线任务数达到阈值且已标定直线距离下界时，车辆的最近邻构造改用网格索引选点
+static bool useTaskGrid(const DeliveryProblem& problem, size_t taskCount)
+{
+    int threshold = problem.config.spatialIndexMinTasks;
+    return threshold > 0 && taskCount >= (size_t)threshold && problem.network.euclideanLowerBound > 0;
+}
+
+static TaskGrid buildTaskGrid(const DeliveryProblem& problem, const vector<NodeHandle>& taskHandles)
+{
+    vector<double> x(taskHandles.size()), y(taskHandles.size());
+    for (size_t i = 0; i < taskHandles.size(); i++) {
+        handlePosition(problem, taskHandles[i], x[i], y[i]);
+    }
+    return TaskGrid(x, y);
+}
+
+// 网格中路网距离最近且满足 accept 的任务点，没有时返回-1：直线距离的下界已超过当前最优值的点不读取路网距离；
+// 距离相同时取下标最小者，与按下标顺序扫描、严格小于才替换的结果一致
+template <typename Accept>
+static int nearestByRoad(const DeliveryProblem& problem, const TaskGrid& grid, NodeHandle from,
+                         const vector<NodeHandle>& taskHandles, double& minDistance, Accept&& accept)
+{
+    double factor = problem.network.euclideanLowerBound;
+    double fromX, fromY;
+    handlePosition(problem, from, fromX, fromY);
+    int nearest = -1;
+    minDistance = numeric_limits<double>::max();
+    grid.search(fromX, fromY, [&](int i, double straight) {
+        if (factor * straight > minDistance) return;
+        double distance = handleDistance(problem, from, taskHandles[i], false);
+        bool closer = distance < minDistance || (distance == minDistance && i < nearest);
+        if (closer && accept(i)) {
+            minDistance = distance;
+            nearest = i;
+        }
+    }, [&](double ringDistance) { return factor * ringDistance <= minDistance; });
+    return nearest;
+}
+
+// 路线构造中按当前位置的近邻表选点。任务下标 -> 路线内序号的映射每个线程一份，路线构造结束时复原；
+// 近邻表不可用、或路线中同一任务出现多次（近邻表中每个任务只列一次）时不启用
+class RouteNeighbors
+{
+public:
+    RouteNeighbors(const DeliveryProblem& problem, const vector<NodeHandle>& taskHandles, bool road)
+        : taskHandles(taskHandles)
+    {
+        const NeighborLists* candidate = problem.neighbors.get();
+        if (!candidate || !(road ? candidate->roadUsable(problem) : candidate->straightUsable(problem))) return;
+        vector<int>& local = localOf();
+        if (local.size() < problem.tasks.size()) local.resize(problem.tasks.size(), -1);
+        for (size_t i = 0; i < taskHandles.size(); i++) {
+            const NodeHandle& handle = taskHandles[i];
+            if (handle.kind != NodeKind::Task || !handle.valid() || local[handle.index] != -1) {
+                reset(i);
+                return;
+            }
+            local[handle.index] = (int)i;
+        }
+        lists = candidate;
+        tasks = road ? lists->roadTasks.data() : lists->straightTasks.data();
+        distances = road ? lists->roadDistances.data() : lists->straightDistances.data();
+    }
+    ~RouteNeighbors() { if (lists) reset(taskHandles.size()); }
+    RouteNeighbors(const RouteNeighbors&) = delete;
+    RouteNeighbors& operator=(const RouteNeighbors&) = delete;
+
+    bool active() const { return lists != nullptr; }
+
+    // from 的近邻表中最近且满足 accept 的路线任务点（路线内序号），距离相同时取序号最小者，与顺序扫描严格小于才替换的结果一致。
+    // 表中的点都不满足、或与最近点并列的点可能排在表外时返回-1，由调用方完整扫描
+    template <typename Accept>
+    int nearest(NodeHandle from, double& minDistance, Accept&& accept) const
+    {
+        const vector<int>& local = localOf();
+        int best = -1;
+        double bestDistance = 0.0;
+        // 当前位置本身在路线中时与自身距离为0，它不在自己的近邻表中
+        if (from.kind == NodeKind::Task && local[from.index] >= 0 && accept(local[from.index])) {
+            best = local[from.index];
+        }
+        size_t row = (size_t)lists->pointOf(from) * lists->k;
+        for (int n = 0; n < lists->k; n++) {
+            int task = tasks[row + n];
+            if (task < 0) break;    // 表中已列出全部任务点
+            double distance = distances[row + n];
+            if (best != -1 && distance > bestDistance) break;
+            // 不可达的点顺序扫描也不会选中，交给完整扫描确认
+            if (!(distance < numeric_limits<double>::max())) return -1;
+            int i = local[task];
+            if (i < 0 || (best != -1 && i > best)) continue;
+            if (accept(i)) {
+                best = i;
+                bestDistance = distance;
+            }
+        }
+        bool decided = best != -1 && (tasks[row + lists->k - 1] < 0 || distances[row + lists->k - 1] > bestDistance);
+        if (!decided) return -1;
+        minDistance = bestDistance;
+        return best;
+    }
+
+private:
+    static vector<int>& localOf()
+    {
+        thread_local vector<int> local;
+        return local;
+    }
+
+    void reset(size_t count)
+    {
+        vector<int>& local = localOf();
+        for (size_t i = 0; i < count; i++) local[taskHandles[i].index] = -1;
+    }
+
+    const vector<NodeHandle>& taskHandles;
+    const NeighborLists* lists = nullptr;
+    const int* tasks = nullptr;
+    const double* distances = nullptr;
+};
+
 // 使用最近邻法优化静态阶段的配送路径
 vector<int> optimizePathForVehicle(
     const vector<int> &assignedTaskIds,  // 任务ID列表
@@ -29,6 +192,10 @@ vector<int> optimizePathForVehicle(
     
     // 检查是否为drone（drone有最大载重限制）
     bool isDrone = (vehicle.maxLoad > 0);
+
+    // 对外ID只在此解析一次，下面的最近邻循环按句柄计算距离
+    NodeHandle centerHandle = resolveNodeHandle(problem, centerId);
+    vector<NodeHandle> taskHandles = resolveNodeHandles(problem, assignedTaskIds);
     
     if (!isDrone) {
         // 普通车辆使用原来的最近邻算法
@@ -37,41 +204,58 @@ vector<int> optimizePathForVehicle(
         
         // 从配送中心开始
         path.push_back(centerId);
-        int currentPos = centerId;
+        NodeHandle currentPos = centerHandle;
         
         const int MAX_ITERATIONS = 1000; // 设置合理的最大迭代次数
         int iteration = 0;
         
+        // 任务较多时按网格由近到远查询，只读取直线距离下界不超过当前最优值的点的路网距离
+        std::optional<TaskGrid> grid;
+        if (useTaskGrid(problem, assignedTaskIds.size())) grid.emplace(buildTaskGrid(problem, taskHandles));
+        RouteNeighbors neighbors(problem, taskHandles, true);
+        
         // 根据距离选择下一个访问点，直到所有点都被访问
-        while (anyTaskUnvisited(visited, assignedTaskIds) && iteration < MAX_ITERATIONS) {
+        auto unvisited = [&] { return grid ? grid->remaining() > 0 : anyTaskUnvisited(visited, assignedTaskIds); };
+        while (unvisited() && iteration < MAX_ITERATIONS) {
             iteration++;
             
             double minDistance = std::numeric_limits<double>::max();
             int nextIndex = -1;
             int nextId = -1;
             
-            for (size_t i = 0; i < assignedTaskIds.size(); i++) {
-                if (!visited[i]) {
-                    int taskId = assignedTaskIds[i];
+            // 先查当前位置的近邻表，表中没有可选的点时再用网格或顺序扫描
+            if (neighbors.active()) {
+                nextIndex = neighbors.nearest(currentPos, minDistance, [&](int i) { return !visited[i]; });
+                if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+            }
+            if (nextIndex == -1 && grid) {
+                nextIndex = nearestByRoad(problem, *grid, currentPos, taskHandles, minDistance, [](int) { return true; });
+                if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+            } else if (nextIndex == -1) {
+                for (size_t i = 0; i < assignedTaskIds.size(); i++) {
+                    if (!visited[i]) {
+                        int taskId = assignedTaskIds[i];
                     
-                    double distance = getDistance(
-                        currentPos, 
-                        taskId, 
-                        problem,
-                        false); // 非drone
+                        double distance = handleDistance(
+                            problem,
+                            currentPos, 
+                            taskHandles[i], 
+                            false); // 非drone
                     
-                    if (distance < minDistance) {
-                        minDistance = distance;
-                        nextIndex = i;
-                        nextId = taskId;
+                        if (distance < minDistance) {
+                            minDistance = distance;
+                            nextIndex = i;
+                            nextId = taskId;
+                        }
                     }
                 }
             }
             
             if (nextIndex != -1) {
                 visited[nextIndex] = true;
+                if (grid) grid->remove(nextIndex);
                 path.push_back(nextId);
-                currentPos = nextId;
+                currentPos = taskHandles[nextIndex];
             } else {
                 break;  // 无法找到下一个点，结束
             }
@@ -97,13 +281,15 @@ vector<int> optimizePathForVehicle(
         
         // 从配送中心开始
         path.push_back(centerId);
-        int currentPos = centerId;
+        NodeHandle currentPos = centerHandle;
         
         // drone初始状态
         double currentBattery = vehicle.maxfuel; // 满电量
         double currentLoad = 0.0; // 初始载重为0
         double maxProcessLoad = 0.0; // 一次行程中的最大载重
-        
+        DroneScanBuffers& scan = prepareDroneScan(problem, tasks, taskHandles, centerHandle, vehicle.speed, false);
+        RouteNeighbors neighbors(problem, taskHandles, false);
+
         const int MAX_ITERATIONS = 1000; // 设置合理的最大迭代次数
         int iteration = 0;
         
@@ -113,69 +299,46 @@ vector<int> optimizePathForVehicle(
             double minDistance = std::numeric_limits<double>::max();
             int nextIndex = -1;
             int nextId = -1;
-            // 寻找满足约束的最近任务点
-            for (size_t i = 0; i < assignedTaskIds.size(); i++) {
-                if (!visited[i]) {
-                    int taskId = assignedTaskIds[i];
-                    int taskIndex = problem.taskIdToIndex.at(taskId);
-                    const TaskPoint& task = tasks[taskIndex];
-                    
-                    // 计算到该任务点的距离
-                    double distanceToTask = getDistance(currentPos, taskId, problem, true);
-                    
-                    // 计算从该任务点到配送中心的距离
-                    double distanceToCenter = getDistance(taskId, centerId, problem, true);
-                    
-                    // 计算所需电量
-                    double batteryNeededToTask = distanceToTask / vehicle.speed;
-                    double batteryNeededToCenter = distanceToCenter / vehicle.speed;
-                    double totalBatteryNeeded = batteryNeededToTask + batteryNeededToCenter;
-                    
-                    // 检查电量约束
-                    if (totalBatteryNeeded > currentBattery) {
-                        continue; // 电量不足，跳过该任务点
-                    }
-                    
-                    // 添加10%最低电量约束 - 确保离开任务点后仍有至少10%的续航能力
-                    double minRequiredBattery = vehicle.maxfuel * 0.1; // 10%的最大电量
-                    if ((currentBattery - batteryNeededToTask) < minRequiredBattery) {
-                        continue; // 剩余电量不足10%，跳过该任务点
-                    }
-                    
-                    // 检查载重约束
-                    if (task.sendWeight > 0) {
-                        // 送货点：检查过程最大载重 + 送货重量是否超过最大载重
-                        if (maxProcessLoad + task.sendWeight > vehicle.maxLoad) {
-                            continue; // 超过载重限制，跳过该任务点
-                        }
-                    }
-                    if (task.pickweight > 0) {
-                        // 取货点：检查当前载重 + 取货重量是否超过最大载重
-                        if (currentLoad + task.pickweight > vehicle.maxLoad) {
-                            continue; // 超过载重限制，跳过该任务点
-                        }
-                    }
-                    
-                    
+            // 寻找满足约束的最近任务点：电量（含直飞回配送中心、保留10%最低电量）与载重约束由扫描一次算完
+            DroneScanState state = {};
+            handlePosition(problem, currentPos, state.fromX, state.fromY);
+            state.speed = vehicle.speed;
+            state.battery = currentBattery;
+            state.minBattery = vehicle.maxfuel * 0.1; // 10%的最大电量
+            state.time = 0.0;
+            state.load = currentLoad;
+            state.maxProcessLoad = maxProcessLoad;
+            state.maxLoad = vehicle.maxLoad;
+            // 先逐个检查近邻表中的点，表中没有可行的点时再扫描全部候选点
+            if (neighbors.active()) {
+                nextIndex = neighbors.nearest(currentPos, minDistance, [&](int i) {
+                    double distance;
+                    return droneCandidateStatus(scan.candidates, state, i, distance) == CandidateFeasible;
+                });
+                if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+            }
+            if (nextIndex == -1) {
+                scanDroneCandidates(scan.candidates, state, scan.distance.data(), scan.status.data());
+                for (size_t i = 0; i < assignedTaskIds.size(); i++) {
                     // 如果满足所有约束，并且距离小于当前最小距离，更新最近任务点
-                    if (distanceToTask < minDistance) {
-                        minDistance = distanceToTask;
+                    if (scan.status[i] == CandidateFeasible && scan.distance[i] < minDistance) {
+                        minDistance = scan.distance[i];
                         nextIndex = i;
-                        nextId = taskId;
+                        nextId = assignedTaskIds[i];
                     }
                 }
             }
-            
+
             // 如果找到下一个可行的任务点
             if (nextIndex != -1) {
-                int taskIndex = problem.taskIdToIndex.at(nextId);
-                const TaskPoint& nextTask = tasks[taskIndex];
-                double distanceToNext = getDistance(currentPos, nextId, problem, true);
-                
+                const TaskPoint& nextTask = tasks[taskHandles[nextIndex].index];
+                double distanceToNext = handleDistance(problem, currentPos, taskHandles[nextIndex], true);
+
                 // 更新状态
                 visited[nextIndex] = true;
+                scan.candidates.readyTime[nextIndex] = numeric_limits<double>::infinity();
                 path.push_back(nextId);
-                currentPos = nextId;
+                currentPos = taskHandles[nextIndex];
                 
                 // 更新电量（距离/速度 = 消耗的小时数）
                 currentBattery -= distanceToNext / vehicle.speed;
@@ -189,13 +352,13 @@ vector<int> optimizePathForVehicle(
                 
             } else {
                 // 如果没有找到可行的下一个任务点，返回配送中心
-                double distanceToCenter = getDistance(currentPos, centerId, problem, true);
+                double distanceToCenter = handleDistance(problem, currentPos, centerHandle, true);
                 
                 // 检查是否有足够电量返回
                 if (currentBattery >= distanceToCenter / vehicle.speed) {
                     path.push_back(centerId);
                     // 回到配送中心后重置状态
-                    currentPos = centerId;
+                    currentPos = centerHandle;
                     currentBattery = vehicle.maxfuel; // 充满电
                     currentLoad = 0.0; // 卸货
                     maxProcessLoad = 0.0; // 重置过程最大载重
@@ -208,8 +371,8 @@ vector<int> optimizePathForVehicle(
         }
         
         // 如果当前不在配送中心，添加返回配送中心的路径
-        if (currentPos != centerId) {
-            double distanceToCenter = getDistance(currentPos, centerId, problem, true);
+        if (currentPos != centerHandle) {
+            double distanceToCenter = handleDistance(problem, currentPos, centerHandle, true);
             
             // 检查是否有足够电量返回
             if (currentBattery >= distanceToCenter / vehicle.speed) {
@@ -245,32 +408,43 @@ bool anyTaskUnvisited(const vector<bool>& visited, const vector<int>& taskIds) {
 }
 
 
+static thread_local const PeakFactorTable* pinnedTraffic = nullptr;
+
+TrafficPin::TrafficPin(const DeliveryProblem &problem)
+    : outermost(pinnedTraffic == nullptr)
+{
+    if (!outermost) return;
+    snapshot = problem.network.peakFactors;
+    pinnedTraffic = snapshot.get();
+}
+
+TrafficPin::~TrafficPin()
+{
+    if (outermost) pinnedTraffic = nullptr;
+}
+
+const PeakFactorTable* activeTraffic(const DeliveryProblem &problem)
+{
+    return pinnedTraffic ? pinnedTraffic : problem.network.peakFactors.get();
+}
+
 // 根据时间和路段判断是否处于高峰期，返回速度系数
 double getSpeedFactor(double currentTime, int fromId, int toId, const DeliveryProblem& problem) {
-    // 转换为小时数
-    double hour = currentTime;
-
-    // 先判断是否在高峰期
-    bool isMorningPeak = (hour >= DeliveryProblem::MORNING_PEAK_START && hour <= DeliveryProblem::MORNING_PEAK_END);
-    bool isEveningPeak = (hour >= DeliveryProblem::EVENING_PEAK_START && hour <= DeliveryProblem::EVENING_PEAK_END);
+    // 判断所在时段
+    TimeBand band = timeBandAt(problem.travelProfile, currentTime);
+    bool isMorningPeak = band == MorningPeak;
     
     // 如果不在高峰期，直接返回1.0
-    if (!isMorningPeak && !isEveningPeak) {
+    if (band == OffPeak) {
         return 1.0;
     }
     
     // 在高峰期，尝试获取特定路段的高峰期系数
-    auto it1 = problem.network.peakFactors.find(fromId);
-    if (it1 != problem.network.peakFactors.end()) {
-        auto it2 = it1->second.find(toId);
-        if (it2 != it1->second.end()) {
-            // 根据高峰期返回对应系数
-            if (isMorningPeak) {
-                return it2->second.first;  // 早高峰系数
-            } else {
-                return it2->second.second;  // 晚高峰系数
-            }
-        }
+    const PeakFactorTable* traffic = activeTraffic(problem);
+    const PeakFactor* factor = traffic ? traffic->find(fromId, toId) : nullptr;
+    if (factor) {
+        // 根据高峰期返回对应系数
+        return isMorningPeak ? factor->morning : factor->evening;
     }
     
     // 获取不到特定路段系数，使用默认系数
@@ -289,17 +463,17 @@ vector<double> calculateCompletionTimes(
     const DeliveryProblem& problem,
     bool considerTraffic)
 {
+    TrafficPin traffic(problem);  // 整条路线使用同一版交通系数
     if (path.size() <= 2) {
         return {0.0, 0.0};
     }
     
     vector<double> completionTimes(path.size(), 0.0);
     double currentTime = 0.0;
+    vector<NodeHandle> handles = resolveNodeHandles(problem, path);
     
     // 遍历路径中的每一段
     for (size_t i = 0; i < path.size() - 1; i++) {
-        int fromId = path[i];
-        int toId = path[i+1];
         
         // // 计算距离
         // double distance = getDistance(fromId, toId, problem, vehicle.maxLoad > 0);
@@ -313,7 +487,7 @@ vector<double> calculateCompletionTimes(
         
         // // 计算当前段的行驶时间
         // double travelTime = distance / speed;
-        double travelTime = calculateTimeNeeded(fromId, toId, currentTime, vehicle, problem, considerTraffic, vehicle.maxLoad > 0);
+        double travelTime = calculateTimeNeeded(handles[i], handles[i+1], currentTime, vehicle, problem, considerTraffic, vehicle.maxLoad > 0);
         // 更新当前时间
         currentTime += travelTime;
         
@@ -328,7 +502,8 @@ vector<double> calculateCompletionTimes(
 // 优化动态阶段的所有路径 - 实现车机协同
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> optimizeDynamicPaths(
     const DeliveryProblem& problem,
-    const std::vector<std::pair<int, int>>& dynamicAssignments // (车辆ID, 任务ID)对
+    const std::vector<std::pair<int, int>>& dynamicAssignments, // (车辆ID, 任务ID)对
+    const RouteSink& onRouteFinal
 )
 {
     // 按车辆ID收集任务
@@ -360,7 +535,8 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> optimi
                 problem
             );
             
-            // 保存路径和时间
+            // 保存路径和时间；无人机协同只读取车辆的到达时间，不改变车辆路径，此时即可交给调度
+            if (onRouteFinal) onRouteFinal(vehicleId, path, times);
             dynamicPaths[vehicleId] = {path, times};
             
             // 记录任务点访问信息
@@ -420,6 +596,10 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> optimi
             // 空路径
             dynamicPaths[droneId] = {{drone.centerId, drone.centerId}, {0.0, 0.0}};
         }
+        if (onRouteFinal) {
+            const auto& [path, times] = dynamicPaths[droneId];
+            onRouteFinal(droneId, path, times);
+        }
     }
     
     return dynamicPaths;
@@ -432,6 +612,7 @@ std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
     const Vehicle &vehicle,
     const DeliveryProblem& problem)
 {
+    TrafficPin traffic(problem);  // 整条路线使用同一版交通系数
     if (assignedTaskIds.empty()) {
         return {{vehicle.centerId, vehicle.centerId}, {0.0, 0.0}};
     }
@@ -445,46 +626,70 @@ std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
     path.push_back(centerId);
     times.push_back(0.0); // 初始时间
     
-    int currentPos = centerId;
+    NodeHandle centerHandle = resolveNodeHandle(problem, centerId);
+    std::vector<NodeHandle> taskHandles = resolveNodeHandles(problem, assignedTaskIds);
+    NodeHandle currentPos = centerHandle;
     double currentTime = 0.0;
     
     // 添加最大迭代次数限制
     int maxIterations = assignedTaskIds.size() * 3;
     int iterations = 0;
 
+    // 任务较多时按网格由近到远查询，只对可能成为最近点的任务读取路网距离并检查出现时间
+    std::optional<TaskGrid> grid;
+    if (useTaskGrid(problem, assignedTaskIds.size())) grid.emplace(buildTaskGrid(problem, taskHandles));
+    RouteNeighbors neighbors(problem, taskHandles, true);
     
     // 根据距离选择下一个访问点，直到所有点都被访问
-    while (anyTaskUnvisited(visited, assignedTaskIds) && iterations < maxIterations) {
+    auto unvisited = [&] { return grid ? grid->remaining() > 0 : anyTaskUnvisited(visited, assignedTaskIds); };
+    while (unvisited() && iterations < maxIterations) {
         iterations++;
         
         double minDistance = std::numeric_limits<double>::max();
         int nextIndex = -1;
         int nextId = -1;
         
-        // 寻找满足约束的下一个任务点
-        for (size_t i = 0; i < assignedTaskIds.size(); i++) {
-            if (!visited[i]) {
-                int taskId = assignedTaskIds[i];
-                int taskIndex = problem.taskIdToIndex.at(taskId);
-                const TaskPoint& task = tasks[taskIndex];
-                
-                double distance = getDistance(currentPos, taskId, problem, false);
-                
-                // 考虑高峰期对速度的影响
-                //double speedFactor = getSpeedFactor(currentTime, currentPos, taskId, problem);
-                //double timeToTask = distance / (vehicle.speed * speedFactor);
-                double timeToTask = calculateTimeNeeded(currentPos, taskId, currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
-                
-                // 添加额外需求点到达时间约束
-                if (taskIndex >= problem.initialDemandCount && 
-                    currentTime + timeToTask + 0.000001 < task.arrivaltime) {
-                    continue; // 额外需求点尚未到达，不能访问
-                }
-                
-                if (distance < minDistance) {
-                    minDistance = distance;
-                    nextIndex = i;
-                    nextId = taskId;
+        // 与下面的顺序扫描相同的出现时间约束
+        auto released = [&](int i) {
+            int taskIndex = taskHandles[i].index;
+            if (taskIndex < problem.initialDemandCount) return true;
+            double timeToTask = calculateTimeNeeded(currentPos, taskHandles[i], currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
+            return !(currentTime + timeToTask + 0.000001 < tasks[taskIndex].arrivaltime);
+        };
+        // 先查当前位置的近邻表，表中没有可选的点时再用网格或顺序扫描
+        if (neighbors.active()) {
+            nextIndex = neighbors.nearest(currentPos, minDistance, [&](int i) { return !visited[i] && released(i); });
+            if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+        }
+        if (nextIndex == -1 && grid) {
+            nextIndex = nearestByRoad(problem, *grid, currentPos, taskHandles, minDistance, released);
+            if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+        } else if (nextIndex == -1) {
+            // 寻找满足约束的下一个任务点
+            for (size_t i = 0; i < assignedTaskIds.size(); i++) {
+                if (!visited[i]) {
+                    int taskId = assignedTaskIds[i];
+                    int taskIndex = taskHandles[i].index;
+                    const TaskPoint& task = tasks[taskIndex];
+                    
+                    double distance = handleDistance(problem, currentPos, taskHandles[i], false);
+                    
+                    // 考虑高峰期对速度的影响
+                    //double speedFactor = getSpeedFactor(currentTime, currentPos, taskId, problem);
+                    //double timeToTask = distance / (vehicle.speed * speedFactor);
+                    double timeToTask = calculateTimeNeeded(currentPos, taskHandles[i], currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
+                    
+                    // 添加额外需求点到达时间约束
+                    if (taskIndex >= problem.initialDemandCount && 
+                        currentTime + timeToTask + 0.000001 < task.arrivaltime) {
+                        continue; // 额外需求点尚未到达，不能访问
+                    }
+                    
+                    if (distance < minDistance) {
+                        minDistance = distance;
+                        nextIndex = i;
+                        nextId = taskId;
+                    }
                 }
             }
         }
@@ -492,16 +697,17 @@ std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
         if (nextIndex != -1) {
             // 更新路径和状态
             visited[nextIndex] = true;
+            if (grid) grid->remove(nextIndex);
             path.push_back(nextId);
             
             // 考虑高峰期影响，计算实际行驶时间
             //double speedFactor = getSpeedFactor(currentTime, currentPos, nextId, problem);
             //double timeNeeded = minDistance / (vehicle.speed * speedFactor);
-            double timeNeeded = calculateTimeNeeded(currentPos, nextId, currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
+            double timeNeeded = calculateTimeNeeded(currentPos, taskHandles[nextIndex], currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
             
             // 更新当前时间和位置
             currentTime += timeNeeded;
-            currentPos = nextId;
+            currentPos = taskHandles[nextIndex];
             
             // 记录到达时间
             times.push_back(currentTime);
@@ -514,7 +720,7 @@ std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
             for (size_t i = 0; i < assignedTaskIds.size(); i++) {
                 if (!visited[i]) {
                     int taskId = assignedTaskIds[i];
-                    int taskIndex = problem.taskIdToIndex.at(taskId);
+                    int taskIndex = taskHandles[i].index;
                     const TaskPoint& task = tasks[taskIndex];
                     
                     if (taskIndex >= problem.initialDemandCount && task.arrivaltime < earliestArrivalTime) {
@@ -527,19 +733,20 @@ std::pair<std::vector<int>, std::vector<double>> Dynamic_OptimizePathForVehicle(
             times.push_back(earliestArrivalTime);
             path.push_back(earliestExtraDemandId);
             visited[earliestExtraDemandIndex] = true;
+            if (grid) grid->remove(earliestExtraDemandIndex);
             currentTime = earliestArrivalTime;
-            currentPos = earliestExtraDemandId;
+            currentPos = taskHandles[earliestExtraDemandIndex];
         }
     }
     
     // 返回配送中心
-    if (currentPos != centerId) {
+    if (currentPos != centerHandle) {
         path.push_back(centerId);
         
         //double distance = getDistance(currentPos, centerId, problem, false);
         //double speedFactor = getSpeedFactor(currentTime, currentPos, centerId, problem);
         //double timeNeeded = distance / (vehicle.speed * speedFactor);
-        double timeNeeded = calculateTimeNeeded(currentPos, centerId, currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
+        double timeNeeded = calculateTimeNeeded(currentPos, centerHandle, currentTime, vehicle, problem, true, vehicle.maxLoad > 0);
         
         currentTime += timeNeeded;
         times.push_back(currentTime);
@@ -567,6 +774,7 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
     const DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<int, double>>& taskVisitInfo
 ) {
+    TrafficPin traffic(problem);  // 整条路线使用同一版交通系数
     if (assignedTaskIds.empty()) {
         return {{drone.centerId, drone.centerId}, {0.0, 0.0}};
     }
@@ -574,9 +782,24 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
     std::vector<int> path;
     std::vector<double> times;  // 添加时间记录
     std::vector<bool> visited(assignedTaskIds.size(), false);
-    int currentPos = drone.centerId;
-    path.push_back(currentPos);
+    path.push_back(drone.centerId);
     times.push_back(0.0);  // 初始时间为0
+
+    // 对外ID只在此解析一次；车辆经过点按 taskVisitInfo 的遍历顺序展开为数组
+    NodeHandle centerHandle = resolveNodeHandle(problem, drone.centerId);
+    std::vector<NodeHandle> taskHandles = resolveNodeHandles(problem, assignedTaskIds);
+    struct VisitPoint
+    {
+        NodeHandle handle;
+        int taskId;
+        double vehicleArrivalTime;
+    };
+    std::vector<VisitPoint> visitPoints;
+    visitPoints.reserve(taskVisitInfo.size());
+    for (const auto& [visitTaskId, info] : taskVisitInfo) {
+        visitPoints.push_back({resolveNodeHandle(problem, visitTaskId), visitTaskId, info.second});
+    }
+    NodeHandle currentPos = centerHandle;
     
     double currentBattery = drone.maxfuel;
     double currentLoad = 0.0;
@@ -587,6 +810,8 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
     int maxIterations = assignedTaskIds.size() * 3;
     int iterations = 0;
     bool backpoint_iscenter = true;
+    DroneScanBuffers& scan = prepareDroneScan(problem, tasks, taskHandles, centerHandle, drone.speed, true);
+    RouteNeighbors neighbors(problem, taskHandles, false);
     
     // 当还有未访问的任务点时继续循环
     while (anyTaskUnvisited(visited, assignedTaskIds) && iterations < maxIterations) {
@@ -595,85 +820,64 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
         int nextIndex = -1;
         int nextId = -1;
         
-        // 寻找满足约束的下一个任务点
-        for (size_t i = 0; i < assignedTaskIds.size(); i++) {
-            if (visited[i]) continue;
-            
-            int taskId = assignedTaskIds[i];
-            int taskIndex = problem.taskIdToIndex.at(taskId);
-            const TaskPoint& task = tasks[taskIndex];
-            
-            // 检查载重约束
-            if (task.sendWeight > 0) {
-                if (maxProcessLoad + task.sendWeight > drone.maxLoad) continue;
-            }
-            if (task.pickweight > 0) {
-                if (currentLoad + task.pickweight > drone.maxLoad) continue;
-            }
-            
-            // 计算到任务点的距离和电量需求
-            double distanceToTask = getDistance(currentPos, taskId, problem, true);
-            double batteryNeededToTask = distanceToTask / drone.speed;
-            
-            
-            // 添加额外需求点到达时间约束
-            if (taskIndex >= problem.initialDemandCount && currentTime + batteryNeededToTask + 0.000001 < task.arrivaltime) {
-                //精度问题，给我坑惨了，调了一晚上 + 0.000001
-                continue; // 额外需求点尚未到达，不能访问
-            }
-            
-            // 检查电量是否足够到达任务点
-            if (batteryNeededToTask > currentBattery) continue;
-            
-            
-            // 检查从任务点是否有可行的返回点
-            bool canReturn = false;
-            
-            // 首先检查是否可以返回原配送中心
-            double distanceToOriginalCenter = getDistance(taskId, drone.centerId, problem, true);
-            double batteryToOriginalCenter = distanceToOriginalCenter / drone.speed;
-            
-            // 添加10%最低电量约束 - 确保离开任务点后仍有至少10%的续航能力
-            double minRequiredBattery = drone.maxfuel * 0.1; // 10%的最大电量
-            double remainingBatteryAfterTask = currentBattery - batteryNeededToTask;
-            
-            
-            // 如果剩余电量低于10%的门槛，跳过这个任务点
-            if (remainingBatteryAfterTask < minRequiredBattery) continue;
-            
-            
-            if (batteryNeededToTask + batteryToOriginalCenter <= currentBattery) {
-                canReturn = true;
-            }
-            
-            // 如果不能返回原配送中心，则检查是否可以返回车辆经过的任务点
-            if (!canReturn) {
-                for (const auto& [visitTaskId, info] : taskVisitInfo) {
-                    // 跳过当前检查的任务点
-                    if (visitTaskId == taskId) continue;
-                    
-                    double distanceToVisitPoint = getDistance(taskId, visitTaskId, problem, true);
-                    double batteryToVisitPoint = distanceToVisitPoint / drone.speed;
-                    double arrivalTime = currentTime + batteryNeededToTask + batteryToVisitPoint;
-                    
-                    // 如果drone能到达该点，且在车辆到达前抵达
-                    if (batteryNeededToTask + batteryToVisitPoint <= currentBattery && 
-                        arrivalTime < info.second) {
-                        canReturn = true;
-                        break; // 只要找到一个可行的返回点即可
-                    }
+        // 寻找满足约束的下一个任务点：载重、额外需求点出现时间（含0.000001的精度余量）、
+        // 电量（保留10%最低电量）约束与能否直飞回原配送中心由扫描一次算完
+        DroneScanState state = {};
+        handlePosition(problem, currentPos, state.fromX, state.fromY);
+        state.speed = drone.speed;
+        state.battery = currentBattery;
+        state.minBattery = drone.maxfuel * 0.1; // 10%的最大电量
+        state.time = currentTime;
+        state.load = currentLoad;
+        state.maxProcessLoad = maxProcessLoad;
+        state.maxLoad = drone.maxLoad;
+        // 不能直飞回原配送中心时，检查能否飞往车辆经过的任务点（在车辆到达前抵达）
+        auto reachesVisitPoint = [&](size_t i, double batteryNeededToTask) {
+            for (const auto& visitPoint : visitPoints) {
+                // 跳过当前检查的任务点
+                if (visitPoint.taskId == assignedTaskIds[i]) continue;
+                
+                double distanceToVisitPoint = handleDistance(problem, taskHandles[i], visitPoint.handle, true);
+                double batteryToVisitPoint = distanceToVisitPoint / drone.speed;
+                double arrivalTime = currentTime + batteryNeededToTask + batteryToVisitPoint;
+                
+                // 如果drone能到达该点，且在车辆到达前抵达
+                if (batteryNeededToTask + batteryToVisitPoint <= currentBattery && 
+                    arrivalTime < visitPoint.vehicleArrivalTime) {
+                    return true; // 只要找到一个可行的返回点即可
                 }
             }
-            
-            // 如果找不到可返回的点，跳过该任务点
-            if (!canReturn) continue;
-            
-            
-            // 更新最近的下一个任务点
-            if (distanceToTask < minDistance) {
+            return false;
+        };
+        // 先逐个检查近邻表中的点，表中没有可行的点时再扫描全部候选点
+        if (neighbors.active()) {
+            nextIndex = neighbors.nearest(currentPos, minDistance, [&](int i) {
+                double distanceToTask;
+                uint8_t status = droneCandidateStatus(scan.candidates, state, i, distanceToTask);
+                return status == CandidateFeasible ||
+                       (status == CandidateNoReturn && reachesVisitPoint(i, distanceToTask / drone.speed));
+            });
+            if (nextIndex != -1) nextId = assignedTaskIds[nextIndex];
+        }
+        if (nextIndex == -1) {
+            scanDroneCandidates(scan.candidates, state, scan.distance.data(), scan.status.data());
+            for (size_t i = 0; i < assignedTaskIds.size(); i++) {
+                if (scan.status[i] == CandidateInfeasible) continue;
+
+                double distanceToTask = scan.distance[i];
+                // 不会比已选中的点更近时，无需再检查返回点
+                if (!(distanceToTask < minDistance)) continue;
+
+                // 检查从任务点是否有可行的返回点：能直飞回原配送中心，或能返回车辆经过的任务点
+                bool canReturn = scan.status[i] == CandidateFeasible || reachesVisitPoint(i, distanceToTask / drone.speed);
+                
+                // 如果找不到可返回的点，跳过该任务点
+                if (!canReturn) continue;
+                
+                // 更新最近的下一个任务点
                 minDistance = distanceToTask;
                 nextIndex = i;
-                nextId = taskId;
+                nextId = assignedTaskIds[i];
             }
         }
         
@@ -682,17 +886,17 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
             backpoint_iscenter = false;
             // 访问该任务点
             visited[nextIndex] = true;
+            scan.candidates.readyTime[nextIndex] = std::numeric_limits<double>::infinity();
             path.push_back(nextId);
             
             // 更新状态
             double travelTime = minDistance / drone.speed;
             currentTime += travelTime;
             currentBattery -= travelTime;
-            currentPos = nextId;
+            currentPos = taskHandles[nextIndex];
             
             // 更新载重
-            int taskIndex = problem.taskIdToIndex.at(nextId);
-            const TaskPoint& task = tasks[taskIndex];
+            const TaskPoint& task = tasks[taskHandles[nextIndex].index];
             
             if (task.pickweight > 0) {
                 currentLoad += task.pickweight;
@@ -710,7 +914,7 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                 for (size_t i = 0; i < assignedTaskIds.size(); i++) {
                     if (!visited[i]) {
                         int taskId = assignedTaskIds[i];
-                        int taskIndex = problem.taskIdToIndex.at(taskId);
+                        int taskIndex = taskHandles[i].index;
                         if (taskIndex >= problem.initialDemandCount) {
                             if (tasks[taskIndex].arrivaltime < earliestArrivalTime) {
                                 earliestArrivalTime = tasks[taskIndex].arrivaltime;
@@ -721,7 +925,7 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                     }
                 }
                 if (earliestExtraDemandId != -1) {
-                    double distanceToEarliestDemand = getDistance(currentPos, earliestExtraDemandId, problem, true);
+                    double distanceToEarliestDemand = handleDistance(problem, currentPos, taskHandles[earliestExtraDemandIndex], true);
                     double timeToEarliestDemand = distanceToEarliestDemand / drone.speed;
                     const TaskPoint& task = tasks[earliestExtraDemandIndex];
                     
@@ -737,17 +941,19 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                     //std::cout << "调整时间到 " << currentTime << " 以访问任务点 " << earliestExtraDemandId << std::endl;
                 }
                 else {
-                    std::cout << "出错了，没点可以返回了" << std::endl;
+                    std::cout << "出错了，没点可以返回了" << '\n';
                 }
                 continue;
             }
             backpoint_iscenter = true;
             // 无法找到下一个任务点，需要返回某个点
             int bestReturnPoint = drone.centerId;
+            NodeHandle bestReturnHandle = centerHandle;
+            double bestVehicleArrivalTime = 0.0;
             double minReturnTime = std::numeric_limits<double>::max(); // 最早可以完成返回的时间
             
             // 首先检查是否能返回原配送中心
-            double distanceToCenter = getDistance(currentPos, drone.centerId, problem, true);
+            double distanceToCenter = handleDistance(problem, currentPos, centerHandle, true);
             double batteryNeeded = distanceToCenter / drone.speed;
             double returnTime = currentTime + distanceToCenter / drone.speed;
             
@@ -757,11 +963,11 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
             }
             
             // 寻找可到达的车辆经过点
-            for (const auto& [visitTaskId, info] : taskVisitInfo) {
-                double distance = getDistance(currentPos, visitTaskId, problem, true);
+            for (const auto& visitPoint : visitPoints) {
+                double distance = handleDistance(problem, currentPos, visitPoint.handle, true);
                 double batteryNeeded = distance / drone.speed;
                 double droneArrivalTime = currentTime + distance / drone.speed;
-                double vehicleArrivalTime = info.second;
+                double vehicleArrivalTime = visitPoint.vehicleArrivalTime;
                 
                 // 计算实际可完成返回的时间（需要等待车辆到达）
                 double actualReturnTime = std::max(droneArrivalTime, vehicleArrivalTime);
@@ -771,7 +977,9 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                     droneArrivalTime < vehicleArrivalTime && 
                     actualReturnTime < minReturnTime) {
                     minReturnTime = actualReturnTime;
-                    bestReturnPoint = visitTaskId;
+                    bestReturnPoint = visitPoint.taskId;
+                    bestReturnHandle = visitPoint.handle;
+                    bestVehicleArrivalTime = vehicleArrivalTime;
                 }
             }
             
@@ -781,16 +989,16 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                 else path.push_back(bestReturnPoint);
                 
                 // 计算返回时间
-                double distance = getDistance(currentPos, bestReturnPoint, problem, true);
+                double distance = handleDistance(problem, currentPos, bestReturnHandle, true);
                 double flyingTime = distance / drone.speed;
                 currentBattery -= flyingTime;
                 
                 // 更新当前位置
-                currentPos = bestReturnPoint;
+                currentPos = bestReturnHandle;
                 
                 // 如果是车辆访问的任务点，需要等待车辆到达
-                if (bestReturnPoint != drone.centerId && taskVisitInfo.count(bestReturnPoint) > 0) {
-                    double vehicleArrivalTime = taskVisitInfo.at(bestReturnPoint).second;
+                if (bestReturnPoint != drone.centerId) {
+                    double vehicleArrivalTime = bestVehicleArrivalTime;
                     // 更新到达时间（考虑等待车辆）
                     times.push_back(currentTime + flyingTime);//这里先记录到达当前时间，再更新
                     currentTime = std::max(currentTime + flyingTime, vehicleArrivalTime);
@@ -815,12 +1023,14 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
     }
     
     // 如果最后不在配送中心，选择返回某个点
-    if (currentPos != drone.centerId) {
+    if (currentPos != centerHandle) {
         int bestReturnPoint = drone.centerId;
+        NodeHandle bestReturnHandle = centerHandle;
+        double bestVehicleArrivalTime = 0.0;
         double minReturnTime = std::numeric_limits<double>::max(); // 最早可以完成返回的时间
         
         // 首先检查是否能返回原配送中心
-        double distanceToCenter = getDistance(currentPos, drone.centerId, problem, true);
+        double distanceToCenter = handleDistance(problem, currentPos, centerHandle, true);
         double batteryNeeded = distanceToCenter / drone.speed;
         double returnTime = currentTime + distanceToCenter / drone.speed;
         
@@ -830,11 +1040,11 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
         }
         
         // 寻找可到达的车辆经过点
-        for (const auto& [visitTaskId, info] : taskVisitInfo) {
-            double distance = getDistance(currentPos, visitTaskId, problem, true);
+        for (const auto& visitPoint : visitPoints) {
+            double distance = handleDistance(problem, currentPos, visitPoint.handle, true);
             double batteryNeeded = distance / drone.speed;
             double droneArrivalTime = currentTime + distance / drone.speed;
-            double vehicleArrivalTime = info.second;
+            double vehicleArrivalTime = visitPoint.vehicleArrivalTime;
             
             // 计算实际可完成返回的时间（需要等待车辆到达）
             double actualReturnTime = std::max(droneArrivalTime, vehicleArrivalTime);
@@ -844,7 +1054,9 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
                 droneArrivalTime < vehicleArrivalTime && 
                 actualReturnTime < minReturnTime) {
                 minReturnTime = actualReturnTime;
-                bestReturnPoint = visitTaskId;
+                bestReturnPoint = visitPoint.taskId;
+                bestReturnHandle = visitPoint.handle;
+                bestVehicleArrivalTime = vehicleArrivalTime;
             }
         }
         
@@ -855,16 +1067,16 @@ std::pair<std::vector<int>, std::vector<double>> optimizeDronePathWithVehicles(
             else path.push_back(bestReturnPoint);
             
             // 计算返回时间
-            double distance = getDistance(currentPos, bestReturnPoint, problem, true);
+            double distance = handleDistance(problem, currentPos, bestReturnHandle, true);
             double flyingTime = distance / drone.speed;
             currentBattery -= flyingTime;
             
             // 更新当前位置
-            currentPos = bestReturnPoint;
+            currentPos = bestReturnHandle;
             
             // 如果是车辆访问的任务点，需要等待车辆到达
-            if (bestReturnPoint != drone.centerId && taskVisitInfo.count(bestReturnPoint) > 0) {
-                double vehicleArrivalTime = taskVisitInfo.at(bestReturnPoint).second;
+            if (bestReturnPoint != drone.centerId) {
+                double vehicleArrivalTime = bestVehicleArrivalTime;
                 // 更新到达时间（考虑等待车辆）
                 times.push_back(currentTime + flyingTime);
                 currentTime = std::max(currentTime + flyingTime, vehicleArrivalTime);
@@ -910,6 +1122,20 @@ double calculateTimeNeeded(
     bool considerTraffic,  // 是否考虑高峰期
     bool isDrone)  // 是否是drone
 {
+    // 本次计算使用的交通快照
+    const PeakFactorTable* traffic = activeTraffic(problem);
+
+    // 时变最短路：高峰期按路段系数选择最快路线
+    if (considerTraffic && !isDrone && traffic && traffic->timeDependent) {
+        int fromNode = toRoadNodeId(currentId), toNode = toRoadNodeId(destId);
+        int fromSlot = traffic->slotOfNode(fromNode);
+        int toSlot = traffic->slotOfNode(toNode);
+        if (fromSlot < 0 || toSlot < 0) {
+            return traffic->timeDependent->exactTravelTime(fromNode, toNode, currentTime, vehicle.speed);
+        }
+        return traffic->timeDependent->travelTime(fromSlot, toSlot, currentTime, vehicle.speed);
+    }
+
     // 获取两点之间的距离
     double distance = getDistance(currentId, destId, problem, isDrone);
     
@@ -918,68 +1144,46 @@ double calculateTimeNeeded(
         return distance / vehicle.speed;
     }
     
-    // 车辆且考虑高峰期的情况，需要分段计算
-    double remainingDistance = distance;
-    double totalTime = 0.0;
-    double travelTime = currentTime;
-    
-    // 车辆/无人机在正常时段的速度
-    double normalSpeed = vehicle.speed;
-    
-    // 持续计算直到所有距离都已经行驶
-    while (remainingDistance > 0.0001) {
-        // 判断当前时刻是否在高峰期
-        bool isMorningPeak = (travelTime >= DeliveryProblem::MORNING_PEAK_START && travelTime < DeliveryProblem::MORNING_PEAK_END);
-        bool isEveningPeak = (travelTime >= DeliveryProblem::EVENING_PEAK_START && travelTime < DeliveryProblem::EVENING_PEAK_END);
-        bool isPeakHour = isMorningPeak || isEveningPeak;
-        
-        // 当前速度系数和速度
-        double speedFactor = 1.0;
-        if (isPeakHour) {
-            speedFactor = getSpeedFactor(travelTime, currentId, destId, problem);
-        }
-        double currentSpeed = normalSpeed * speedFactor;
-        
-        // 计算到下一个时间段的时间
-        double timeToNextPhase = std::numeric_limits<double>::max();
-        
-        if (travelTime < DeliveryProblem::MORNING_PEAK_START) {
-            // 当前在早高峰前
-            timeToNextPhase = DeliveryProblem::MORNING_PEAK_START - travelTime;
-        } else if (travelTime < DeliveryProblem::MORNING_PEAK_END) {
-            // 当前在早高峰中
-            timeToNextPhase = DeliveryProblem::MORNING_PEAK_END - travelTime;
-        } else if (travelTime < DeliveryProblem::EVENING_PEAK_START) {
-            // 当前在早高峰后，晚高峰前
-            timeToNextPhase = DeliveryProblem::EVENING_PEAK_START - travelTime;
-        } else if (travelTime < DeliveryProblem::EVENING_PEAK_END) {
-            // 当前在晚高峰中
-            timeToNextPhase = DeliveryProblem::EVENING_PEAK_END - travelTime;
-        } else {
-            // 当前在晚高峰后
-            timeToNextPhase = 24.0 - travelTime + DeliveryProblem::MORNING_PEAK_START; // 到第二天早高峰开始的时间
-        }
-        
-        // 以当前速度能行驶的距离
-        double distanceCanTravel = currentSpeed * timeToNextPhase;
-        
-        if (distanceCanTravel >= remainingDistance) {
-            // 如果可以到达目的地
-            double segmentTime = remainingDistance / currentSpeed;
-            totalTime += segmentTime;
-            remainingDistance = 0;
-        } else {
-            // 如果不能到达目的地，行驶至下一个时间段
-            totalTime += timeToNextPhase;
-            remainingDistance -= distanceCanTravel;
-            travelTime += timeToNextPhase;
-            
-            // 处理一天结束的情况
-            if (travelTime >= 24.0) {
-                travelTime -= 24.0;
-            }
-        }
+    // 各时段的单位速度行驶时间，路段没有系数记录时使用默认系数
+    double morningFactor = DeliveryProblem::DEFAULT_MORNING_PEAK_FACTOR;
+    double eveningFactor = DeliveryProblem::DEFAULT_EVENING_PEAK_FACTOR;
+    if (const PeakFactor* factor = traffic ? traffic->find(currentId, destId) : nullptr) {
+        morningFactor = factor->morning;
+        eveningFactor = factor->evening;
     }
-    
-    return totalTime;
+    BandTravelTimes times = {{distance, distance / morningFactor, distance / eveningFactor}};
+    return legTravelTime(problem.travelProfile, times, vehicle.speed, currentTime);
+}
+
+// 按句柄计算行驶时间，与按ID的版本结果一致
+// 车辆考虑高峰期时按槽位查询时变最短路，或直接读取预计算的时段行驶时间表（协同点使用默认系数，仍按ID版本计算）
+double calculateTimeNeeded(
+    NodeHandle current,
+    NodeHandle dest,
+    double currentTime,
+    const Vehicle& vehicle,
+    const DeliveryProblem& problem,
+    bool considerTraffic,
+    bool isDrone)
+{
+    if (!considerTraffic || isDrone) {
+        return handleDistance(problem, current, dest, isDrone) / vehicle.speed;
+    }
+    const PeakFactorTable* traffic = activeTraffic(problem);
+    if (traffic && traffic->timeDependent) {
+        int a = current.kind == NodeKind::Task ? problem.taskFactorSlot[current.index] : problem.centerFactorSlot[current.index];
+        int b = dest.kind == NodeKind::Task ? problem.taskFactorSlot[dest.index] : problem.centerFactorSlot[dest.index];
+        return traffic->timeDependent->travelTime(a, b, currentTime, vehicle.speed);
+    }
+    // 预计算表只在与当前距离矩阵同一版本时使用（路段更新后过期的表按系数现算）
+    bool bandTimesCurrent = traffic && !traffic->bandTimes.empty() &&
+                            traffic->bandDistanceVersion == problem.network.distanceVersion;
+    if (bandTimesCurrent && current != dest && !current.collaboration && !dest.collaboration) {
+        int a = current.kind == NodeKind::Task ? problem.taskFactorSlot[current.index] : problem.centerFactorSlot[current.index];
+        int b = dest.kind == NodeKind::Task ? problem.taskFactorSlot[dest.index] : problem.centerFactorSlot[dest.index];
+        return legTravelTime(problem.travelProfile, traffic->bandTimes[PeakFactorTable::pairIndex(a, b)],
+                             vehicle.speed, currentTime);
+    }
+    return calculateTimeNeeded(nodeHandleId(problem, current), nodeHandleId(problem, dest),
+                               currentTime, vehicle, problem, considerTraffic, isDrone);
 }
@@ -35,10 +35,10 @@ bool validateStaticVehicleCenter(
             // 判断是car还是drone
             if (vehicle.maxLoad > 0) {
                 cout << "错误: drone " << vehicleId << " 的路径不是从其所属配送中心 " 
-                     << vehicleCenterId << " 出发，而是从 " << pathCenterId << " 出发" << endl;
+                     << vehicleCenterId << " 出发，而是从 " << pathCenterId << " 出发" << '\n';
             } else {
                 cout << "错误: car " << vehicleId << " 的路径不是从其所属配送中心 " 
-                     << vehicleCenterId << " 出发，而是从 " << pathCenterId << " 出发" << endl;
+                     << vehicleCenterId << " 出发，而是从 " << pathCenterId << " 出发" << '\n';
             }
             isValid = false;
         }
@@ -103,11 +103,11 @@ bool validateDynamicVehicleCenter(
                     if (currentVehicle.maxLoad > 0) {
                         cout << "错误: 动态阶段drone " << vehicleId << " 处理了任务 " << taskId 
                              << "，但该任务原本应由配送中心 " << originalVehicle.centerId 
-                             << " 的Vehicle处理" << endl;
+                             << " 的Vehicle处理" << '\n';
                     } else {
                         cout << "错误: 动态阶段car " << vehicleId << " 处理了任务 " << taskId 
                              << "，但该任务原本应由配送中心 " << originalVehicle.centerId 
-                             << " 的Vehicle处理" << endl;
+                             << " 的Vehicle处理" << '\n';
                     }
                     isValid = false;
                 }
@@ -123,6 +123,7 @@ std::pair<bool, std::string> validateStaticPathLegality(
     const DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& staticPaths)
 {
+    TrafficPin traffic(problem);  // 校验全程使用同一版交通系数
     bool isValid = true;
     string errorMessage = "";
     
@@ -272,6 +273,7 @@ std::pair<bool, std::string> validateDynamicPathLegality(
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& dynamicPaths,
     const std::vector<int>& extraTaskIds)
 {
+    TrafficPin traffic(problem);  // 校验全程使用同一版交通系数
     bool isValid = true;
     string errorMessage = "";
     
@@ -594,60 +596,60 @@ std::pair<bool, std::string> validateAllPaths(
     bool centerValid = validateStaticVehicleCenter(problem, staticPaths);
     if (!centerValid) {
         errorMessage += "静态阶段车辆配送中心验证失败\n";
-        std::cout << "静态阶段车辆配送中心验证失败" << std::endl;
+        std::cout << "静态阶段车辆配送中心验证失败" << '\n';
         isValid = false;
     } else {
-        std::cout << "静态阶段车辆配送中心验证通过" << std::endl;
+        std::cout << "静态阶段车辆配送中心验证通过" << '\n';
     }
     
     // 验证静态阶段路径完整性
     auto [staticCompletenessValid, staticCompletenessError] = validateStaticPathCompleteness(problem, staticPaths);
     if (!staticCompletenessValid) {
         errorMessage += "静态阶段路径完整性验证失败：";
-        std::cout << "静态阶段路径完整性验证失败：" << std::endl << staticCompletenessError;
+        std::cout << "静态阶段路径完整性验证失败：" << '\n' << staticCompletenessError;
         isValid = false;
     } else {
-        std::cout << "静态阶段路径完整性验证通过" << std::endl;
+        std::cout << "静态阶段路径完整性验证通过" << '\n';
     }
     
     // 验证静态阶段路径合法性
     auto [staticLegalityValid, staticLegalityError] = validateStaticPathLegality(problem, staticPaths);
     if (!staticLegalityValid) {
         errorMessage += "静态阶段路径合法性验证失败：";
-        std::cout << "静态阶段路径合法性验证失败：" << std::endl << staticLegalityError;
+        std::cout << "静态阶段路径合法性验证失败：" << '\n' << staticLegalityError;
         isValid = false;
     } else {
-        std::cout << "静态阶段路径合法性验证通过" << std::endl;
+        std::cout << "静态阶段路径合法性验证通过" << '\n';
     }
     
     // 验证动态阶段车辆配送中心
     bool dynamicCenterValid = validateDynamicVehicleCenter(problem, staticPaths, dynamicPaths, staticMaxTime);
     if (!dynamicCenterValid) {
         errorMessage += "动态阶段车辆配送中心验证失败：";
-        std::cout << "动态阶段车辆配送中心验证失败" << std::endl;
+        std::cout << "动态阶段车辆配送中心验证失败" << '\n';
         isValid = false;
     } else {
-        std::cout << "动态阶段车辆配送中心验证通过" << std::endl;
+        std::cout << "动态阶段车辆配送中心验证通过" << '\n';
     }
     
     // 验证动态阶段路径完整性
     auto [dynamicCompletenessValid, dynamicCompletenessError] = validateDynamicPathCompleteness(problem, dynamicPaths);
     if (!dynamicCompletenessValid) {
         errorMessage += "动态阶段路径完整性验证失败：";
-        std::cout << "动态阶段路径完整性验证失败：" << std::endl << dynamicCompletenessError;
+        std::cout << "动态阶段路径完整性验证失败：" << '\n' << dynamicCompletenessError;
         isValid = false;
     } else {
-        std::cout << "动态阶段路径完整性验证通过" << std::endl;
+        std::cout << "动态阶段路径完整性验证通过" << '\n';
     }
     
     // 验证动态阶段路径合法性
     auto [dynamicLegalityValid, dynamicLegalityError] = validateDynamicPathLegality(problem, dynamicPaths, extraTaskIds);
     if (!dynamicLegalityValid) {
         errorMessage += "动态阶段路径合法性验证失败：";
-        std::cout << "动态阶段路径合法性验证失败：" << std::endl << dynamicLegalityError;
+        std::cout << "动态阶段路径合法性验证失败：" << '\n' << dynamicLegalityError;
         isValid = false;
     } else {
-        std::cout << "动态阶段路径合法性验证通过" << std::endl;
+        std::cout << "动态阶段路径合法性验证通过" << '\n';
     }
     
     return {isValid, errorMessage};
@@ -0,0 +1,114 @@
+#include "route_stream.h"
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <csignal>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+// 追加一个浮点数：最短的可精确还原的十进制表示，NaN和无穷大写为null（JSON没有对应的数值）
+static void appendNumber(std::string &line, double value)
+{
+    if (!std::isfinite(value)) {
+        line += "null";
+        return;
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    line.append(buffer, result.ptr);
+}
+
+static const char* kindName(StopKind kind)
+{
+    switch (kind) {
+    case StopKind::Center: return "center";
+    case StopKind::Collaboration: return "collaboration";
+    case StopKind::Task: return "task";
+    }
+    return "task";
+}
+
+RouteStream::~RouteStream()
+{
+    if (fd >= 0) ::close(fd);
+}
+
+bool RouteStream::open(const std::string &path)
+{
+    // 读端提前退出时write返回EPIPE，不让SIGPIPE终止求解
+    std::signal(SIGPIPE, SIG_IGN);
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    return fd >= 0;
+}
+
+void RouteStream::emit(const char* stage, const VehiclePlan &vehicle)
+{
+    std::string line;
+    line.reserve(96 + vehicle.stops.size() * 48);
+    line += "{\"stage\":\"";
+    line += stage;
+    line += "\",\"vehicle\":";
+    line += std::to_string(vehicle.vehicleId);
+    line += vehicle.drone ? ",\"drone\":true" : ",\"drone\":false";
+    line += ",\"center\":";
+    line += std::to_string(vehicle.centerId);
+    line += ",\"stops\":[";
+    for (size_t i = 0; i < vehicle.stops.size(); ++i) {
+        const PlanStop& stop = vehicle.stops[i];
+        if (i > 0) line += ',';
+        line += "{\"id\":";
+        line += std::to_string(stop.id);
+        line += ",\"kind\":\"";
+        line += kindName(stop.kind);
+        line += "\",\"arrival\":";
+        appendNumber(line, stop.arrival);
+        line += '}';
+    }
+    line += "]}\n";
+    writeLine(line);
+}
+
+void RouteStream::endStage(const char* stage, const DeliveryPlan &plan)
+{
+    std::string line = "{\"stage\":\"";
+    line += stage;
+    line += "\",\"end\":true,\"vehicles\":";
+    line += std::to_string(plan.vehicles.size());
+    line += ",\"tasks\":";
+    line += std::to_string(plan.taskCount);
+    line += ",\"makespan\":";
+    appendNumber(line, plan.makespan);
+    line += ",\"cost\":";
+    appendNumber(line, plan.cost);
+    line += "}\n";
+    writeLine(line);
+}
+
+RouteSink RouteStream::sink(const DeliveryProblem &problem, const char* stage)
+{
+    return [this, &problem, stage](int vehicleId, const std::vector<int>& path,
+                                   const std::vector<double>& completionTimes) {
+        if (path.size() <= 2) return;
+        emit(stage, buildVehiclePlan(problem, vehicleId, path, completionTimes));
+    };
+}
+
+void RouteStream::writeLine(const std::string &line)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0 || broken) return;
+    const char* data = line.data();
+    size_t remaining = line.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "路径流写出失败，停止逐车输出" << std::endl;
+            broken = true;
+            return;
+        }
+        data += written;
+        remaining -= written;
+    }
+}
@@ -0,0 +1,440 @@
+#include "shortest_path.h"
+#include "parallel.h"
+#include "contraction_hierarchy.h"
+#include "distance_cache.h"
+#include "distance_rows.h"
+#include "hilbert_order.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+using std::cout;
+using std::endl;
+
+// 以pivot块中的k为中转，更新块(rowBlock, colBlock)：
+// dist[i][j] = min(dist[i][j], dist[i][k] + dist[k][j])
+// 最内层j循环连续访问且无分支，编译器可向量化为SIMD min
+// HopPtr不是nullptr_t时同步记录下一跳（经k更短时取 next[i][k]），同样以选择代替分支
+template <typename HopPtr>
+static void relaxBlock(double* dist, HopPtr hops, size_t n, int blockSize,
+                       int rowBlock, int colBlock, int pivotBlock)
+{
+    size_t iBegin = (size_t)rowBlock * blockSize, iEnd = std::min(n, iBegin + blockSize);
+    size_t jBegin = (size_t)colBlock * blockSize, jEnd = std::min(n, jBegin + blockSize);
+    size_t kBegin = (size_t)pivotBlock * blockSize, kEnd = std::min(n, kBegin + blockSize);
+
+    for (size_t k = kBegin; k < kEnd; k++) {
+        const double* rowK = dist + k * n;
+        for (size_t i = iBegin; i < iEnd; i++) {
+            double* rowI = dist + i * n;
+            double distIK = rowI[k];
+            if constexpr (!std::is_same_v<HopPtr, std::nullptr_t>) {
+                HopPtr hopI = hops + i * n;
+                auto hopIK = hopI[k];
+                for (size_t j = jBegin; j < jEnd; j++) {
+                    double throughK = distIK + rowK[j];
+                    bool shorter = throughK < rowI[j];
+                    rowI[j] = shorter ? throughK : rowI[j];
+                    hopI[j] = shorter ? hopIK : hopI[j];
+                }
+            } else {
+                for (size_t j = jBegin; j < jEnd; j++) {
+                    double throughK = distIK + rowK[j];
+                    rowI[j] = throughK < rowI[j] ? throughK : rowI[j];
+                }
+            }
+        }
+    }
+}
+
+template <typename HopPtr>
+static void blockedFloydKernel(double* dist, HopPtr hops, size_t n, int threadCount, int blockSize)
+{
+    int blockCount = (n + blockSize - 1) / blockSize;
+
+    for (int pivot = 0; pivot < blockCount; pivot++) {
+        // 阶段1：pivot块自身
+        relaxBlock(dist, hops, n, blockSize, pivot, pivot, pivot);
+
+        // 阶段2：与pivot块同行、同列的块，只依赖阶段1的结果
+        parallelFor(0, 2 * blockCount, threadCount, [&](int task) {
+            int other = task / 2;
+            if (other == pivot) return;
+            if (task % 2 == 0) {
+                relaxBlock(dist, hops, n, blockSize, pivot, other, pivot);  // 同行块
+            } else {
+                relaxBlock(dist, hops, n, blockSize, other, pivot, pivot);  // 同列块
+            }
+        });
+
+        // 阶段3：其余块，只依赖阶段2的结果，按块行划分任务
+        parallelFor(0, blockCount, threadCount, [&](int rowBlock) {
+            if (rowBlock == pivot) return;
+            for (int colBlock = 0; colBlock < blockCount; colBlock++) {
+                if (colBlock == pivot) continue;
+                relaxBlock(dist, hops, n, blockSize, rowBlock, colBlock, pivot);
+            }
+        });
+    }
+}
+
+// 分块Floyd算法，已初始化下一跳时一并记录
+void blockedFloyd(RouteNetwork &network, int threadCount, int blockSize)
+{
+    size_t n = network.nodeCount;
+    if (n == 0) return;
+    double* dist = network.distMatrix.data();
+    NextHopMatrix& hops = network.nextHop;
+
+    if (hops.nodeCount == (int)n && !hops.hops16.empty()) {
+        blockedFloydKernel(dist, hops.hops16.data(), n, threadCount, blockSize);
+    } else if (hops.nodeCount == (int)n && !hops.hops32.empty()) {
+        blockedFloydKernel(dist, hops.hops32.data(), n, threadCount, blockSize);
+    } else {
+        blockedFloydKernel(dist, nullptr, n, threadCount, blockSize);
+    }
+}
+
+// 边列表哈希（逐字节FNV-1a）
+uint64_t hashEdgeList(const std::vector<Edge> &edges)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    for (const auto& edge : edges) {
+        mix(&edge.node1, sizeof(edge.node1));
+        mix(&edge.node2, sizeof(edge.node2));
+        mix(&edge.length, sizeof(edge.length));
+    }
+    return hash;
+}
+
+// 由边列表构建CSR邻接表
+CsrGraph buildCsrGraph(const std::vector<Edge> &edges)
+{
+    CsrGraph graph;
+    int maxNodeId = -1;
+    for (const auto& edge : edges) {
+        maxNodeId = std::max(maxNodeId, std::max(edge.node1, edge.node2));
+    }
+    graph.nodeIndex.assign(maxNodeId + 1, -1);
+    for (const auto& edge : edges) {
+        for (int nodeId : {edge.node1, edge.node2}) {
+            if (graph.nodeIndex[nodeId] == -1) {
+                graph.nodeIndex[nodeId] = graph.nodeIds.size();
+                graph.nodeIds.push_back(nodeId);
+            }
+        }
+    }
+    graph.nodeCount = graph.nodeIds.size();
+
+    // 双向弧按(起点, 终点, 长度)排序后，相同(起点, 终点)只保留最短的一条
+    struct Arc { int from, to; double length; };
+    std::vector<Arc> arcs;
+    arcs.reserve(edges.size() * 2);
+    for (const auto& edge : edges) {
+        int u = graph.nodeIndex[edge.node1];
+        int v = graph.nodeIndex[edge.node2];
+        if (u == v) continue;
+        arcs.push_back({u, v, edge.length});
+        arcs.push_back({v, u, edge.length});
+    }
+    std::sort(arcs.begin(), arcs.end(), [](const Arc& a, const Arc& b) {
+        if (a.from != b.from) return a.from < b.from;
+        if (a.to != b.to) return a.to < b.to;
+        return a.length < b.length;
+    });
+    arcs.erase(std::unique(arcs.begin(), arcs.end(), [](const Arc& a, const Arc& b) {
+        return a.from == b.from && a.to == b.to;
+    }), arcs.end());
+
+    graph.offsets.assign(graph.nodeCount + 1, 0);
+    graph.targets.resize(arcs.size());
+    graph.weights.resize(arcs.size());
+    for (size_t i = 0; i < arcs.size(); i++) {
+        graph.offsets[arcs[i].from + 1]++;
+        graph.targets[i] = arcs[i].to;
+        graph.weights[i] = arcs[i].length;
+    }
+    for (int i = 0; i < graph.nodeCount; i++) {
+        graph.offsets[i + 1] += graph.offsets[i];
+    }
+    return graph;
+}
+
+// 单源Dijkstra（二叉堆，惰性删除）
+void dijkstra(const CsrGraph &graph, int source, std::vector<double> &dist,
+              const std::vector<int> *targetSlot, int targetCount, std::vector<int> *parent)
+{
+    dist.assign(graph.nodeCount, std::numeric_limits<double>::infinity());
+    if (parent) parent->assign(graph.nodeCount, -1);
+    std::vector<std::pair<double, int>> heap;
+    auto cmp = std::greater<std::pair<double, int>>();
+
+    dist[source] = 0.0;
+    heap.push_back({0.0, source});
+    int remainingTargets = targetCount;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        auto [d, u] = heap.back();
+        heap.pop_back();
+        if (d > dist[u]) continue;  // 过期的堆元素
+
+        if (targetSlot && (*targetSlot)[u] >= 0 && --remainingTargets == 0) {
+            break;  // 所有目标节点均已确定
+        }
+
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            int v = graph.targets[e];
+            double nd = d + graph.weights[e];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                if (parent) (*parent)[v] = u;
+                heap.push_back({nd, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+}
+
+// 收集任务点和配送中心所在的路网节点
+std::vector<int> collectTerminalNodes(const DeliveryProblem &problem)
+{
+    std::vector<int> terminals;
+    std::vector<char> seen;
+    auto add = [&](int pointId) {
+        int nodeId = toRoadNodeId(pointId);
+        if (nodeId < 0) return;
+        if (nodeId >= (int)seen.size()) seen.resize(nodeId + 1, 0);
+        if (!seen[nodeId]) {
+            seen[nodeId] = 1;
+            terminals.push_back(nodeId);
+        }
+    };
+    for (const auto& task : problem.tasks) add(task.id);
+    for (const auto& center : problem.centers) add(center.id);
+    if (problem.config.hilbertOrder) {
+        std::vector<int> sorted;
+        sorted.reserve(terminals.size());
+        for (int index : hilbertNodeOrder(problem, terminals)) sorted.push_back(terminals[index]);
+        terminals = std::move(sorted);
+    }
+    return terminals;
+}
+
+// 多源Dijkstra，只计算终端节点之间的距离表
+void terminalDijkstra(RouteNetwork &network, const std::vector<int> &terminalNodeIds, int threadCount)
+{
+    if (network.graph.nodeCount == 0) network.graph = buildCsrGraph(network.edges);
+    const CsrGraph& graph = network.graph;
+
+    // 只保留出现在路网中的终端节点，矩阵索引按终端顺序分配
+    int maxNodeId = graph.nodeIndex.size() - 1;
+    network.nodeIds.clear();
+    network.nodeIndex.assign(maxNodeId + 1, -1);
+    std::vector<int> targetSlot(graph.nodeCount, -1);  // CSR索引 -> 矩阵索引
+    for (int nodeId : terminalNodeIds) {
+        int v = graph.indexOf(nodeId);
+        if (v < 0) continue;
+        network.nodeIndex[nodeId] = network.nodeIds.size();
+        targetSlot[v] = network.nodeIds.size();
+        network.nodeIds.push_back(nodeId);
+    }
+    network.nodeCount = network.nodeIds.size();
+
+    size_t n = network.nodeCount;
+    network.distMatrix.assign(n * n, std::numeric_limits<double>::infinity());
+
+    parallelFor(0, network.nodeCount, threadCount, [&](int row) {
+        thread_local std::vector<double> dist;
+        int source = graph.indexOf(network.nodeIds[row]);
+        dijkstra(graph, source, dist, &targetSlot, network.nodeCount);
+
+        double* out = network.distMatrix.data() + (size_t)row * n;
+        for (size_t col = 0; col < n; col++) {
+            out[col] = dist[graph.indexOf(network.nodeIds[col])];
+        }
+    });
+}
+
+// 把稠密矩阵按 storage 量化为上三角紧凑存储（Double时不做处理），不输出信息
+void compactDistanceMatrix(RouteNetwork &network, MatrixStorage storage)
+{
+    if (storage == MatrixStorage::Double) return;
+    int n = network.nodeCount;
+
+    CompactDistanceMatrix compact;
+    compact.storage = storage;
+    compact.rowBase.resize(n);
+    int64_t base = 0;
+    double maxDistance = 0.0;
+    for (int i = 0; i < n; i++) {
+        compact.rowBase[i] = base - (i + 1);  // 行i存放 j = i+1 .. n-1
+        base += n - i - 1;
+        for (int j = i + 1; j < n; j++) {
+            double d = network.distanceAt(i, j);
+            if (d != std::numeric_limits<double>::infinity()) maxDistance = std::max(maxDistance, d);
+        }
+    }
+    size_t count = base;
+
+    // 定点编码按最大有限距离取最细的分辨率，最大编码保留给不可达
+    double maxCode = storage == MatrixStorage::Fixed16 ? UINT16_MAX - 1 : (double)UINT32_MAX - 1;
+    double scale = maxDistance > 0.0 ? maxCode / maxDistance : 1.0;
+    compact.inverseScale = 1.0 / scale;
+    if (storage == MatrixStorage::Float) {
+        compact.floatValues.resize(count);
+        compact.maxError = maxDistance * std::ldexp(1.0, -24);  // float相对舍入误差为2^-24
+    } else if (storage == MatrixStorage::Fixed16) {
+        compact.fixed16Values.resize(count);
+        compact.maxError = 0.5 * compact.inverseScale;
+    } else {
+        compact.fixed32Values.resize(count);
+        compact.maxError = 0.5 * compact.inverseScale;
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            double d = network.distanceAt(i, j);
+            size_t k = compact.rowBase[i] + j;
+            bool reachable = d != std::numeric_limits<double>::infinity();
+            if (storage == MatrixStorage::Float) {
+                compact.floatValues[k] = (float)d;
+            } else if (storage == MatrixStorage::Fixed16) {
+                compact.fixed16Values[k] = reachable ? (uint16_t)std::lround(d * scale) : UINT16_MAX;
+            } else {
+                compact.fixed32Values[k] = reachable ? (uint32_t)std::llround(d * scale) : UINT32_MAX;
+            }
+        }
+    }
+
+    network.distMatrix.clear();
+    network.distMatrix.shrink_to_fit();
+    network.mappedMatrix = nullptr;
+    network.matrixFile.reset();
+    network.compact = std::move(compact);
+}
+
+void printCompactDistanceMatrix(const RouteNetwork &network)
+{
+    const CompactDistanceMatrix& compact = network.compact;
+    if (compact.storage == MatrixStorage::Double) return;
+    size_t count = compact.storage == MatrixStorage::Float ? compact.floatValues.size()
+                 : compact.storage == MatrixStorage::Fixed16 ? compact.fixed16Values.size()
+                 : compact.fixed32Values.size();
+    size_t valueBytes = compact.storage == MatrixStorage::Fixed16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    size_t compactBytes = count * valueBytes + compact.rowBase.size() * sizeof(int64_t);
+    size_t denseBytes = (size_t)network.nodeCount * network.nodeCount * sizeof(double);
+    const char* name = compact.storage == MatrixStorage::Float ? "float"
+                     : compact.storage == MatrixStorage::Fixed16 ? "fixed16" : "fixed32";
+    cout << "紧凑距离矩阵: " << name << ", 占用 " << compactBytes / 1048576.0 << " MB（稠密矩阵 "
+         << denseBytes / 1048576.0 << " MB）, 量化误差上限: " << compact.maxError << '\n';
+}
+
+void computeShortestPaths(DeliveryProblem &problem)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // 距离矩阵缓存：命中时直接映射文件，跳过最短路计算（收缩层次有自己的序列化文件，lazy方式没有矩阵）
+    const std::string& cacheDir = problem.config.distanceCacheDir;
+    bool fullMatrix = problem.config.apspMethod == ApspMethod::Floyd ||
+                      problem.config.apspMethod == ApspMethod::Blocked;
+    bool recordHops = problem.config.recordRoadPaths && fullMatrix;
+    if (problem.config.recordRoadPaths && !fullMatrix) {
+        std::cerr << "下一跳矩阵只能由floyd/blocked方式记录，已忽略--road-paths" << endl;
+    }
+    // 缓存文件不含下一跳矩阵，需要记录时直接计算
+    bool useCache = !cacheDir.empty() && !recordHops && problem.config.apspMethod != ApspMethod::Hierarchy &&
+                    problem.config.apspMethod != ApspMethod::Lazy;
+    uint64_t cacheKey = 0;
+    std::string cachePath;
+    if (useCache) {
+        cacheKey = distanceCacheKey(problem);
+        cachePath = distanceCachePath(cacheDir, cacheKey);
+        if (loadDistanceCache(cachePath, cacheKey, problem.network)) {
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            cout << "已从缓存映射距离矩阵: " << cachePath << ", 节点数: " << problem.network.nodeCount
+                 << ", 用时: " << elapsed << " 秒" << '\n';
+            compactDistanceMatrix(problem.network, problem.config.matrixStorage);
+            printCompactDistanceMatrix(problem.network);
+            return;
+        }
+    }
+
+    switch (problem.config.apspMethod) {
+    case ApspMethod::Hierarchy: {
+        RouteNetwork& network = problem.network;
+        if (network.graph.nodeCount == 0) network.graph = buildCsrGraph(network.edges);
+        uint64_t edgeHash = hashEdgeList(network.edges);
+        auto hierarchy = std::make_shared<ContractionHierarchy>();
+        const std::string& path = problem.config.hierarchyFile;
+        if (!path.empty() && loadContractionHierarchy(path, edgeHash, *hierarchy)) {
+            cout << "已从文件加载收缩层次: " << path << '\n';
+        } else {
+            *hierarchy = buildContractionHierarchy(network.graph, problem.config.threadCount);
+            hierarchy->edgeHash = edgeHash;
+            if (!path.empty() && !saveContractionHierarchy(*hierarchy, path)) {
+                std::cerr << "无法写入收缩层次文件: " << path << endl;
+            }
+        }
+        attachTerminalMemo(*hierarchy, collectTerminalNodes(problem));
+        cout << "收缩层次节点数: " << hierarchy->nodeCount
+             << ", 向上边数（含捷径）: " << hierarchy->upTargets.size() << '\n';
+        network.hierarchy = hierarchy;
+        break;
+    }
+    case ApspMethod::Lazy: {
+        const RouteNetwork& network = problem.network;
+        auto rows = std::make_shared<LazyDistanceRows>(network.graph.nodeCount > 0 ? network.graph : buildCsrGraph(network.edges),
+                                                       problem.config.rowCacheBytes);
+        DistanceRowStats stats = rows->stats();
+        cout << "距离行缓存上限: " << stats.capacityRows << " 行（每行 "
+             << rows->rowBytes() << " 字节）" << '\n';
+        problem.network.lazyRows = rows;
+        break;
+    }
+    case ApspMethod::Dijkstra:
+        terminalDijkstra(problem.network, collectTerminalNodes(problem), problem.config.threadCount);
+        break;
+    case ApspMethod::Blocked:
+        buildNodeIndex(problem.network);
+        if (problem.config.hilbertOrder) {
+            permuteMatrixNodes(problem.network, hilbertNodeOrder(problem, problem.network.nodeIds));
+        }
+        if (recordHops) initNextHops(problem.network);
+        blockedFloyd(problem.network, problem.config.threadCount);
+        break;
+    case ApspMethod::Floyd:
+    default:
+        buildNodeIndex(problem.network);
+        if (problem.config.hilbertOrder) {
+            permuteMatrixNodes(problem.network, hilbertNodeOrder(problem, problem.network.nodeIds));
+        }
+        if (recordHops) initNextHops(problem.network);
+        floyd(problem.network);
+        break;
+    }
+
+    if (useCache && !saveDistanceCache(cachePath, cacheKey, problem.network)) {
+        std::cerr << "无法写入距离缓存文件: " << cachePath << endl;
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << "最短路计算完成，距离矩阵节点数: " << problem.network.nodeCount
+         << ", 用时: " << elapsed << " 秒" << '\n';
+    // 收缩层次与lazy方式不持有距离矩阵，无需压缩
+    if (problem.config.apspMethod != ApspMethod::Hierarchy && problem.config.apspMethod != ApspMethod::Lazy) {
+        compactDistanceMatrix(problem.network, problem.config.matrixStorage);
+        printCompactDistanceMatrix(problem.network);
+    }
+}
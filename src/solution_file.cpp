@@ -0,0 +1,84 @@
+#include "common.h"
+#include "mapped_file.h"
+#include "solution_format.h"
+
+// 按顺序写出若干记录块
+static bool writeBlocks(const std::string &path, std::initializer_list<std::pair<const void*, size_t>> blocks)
+{
+    return writeFileAtomically(path, [&](std::ofstream &out) {
+        for (const auto& [data, size] : blocks) {
+            out.write(static_cast<const char*>(data), size);
+        }
+    });
+}
+
+static void appendStops(const std::vector<PlanStop> &planStops, std::vector<SolutionStop> &stops)
+{
+    for (const auto& stop : planStops) {
+        SolutionStop stopRecord = {};
+        stopRecord.id = stop.id;
+        stopRecord.kind = stop.kind;
+        stopRecord.arrival = stop.arrival;
+        stops.push_back(stopRecord);
+    }
+}
+
+bool saveSolutionFile(const std::string &path, const DeliveryPlan &plan)
+{
+    std::vector<SolutionVehicle> vehicles;
+    std::vector<SolutionStop> stops;
+    vehicles.reserve(plan.vehicles.size());
+    for (const auto& vehicle : plan.vehicles) {
+        SolutionVehicle record = {};
+        record.vehicleId = vehicle.vehicleId;
+        record.centerId = vehicle.centerId;
+        record.drone = vehicle.drone ? 1 : 0;
+        record.firstStop = stops.size();
+        record.stopCount = vehicle.stops.size();
+        vehicles.push_back(record);
+        appendStops(vehicle.stops, stops);
+    }
+
+    SolutionHeader header = {};
+    header.magic = SOLUTION_MAGIC;
+    header.version = SOLUTION_VERSION;
+    header.vehicleCount = vehicles.size();
+    header.stopCount = stops.size();
+    header.taskCount = plan.taskCount;
+    header.makespan = plan.makespan;
+    header.cost = plan.cost;
+
+    return writeBlocks(path, {{&header, sizeof(header)},
+                              {vehicles.data(), vehicles.size() * sizeof(SolutionVehicle)},
+                              {stops.data(), stops.size() * sizeof(SolutionStop)}});
+}
+
+bool savePlanDiffFile(const std::string &path, const PlanDiff &diff)
+{
+    std::vector<PlanDiffVehicle> vehicles;
+    std::vector<SolutionStop> stops;
+    vehicles.reserve(diff.changes.size());
+    for (const auto& change : diff.changes) {
+        PlanDiffVehicle record = {};
+        record.vehicleId = change.vehicleId;
+        record.centerId = change.centerId;
+        record.drone = change.drone ? 1 : 0;
+        record.keptStops = change.keptStops;
+        record.removedStops = change.removedStops;
+        record.firstStop = stops.size();
+        record.stopCount = change.suffix.size();
+        vehicles.push_back(record);
+        appendStops(change.suffix, stops);
+    }
+
+    PlanDiffHeader header = {};
+    header.magic = PLAN_DIFF_MAGIC;
+    header.version = PLAN_DIFF_VERSION;
+    header.changeCount = vehicles.size();
+    header.stopCount = stops.size();
+    header.unchangedCount = diff.unchangedCount;
+
+    return writeBlocks(path, {{&header, sizeof(header)},
+                              {vehicles.data(), vehicles.size() * sizeof(PlanDiffVehicle)},
+                              {stops.data(), stops.size() * sizeof(SolutionStop)}});
+}
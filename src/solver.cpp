@@ -3,6 +3,7 @@
 #include "path_optimizer.h"
 #include "static_genetic.h"
 #include "dynamic_genetic.h"
+#include "traffic_feed.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -16,12 +17,15 @@ using std::unordered_set;
 using std::cout;
 using std::endl;
 using std::max;
-extern vector<int> delayedTasks, newTasks;
+
+// 动态阶段需要重新调度的任务（延迟任务和新增任务）
+vector<int> delayedTasks, newTasks;
 
 // 优化所有车辆的路径 - 修改为返回<车辆ID, <路径, 时间>>的形式
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> static_optimizeAllPaths(
     const DeliveryProblem& problem,
-    const std::vector<std::pair<int, int>>& vehicleTaskAssignments)  // (车辆ID, 任务ID)对
+    const std::vector<std::pair<int, int>>& vehicleTaskAssignments,  // (车辆ID, 任务ID)对
+    const RouteSink& onRouteFinal)
 {
     std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> allPaths;
     
@@ -56,7 +60,8 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> static
                 problem.vehicles[vehicleIndex], 
                 problem);
             
-            // 以车辆ID为键存储路径
+            // 以车辆ID为键存储路径，各车辆路径互不影响，算完即可交给调度
+            if (onRouteFinal) onRouteFinal(vehicleId, path, completionTimes);
             allPaths[vehicleId] = {path, completionTimes};
         }
     }
@@ -108,7 +113,9 @@ pair<double, double> calculateTotalTimeAndCost(
 }
 
 // 求解静态配送问题
-std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveStaticProblem(DeliveryProblem& problem)
+std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveStaticProblem(
+    DeliveryProblem& problem,
+    const RouteSink& onRouteFinal)
 {
     assignTasksToCenters(problem);
     
@@ -120,7 +127,7 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveS
         problem.timeWeight
     );
     
-    auto allPaths = static_optimizeAllPaths(problem, vehicleTaskAssignments);
+    auto allPaths = static_optimizeAllPaths(problem, vehicleTaskAssignments, onRouteFinal);
     
     return allPaths;
 }
@@ -129,13 +136,27 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveS
 std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveDynamicProblem(
     DeliveryProblem& problem,
     const std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>>& staticPaths,
-    double staticMaxTime)
+    double staticMaxTime,
+    const RouteSink& onRouteFinal)
 {
+    // 沿用静态方案时，静态路径即为本阶段的最终路径
+    auto keepStaticPaths = [&]() {
+        if (onRouteFinal) {
+            for (const auto& [vehicleId, pathData] : staticPaths) {
+                onRouteFinal(vehicleId, pathData.first, pathData.second);
+            }
+        }
+        return staticPaths;
+    };
+    
+    // 切换到最新发布的实时交通数据，本次动态优化全程使用该版本
+    refreshTraffic(problem);
+    
     // 识别需要重新调度的任务
     //vector<int> delayedTasks, newTasks;
     identifyTasksForRescheduling(problem, staticPaths, staticMaxTime, delayedTasks, newTasks);
     
-    cout << "延迟任务数量: " << delayedTasks.size() << endl;
+    cout << "延迟任务数量: " << delayedTasks.size() << '\n';
     // 输出延迟任务ID
     if (!delayedTasks.empty()) {
         cout << "延迟任务ID: ";
@@ -143,10 +164,10 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveD
             if (i > 0) cout << ", ";
             cout << delayedTasks[i];
         }
-        cout << endl;
+        cout << '\n';
     }
     
-    cout << "新增任务数量: " << newTasks.size() << endl;
+    cout << "新增任务数量: " << newTasks.size() << '\n';
     // 输出新增任务ID
     if (!newTasks.empty()) {
         cout << "新增任务ID: ";
@@ -154,19 +175,19 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveD
             if (i > 0) cout << ", ";
             cout << newTasks[i];
         }
-        cout << endl;
+        cout << '\n';
     }
     // 求解动态阶段问题
-    cout << "\n========== 动态阶段求解 ==========" << endl;
+    cout << "\n========== 动态阶段求解 ==========" << '\n';
     
     // 在输出动态阶段结果前添加任务数量统计
     int totalDynamicTasks = problem.tasks.size();
-    cout << "动态优化任务数: " << totalDynamicTasks << endl;
+    cout << "动态优化任务数: " << totalDynamicTasks << '\n';
 
     
     if (delayedTasks.empty() && newTasks.empty()) {
-        cout << "没有需要重新调度的任务，直接使用静态解决方案" << endl;
-        return staticPaths;
+        cout << "没有需要重新调度的任务，直接使用静态解决方案" << '\n';
+        return keepStaticPaths();
     }
     // 使用改进的动态遗传算法分配任务
     vector<pair<int, int>> assignments = dynamicGeneticAlgorithm(
@@ -178,12 +199,12 @@ std::unordered_map<int, std::pair<std::vector<int>, std::vector<double>>> solveD
         staticMaxTime);
     
     if (assignments.empty()) {
-        cout << "动态优化失败，继续使用静态解决方案" << endl;
-        return staticPaths;
+        cout << "动态优化失败，继续使用静态解决方案" << '\n';
+        return keepStaticPaths();
     }
     
     // 优化所有车辆的路径
-    return optimizeDynamicPaths(problem, assignments);
+    return optimizeDynamicPaths(problem, assignments, onRouteFinal);
 }
 
 // 识别需要重新安排的任务
@@ -198,8 +219,8 @@ void identifyTasksForRescheduling(
     for (size_t i = problem.initialDemandCount; i < problem.tasks.size(); ++i) {
         newTasks.push_back(problem.tasks[i].id);  // 添加任务ID而不是索引
     }
-    cout << "--------------------------------" << endl;
-    std::cout << "考虑高峰期后的静态阶段路径时间：" << std::endl;
+    cout << "--------------------------------" << '\n';
+    std::cout << "考虑高峰期后的静态阶段路径时间：" << '\n';
     // 检查每个车辆的路径，找出在高峰期会延迟的任务
     for (const auto& [vehicleId, pair] : staticPaths) {
         const auto& [path, staticTimes] = pair;
@@ -0,0 +1,122 @@
+#include "spatial_index.h"
+
+using std::vector;
+
+TaskGrid::TaskGrid(const vector<double> &x, const vector<double> &y)
+{
+    int count = (int)x.size();
+    remainingCount = count;
+    removed.assign(count, 0);
+    cellOf.resize(count);
+    if (count == 0) {
+        cellStart.assign(2, 0);
+        cellLive.assign(1, 0);
+        return;
+    }
+
+    minX = *std::min_element(x.begin(), x.end());
+    minY = *std::min_element(y.begin(), y.end());
+    double width = *std::max_element(x.begin(), x.end()) - minX;
+    double height = *std::max_element(y.begin(), y.end()) - minY;
+
+    // 平均每格约2个点；点集退化为一条线时按长度划分，完全重合时只有一格
+    double cells = std::max(1.0, count / 2.0);
+    if (width > 0 && height > 0) {
+        cellSize = std::sqrt(width * height / cells);
+    } else if (width > 0 || height > 0) {
+        cellSize = std::max(width, height) / cells;
+    }
+    // 狭长点集的一边格数不超过点数
+    cellSize = std::max({cellSize, width / count, height / count});
+    columns = std::max(1, std::min(count, (int)(width / cellSize) + 1));
+    rows = std::max(1, std::min(count, (int)(height / cellSize) + 1));
+
+    // 按格计数排序（CSR），同一格内保持点下标顺序
+    cellStart.assign((size_t)columns * rows + 1, 0);
+    for (int i = 0; i < count; i++) {
+        int column = std::min(columns - 1, (int)((x[i] - minX) / cellSize));
+        int row = std::min(rows - 1, (int)((y[i] - minY) / cellSize));
+        cellOf[i] = row * columns + column;
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (size_t cell = 0; cell + 1 < cellStart.size(); cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    cellLive.assign((size_t)columns * rows, 0);
+    points.resize(count);
+    pointX.resize(count);
+    pointY.resize(count);
+    for (int i = 0; i < count; i++) {
+        int cell = cellOf[i];
+        int k = cellStart[cell] + cellLive[cell]++;
+        points[k] = i;
+        pointX[k] = x[i];
+        pointY[k] = y[i];
+    }
+}
+
+void TaskGrid::remove(int point)
+{
+    if (removed[point]) return;
+    removed[point] = 1;
+    cellLive[cellOf[point]]--;
+    remainingCount--;
+}
+
+
+// a 与 handles 中各点的 路网距离 / 直线距离 的最小值；直线距离为0（坐标重合）的点对不约束系数
+static double minDistanceRatio(const DeliveryProblem &problem, NodeHandle a, const vector<NodeHandle> &handles,
+                               size_t begin)
+{
+    double ax, ay;
+    handlePosition(problem, a, ax, ay);
+    double ratio = std::numeric_limits<double>::infinity();
+    for (size_t k = begin; k < handles.size(); k++) {
+        if (handles[k] == a) continue;
+        double bx, by;
+        handlePosition(problem, handles[k], bx, by);
+        // 与 TaskGrid 相同的直线距离算式（差值取反不影响平方）
+        double dx = bx - ax, dy = by - ay;
+        double straight = std::sqrt(dx * dx + dy * dy);
+        if (!(straight > 0)) continue;
+        // 两个方向分别计入：多源Dijkstra两个方向的求和顺序不同，紧凑存储量化后可能相差一级
+        double road = std::min(handleDistance(problem, a, handles[k], false), handleDistance(problem, handles[k], a, false));
+        ratio = std::min(ratio, road / straight);
+    }
+    return ratio;
+}
+
+static vector<NodeHandle> allPointHandles(const DeliveryProblem &problem)
+{
+    vector<NodeHandle> handles;
+    handles.reserve(problem.tasks.size() + problem.centers.size());
+    for (size_t i = 0; i < problem.tasks.size(); i++) handles.push_back({NodeKind::Task, false, (int)i});
+    for (size_t i = 0; i < problem.centers.size(); i++) handles.push_back({NodeKind::Center, false, (int)i});
+    return handles;
+}
+
+// 相对余量覆盖 系数×直线距离 的乘法舍入
+static const double RATIO_MARGIN = 1.0 - 1e-9;
+
+void calibrateEuclideanLowerBound(DeliveryProblem &problem)
+{
+    RouteNetwork& network = problem.network;
+    network.euclideanLowerBound = 0.0;
+    if (network.hierarchy || network.lazyRows || network.nodeCount == 0) return;
+
+    vector<NodeHandle> handles = allPointHandles(problem);
+    double ratio = std::numeric_limits<double>::infinity();
+    for (size_t k = 0; k < handles.size(); k++) {
+        ratio = std::min(ratio, minDistanceRatio(problem, handles[k], handles, k + 1));
+    }
+    // 没有可用点对（如点位坐标全部重合）时不剪枝
+    network.euclideanLowerBound = std::isfinite(ratio) ? ratio * RATIO_MARGIN : 0.0;
+}
+
+void extendEuclideanLowerBound(DeliveryProblem &problem, NodeHandle added)
+{
+    RouteNetwork& network = problem.network;
+    if (!(network.euclideanLowerBound > 0)) return;
+    double ratio = minDistanceRatio(problem, added, allPointHandles(problem), 0);
+    network.euclideanLowerBound = std::min(network.euclideanLowerBound, ratio * RATIO_MARGIN);
+}
@@ -29,12 +29,14 @@ double calculateFitness(
     const DeliveryProblem& problem,
     double timeWeight)
 {
+    TrafficPin traffic(problem);  // 一次适应度计算内各路线使用同一版交通系数
     static int callCount = 0;
     callCount++;
 
-    // 每1000次调用输出一次状态
-    if (callCount % 1000 == 0) {
-        std::cout << "静态阶段适应度计算次数: " << callCount << std::endl;
+    // 每1000次调用检查一次，进度行限速输出，只有真正输出时才刷新
+    static ProgressThrottle progress;
+    if (callCount % 1000 == 0 && progress.ready()) {
+        std::cout << "静态阶段适应度计算次数: " << callCount << '\n' << std::flush;
     }
     double maxCompletionTime = 0.0;
     double totalCost = 0.0;
@@ -110,7 +112,7 @@ vector<pair<int, int>> Static_GeneticAlgorithm(
         // 直接从problem.centerToTasks获取该中心负责的任务ID
         auto tasksIt = problem.centerToTasks.find(center.id);
         if (tasksIt == problem.centerToTasks.end() || tasksIt->second.empty()) {
-            cout << "警告: 配送中心 #" << center.id << " 没有任务，跳过处理" << endl;
+            cout << "警告: 配送中心 #" << center.id << " 没有任务，跳过处理" << '\n';
             continue;  // 跳过没有任务的中心
         }
         
@@ -120,7 +122,7 @@ vector<pair<int, int>> Static_GeneticAlgorithm(
         vector<int> centerVehicleIds = center.vehicles;
 
         if (centerVehicleIds.empty()) {
-            cout << "警告: 配送中心 #" << center.id << " 没有车辆，跳过处理" << endl;
+            cout << "警告: 配送中心 #" << center.id << " 没有车辆，跳过处理" << '\n';
             continue;
         }
 
@@ -148,7 +150,7 @@ vector<pair<int, int>> Static_GeneticAlgorithm(
 
         // 如果无法找到足够的可行解，跳过这个配送中心
         if (population.empty()) {
-            std::cout << "警告: 配送中心 #" << center.id << " 无法找到可行解，跳过处理" << std::endl;
+            std::cout << "警告: 配送中心 #" << center.id << " 无法找到可行解，跳过处理" << '\n';
             continue;
         }
 
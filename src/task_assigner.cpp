@@ -23,20 +23,7 @@ void assignTasksToCenters(DeliveryProblem& problem) {
     for (size_t i = 0; i < problem.initialDemandCount; i++) {
         
         auto& task = problem.tasks[i];
-        double minCostTime = std::numeric_limits<double>::max();
-        int closestCenterId = -1;
-        
-        for (const auto& center : problem.centers) {
-            // 使用ID计算任务点到配送中心的实际距离（不是欧式距离）
-            double distance = getDistance(task.id, center.id, problem, isDroneCenter(center));
-            double cost_time = distance / (isDroneCenter(center) ? droneSpeed : carSpeed);
-            //如果该距离更短并且该中心如果是无人机配送中心且无人机可以抵达
-            if (cost_time < minCostTime && (isCarCenter(center) || (isDroneCenter(center) && droneMaxFuel >= 2 * cost_time))) {
-            //if (distance < minDistance) {
-                minCostTime = cost_time;
-                closestCenterId = center.id;
-            }
-        }
+        int closestCenterId = findClosestCenter(problem, task);
         
         if (closestCenterId != -1) {
             task.centerId = closestCenterId;  // 使用中心ID而非索引
@@ -46,3 +33,21 @@ void assignTasksToCenters(DeliveryProblem& problem) {
     
 
 }
+
+int findClosestCenter(const DeliveryProblem& problem, const TaskPoint& task) {
+    double minCostTime = std::numeric_limits<double>::max();
+    int closestCenterId = -1;
+    
+    for (const auto& center : problem.centers) {
+        // 使用ID计算任务点到配送中心的实际距离（不是欧式距离）
+        double distance = getDistance(task.id, center.id, problem, isDroneCenter(center));
+        double cost_time = distance / (isDroneCenter(center) ? droneSpeed : carSpeed);
+        //如果该距离更短并且该中心如果是无人机配送中心且无人机可以抵达
+        if (cost_time < minCostTime && (isCarCenter(center) || (isDroneCenter(center) && droneMaxFuel >= 2 * cost_time))) {
+        //if (distance < minDistance) {
+            minCostTime = cost_time;
+            closestCenterId = center.id;
+        }
+    }
+    return closestCenterId;
+}
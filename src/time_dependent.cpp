@@ -0,0 +1,208 @@
+#include "time_dependent.h"
+#include "travel_time.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+TimeDependentRoutes::TimeDependentRoutes(CsrGraph graph, const std::vector<EdgePeakFactor> &edgeFactors,
+                                         TravelTimeProfile profile, std::vector<int> targetNodes,
+                                         int bucketMinutes, size_t byteLimit)
+    : graph(std::move(graph)), profile(std::move(profile)), targetNodes(std::move(targetNodes)),
+      bucketMinutes(bucketMinutes), byteLimit(byteLimit)
+{
+    buckets = std::max(1, (int)std::lround(24.0 * 60.0 / std::max(bucketMinutes, 1)));
+    bucketHours = 24.0 / buckets;
+
+    // 只保留确实是路段的节点对
+    for (const auto& line : edgeFactors) {
+        int u = this->graph.indexOf(line.node1);
+        int v = this->graph.indexOf(line.node2);
+        if (u < 0 || v < 0) continue;
+        for (int e = this->graph.offsets[u]; e < this->graph.offsets[u + 1]; e++) {
+            if (this->graph.targets[e] == v) {
+                this->edgeFactors.push_back(line);
+                break;
+            }
+        }
+    }
+    reset(std::move(this->graph));
+}
+
+void TimeDependentRoutes::buildArcTimes()
+{
+    arcTimes.resize(graph.targets.size());
+    std::vector<PeakFactor> arcFactors(graph.targets.size());
+    // 系数对路段两个方向生效，后出现的行覆盖先出现的
+    for (const auto& line : edgeFactors) {
+        int u = graph.indexOf(line.node1);
+        int v = graph.indexOf(line.node2);
+        if (u < 0 || v < 0) continue;
+        for (auto [from, to] : {std::pair<int, int>{u, v}, {v, u}}) {
+            for (int e = graph.offsets[from]; e < graph.offsets[from + 1]; e++) {
+                if (graph.targets[e] == to) arcFactors[e] = line.factor;
+            }
+        }
+    }
+    for (size_t e = 0; e < arcTimes.size(); e++) {
+        double length = graph.weights[e];
+        double morning = arcFactors[e].valid() ? arcFactors[e].morning : DeliveryProblem::DEFAULT_MORNING_PEAK_FACTOR;
+        double evening = arcFactors[e].valid() ? arcFactors[e].evening : DeliveryProblem::DEFAULT_EVENING_PEAK_FACTOR;
+        arcTimes[e] = {{length, length / morning, length / evening}};
+    }
+}
+
+std::shared_ptr<TimeDependentRoutes> TimeDependentRoutes::rebuilt(CsrGraph graph,
+                                                                 const std::vector<EdgePeakFactor> &edgeFactors) const
+{
+    auto routes = std::make_shared<TimeDependentRoutes>(std::move(graph), edgeFactors, profile, targetNodes,
+                                                        bucketMinutes, byteLimit);
+    std::lock_guard<std::mutex> lock(mutex);
+    routes->counters = counters;
+    routes->counters.capacityRows = routes->capacityRows;
+    return routes;
+}
+
+void TimeDependentRoutes::reset(CsrGraph graph)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->graph = std::move(graph);
+    buildArcTimes();
+
+    targetSlot.assign(this->graph.nodeCount, -1);
+    targetCount = 0;
+    for (size_t s = 0; s < targetNodes.size(); s++) {
+        int index = this->graph.indexOf(targetNodes[s]);
+        if (index >= 0 && targetSlot[index] < 0) {
+            targetSlot[index] = (int)s;
+            targetCount++;
+        }
+    }
+
+    size_t rowBytes = std::max<size_t>(targetNodes.size() * sizeof(double), 1);
+    capacityRows = std::max<size_t>(byteLimit / rowBytes, 2);  // 插值需要同时读取两行
+    counters.capacityRows = capacityRows;
+    rows.assign(targetNodes.size() * buckets, std::vector<double>());
+    recentRows.clear();
+    position.assign(rows.size(), recentRows.end());
+}
+
+// 时变Dijkstra（二叉堆，惰性删除），标号为最早到达时刻
+void TimeDependentRoutes::dijkstra(int source, double departure, double speed, std::vector<double> &arrival,
+                                   const std::vector<int> *targets, int targetTotal) const
+{
+    arrival.assign(graph.nodeCount, std::numeric_limits<double>::infinity());
+    std::vector<std::pair<double, int>> heap;
+    auto cmp = std::greater<std::pair<double, int>>();
+
+    arrival[source] = departure;
+    heap.push_back({departure, source});
+    int remainingTargets = targetTotal;
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        auto [t, u] = heap.back();
+        heap.pop_back();
+        if (t > arrival[u]) continue;  // 过期的堆元素
+
+        if (targets && (*targets)[u] >= 0 && --remainingTargets == 0) {
+            break;  // 所有目标节点均已确定
+        }
+
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; e++) {
+            int v = graph.targets[e];
+            double nt = t + legTravelTime(profile, arcTimes[e], speed, t);
+            if (nt < arrival[v]) {
+                arrival[v] = nt;
+                heap.push_back({nt, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+}
+
+const std::vector<double> &TimeDependentRoutes::row(int sourceSlot, int bucket, double speed)
+{
+    // 车速变化时已缓存的行全部失效
+    if (speed != rowSpeed) {
+        for (int key : recentRows) rows[key].clear();
+        counters.evictions += recentRows.size();
+        recentRows.clear();
+        position.assign(rows.size(), recentRows.end());
+        rowSpeed = speed;
+    }
+
+    int key = sourceSlot * buckets + bucket;
+    if (!rows[key].empty()) {
+        counters.hits++;
+        recentRows.splice(recentRows.begin(), recentRows, position[key]);
+        return rows[key];
+    }
+
+    // 未命中：在桶的起始时刻出发运行时变Dijkstra，超出上限时淘汰最久未使用的行
+    counters.misses++;
+    if (recentRows.size() >= capacityRows) {
+        int victim = recentRows.back();
+        recentRows.pop_back();
+        position[victim] = recentRows.end();
+        std::vector<double>().swap(rows[victim]);
+        counters.evictions++;
+    }
+
+    double departure = bucket * bucketHours;
+    std::vector<double> arrival;
+    std::vector<double> result(targetNodes.size(), std::numeric_limits<double>::infinity());
+    int source = graph.indexOf(targetNodes[sourceSlot]);
+    if (source >= 0) {
+        dijkstra(source, departure, speed, arrival, &targetSlot, targetCount);
+        for (size_t s = 0; s < targetNodes.size(); s++) {
+            int index = graph.indexOf(targetNodes[s]);
+            if (index >= 0) result[s] = arrival[index] - departure;
+        }
+    }
+    rows[key].swap(result);
+    recentRows.push_front(key);
+    position[key] = recentRows.begin();
+    return rows[key];
+}
+
+double TimeDependentRoutes::travelTime(int sourceSlot, int targetSlot, double departure, double speed)
+{
+    if (sourceSlot == targetSlot) return 0.0;
+    if (sourceSlot < 0 || targetSlot < 0) return std::numeric_limits<double>::infinity();
+
+    // 出发时间所在的桶及桶内位置（按天取模）
+    double hour = departure - 24.0 * std::floor(departure / 24.0);
+    double offset = hour / bucketHours;
+    int bucket = std::min((int)offset, buckets - 1);
+    double fraction = offset - bucket;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    double early = row(sourceSlot, bucket, speed)[targetSlot];
+    if (fraction <= 0.0 || !std::isfinite(early)) return early;
+    double late = row(sourceSlot, (bucket + 1) % buckets, speed)[targetSlot];
+    return early + (late - early) * fraction;
+}
+
+double TimeDependentRoutes::exactTravelTime(int sourceNodeId, int targetNodeId, double departure, double speed) const
+{
+    int u = graph.indexOf(sourceNodeId);
+    int v = graph.indexOf(targetNodeId);
+    if (u < 0 || v < 0) return std::numeric_limits<double>::infinity();
+    if (u == v) return 0.0;
+
+    std::vector<int> target(graph.nodeCount, -1);
+    target[v] = 0;
+    std::vector<double> arrival;
+    std::lock_guard<std::mutex> lock(mutex);
+    dijkstra(u, departure, speed, arrival, &target, 1);
+    return arrival[v] - departure;
+}
+
+TimeDependentStats TimeDependentRoutes::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    TimeDependentStats result = counters;
+    result.cachedRows = recentRows.size();
+    return result;
+}
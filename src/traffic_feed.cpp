@@ -0,0 +1,246 @@
+#include "traffic_feed.h"
+#include "shortest_path.h"
+#include "time_dependent.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TrafficSnapshotInputs captureTrafficInputs(const DeliveryProblem &problem)
+{
+    const RouteNetwork& network = problem.network;
+    TrafficSnapshotInputs inputs;
+    inputs.graph = network.graph.nodeCount > 0 ? network.graph : buildCsrGraph(network.edges);
+    if (network.peakFactors) inputs.slotDistances = slotPairDistances(network.peakFactors->slotNodes, network);
+    inputs.distanceVersion = network.distanceVersion;
+    inputs.travelProfile = problem.travelProfile;
+    inputs.timeDependent = problem.config.timeDependent;
+    inputs.timeBucketMinutes = problem.config.timeBucketMinutes;
+    inputs.rowCacheBytes = problem.config.rowCacheBytes;
+    return inputs;
+}
+
+// 系数行按layout的槽位写入新快照
+static std::shared_ptr<PeakFactorTable> snapshotFactors(const PeakFactorTable &layout, const std::vector<EdgePeakFactor> &lines)
+{
+    auto table = std::make_shared<PeakFactorTable>();
+    table->slotCount = layout.slotCount;
+    table->slotOf = layout.slotOf;
+    table->slotNodes = layout.slotNodes;
+    table->factors.assign(layout.factors.size(), PeakFactor());
+
+    // 系数对路段两个方向、以及同一路网节点上的初始需求点/额外需求点/配送中心ID都生效，
+    // 按无序节点对存一份；两端不都是任务点/配送中心节点的行不会被查询，只供时变最短路使用
+    for (const auto& line : lines) {
+        int slot1 = table->slotOfPoint(line.node1);
+        int slot2 = table->slotOfPoint(line.node2);
+        if (slot1 < 0 || slot2 < 0) continue;
+        table->factors[PeakFactorTable::pairIndex(slot1, slot2)] = line.factor;
+    }
+    table->lines = std::make_shared<const std::vector<EdgePeakFactor>>(lines);
+    return table;
+}
+
+std::shared_ptr<PeakFactorTable> buildTrafficSnapshot(const PeakFactorTable &layout, const TrafficSnapshotInputs &inputs,
+                                                      const std::vector<EdgePeakFactor> &lines)
+{
+    auto table = snapshotFactors(layout, lines);
+    buildBandTravelTimes(*table, inputs.slotDistances, inputs.distanceVersion);
+    if (inputs.timeDependent) {
+        table->timeDependent = std::make_shared<TimeDependentRoutes>(inputs.graph, lines, inputs.travelProfile,
+                                                                     table->slotNodes, inputs.timeBucketMinutes,
+                                                                     inputs.rowCacheBytes);
+    }
+    return table;
+}
+
+std::shared_ptr<PeakFactorTable> buildTrafficSnapshot(const PeakFactorTable &layout, const DeliveryProblem &problem,
+                                                      const std::vector<EdgePeakFactor> &lines)
+{
+    auto table = snapshotFactors(layout, lines);
+    buildBandTravelTimes(*table, problem.network);
+    if (problem.config.timeDependent) {
+        table->timeDependent = buildTimeDependentRoutes(problem, lines, table->slotNodes);
+    }
+    return table;
+}
+
+std::shared_ptr<TimeDependentRoutes> buildTimeDependentRoutes(const DeliveryProblem &problem,
+                                                              const std::vector<EdgePeakFactor> &lines,
+                                                              const std::vector<int> &slotNodes)
+{
+    const RouteNetwork& network = problem.network;
+    CsrGraph graph = network.graph.nodeCount > 0 ? network.graph : buildCsrGraph(network.edges);
+    return std::make_shared<TimeDependentRoutes>(std::move(graph), lines, problem.travelProfile, slotNodes,
+                                                 problem.config.timeBucketMinutes, problem.config.rowCacheBytes);
+}
+
+bool parseFactorLine(const std::string &line, EdgePeakFactor &factor)
+{
+    std::istringstream stream(line);
+    std::string rest;
+    return (bool)(stream >> factor.node1 >> factor.node2 >> factor.factor.morning >> factor.factor.evening)
+        && !(stream >> rest) && factor.factor.morning > 0.0 && factor.factor.evening > 0.0;
+}
+
+TrafficFeed::TrafficFeed(std::shared_ptr<const PeakFactorTable> initial)
+    : current(std::move(initial))
+{
+}
+
+std::shared_ptr<const PeakFactorTable> TrafficFeed::snapshot() const
+{
+    return std::atomic_load(&current);
+}
+
+std::shared_ptr<const TrafficSnapshotInputs> TrafficFeed::snapshotInputs() const
+{
+    return std::atomic_load(&inputs);
+}
+
+void TrafficFeed::setSnapshotInputs(std::shared_ptr<const TrafficSnapshotInputs> replacement)
+{
+    std::lock_guard<std::mutex> lock(publishMutex);
+    std::atomic_store(&inputs, std::move(replacement));
+}
+
+uint64_t TrafficFeed::publish(std::shared_ptr<PeakFactorTable> table, const PeakFactorTable* builtOn,
+                              const TrafficSnapshotInputs* builtFrom)
+{
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (builtOn && builtOn != snapshot().get()) return 0;
+    if (builtFrom && builtFrom != snapshotInputs().get()) return 0;
+    table->version = snapshot()->version + 1;
+    uint64_t version = table->version;
+    std::atomic_store(&current, std::shared_ptr<const PeakFactorTable>(std::move(table)));
+    return version;
+}
+
+TrafficWatcher::TrafficWatcher(const DeliveryProblem &problem, std::shared_ptr<TrafficFeed> feed,
+                               std::string source, int pollMilliseconds)
+    : feed(std::move(feed)), source(std::move(source)), pollMilliseconds(pollMilliseconds)
+{
+    this->feed->setSnapshotInputs(std::make_shared<const TrafficSnapshotInputs>(captureTrafficInputs(problem)));
+    thread = std::thread([this] {
+        if (this->source == "-") {
+            readStandardInput();
+        } else {
+            watchFile();
+        }
+    });
+}
+
+TrafficWatcher::~TrafficWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+bool TrafficWatcher::waitFor(int milliseconds)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return !wake.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return stopping; });
+}
+
+// 建立期间求解线程发布了新快照（新增槽位或路段更新）或替换了输入时，在最新的快照和输入上重建
+void TrafficWatcher::publish(const std::vector<EdgePeakFactor> &lines)
+{
+    uint64_t version = 0;
+    while (version == 0) {
+        std::shared_ptr<const PeakFactorTable> layout = feed->snapshot();
+        std::shared_ptr<const TrafficSnapshotInputs> inputs = feed->snapshotInputs();
+        auto table = buildTrafficSnapshot(*layout, *inputs, lines);
+        version = feed->publish(std::move(table), layout.get(), inputs.get());
+    }
+    std::cerr << "交通数据版本 " << version << " 已发布（" << lines.size() << " 条系数）" << std::endl;
+}
+
+// 文件被整体重写后（建议写临时文件再重命名）修改时间或大小会变化，首次检查时文件已存在也视为一次更新
+void TrafficWatcher::watchFile()
+{
+    bool seen = false;
+    struct timespec lastModified = {0, 0};
+    off_t lastSize = -1;
+    do {
+        struct stat info;
+        if (stat(source.c_str(), &info) == 0) {
+            bool changed = !seen || info.st_mtim.tv_sec != lastModified.tv_sec
+                || info.st_mtim.tv_nsec != lastModified.tv_nsec || info.st_size != lastSize;
+            if (changed) {
+                seen = true;
+                lastModified = info.st_mtim;
+                lastSize = info.st_size;
+
+                std::ifstream file(source);
+                std::vector<EdgePeakFactor> lines;
+                std::string text;
+                EdgePeakFactor factor;
+                while (std::getline(file, text)) {
+                    if (parseFactorLine(text, factor)) lines.push_back(factor);
+                }
+                publish(lines);
+            }
+        }
+    } while (waitFor(pollMilliseconds));
+}
+
+// 标准输入用poll等待，便于析构时及时退出
+void TrafficWatcher::readStandardInput()
+{
+    std::vector<EdgePeakFactor> lines;
+    std::string pending;
+    char buffer[4096];
+    auto finishLine = [&](const std::string& text) {
+        EdgePeakFactor factor;
+        if (text.find_first_not_of(" \t\r") == std::string::npos) {
+            if (!lines.empty()) publish(lines);
+            lines.clear();
+        } else if (parseFactorLine(text, factor)) {
+            lines.push_back(factor);
+        } else {
+            std::cerr << "忽略格式错误的交通系数行: " << text << std::endl;
+        }
+    };
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+        }
+        struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+        int ready = poll(&input, 1, std::min(pollMilliseconds, 200));
+        if (ready <= 0) continue;
+
+        ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (count <= 0) {
+            // 输入结束：最后一组没有空行结尾也发布
+            if (!pending.empty()) finishLine(pending);
+            if (!lines.empty()) publish(lines);
+            return;
+        }
+        pending.append(buffer, count);
+        size_t start = 0, newline;
+        while ((newline = pending.find('\n', start)) != std::string::npos) {
+            finishLine(pending.substr(start, newline - start));
+            start = newline + 1;
+        }
+        pending.erase(0, start);
+    }
+}
+
+bool refreshTraffic(DeliveryProblem &problem)
+{
+    if (!problem.trafficFeed) return false;
+    std::shared_ptr<const PeakFactorTable> latest = problem.trafficFeed->snapshot();
+    if (latest == problem.network.peakFactors) return false;
+    problem.network.peakFactors = latest;
+    std::cout << "交通数据更新到版本 " << latest->version << '\n';
+    return true;
+}
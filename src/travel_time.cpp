@@ -0,0 +1,153 @@
+#include "travel_time.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+bool parsePeakWindows(const std::string &spec, std::vector<PeakWindow> &windows)
+{
+    std::vector<PeakWindow> parsed;
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t dash = item.find('-');
+        char* end1 = nullptr;
+        char* end2 = nullptr;
+        double start = std::strtod(item.c_str(), &end1);
+        double end = dash == std::string::npos ? 0.0 : std::strtod(item.c_str() + dash + 1, &end2);
+        if (dash == std::string::npos || end1 != item.c_str() + dash || !end2 || *end2 != '\0'
+            || !(start >= 0.0 && start < end && end <= 24.0)) {
+            std::cerr << "高峰时间窗格式错误（应为 开始-结束，0 <= 开始 < 结束 <= 24）: " << item << std::endl;
+            return false;
+        }
+        parsed.push_back({start, end, start < 12.0 ? MorningPeak : EveningPeak});
+    }
+
+    std::sort(parsed.begin(), parsed.end(), [](const PeakWindow& a, const PeakWindow& b) {
+        return a.start < b.start;
+    });
+    for (size_t i = 1; i < parsed.size(); i++) {
+        if (parsed[i].start < parsed[i - 1].end) {
+            std::cerr << "高峰时间窗重叠: [" << parsed[i - 1].start << ", " << parsed[i - 1].end << ") 与 ["
+                      << parsed[i].start << ", " << parsed[i].end << ")" << std::endl;
+            return false;
+        }
+    }
+    windows = parsed;
+    return true;
+}
+
+TravelTimeProfile buildTravelTimeProfile(const std::vector<PeakWindow> &windows)
+{
+    std::vector<PeakWindow> sorted = windows;
+    std::sort(sorted.begin(), sorted.end(), [](const PeakWindow& a, const PeakWindow& b) {
+        return a.start < b.start;
+    });
+
+    // 时间窗和其间的非高峰期依次成段，跳过长度为0的段
+    TravelTimeProfile profile;
+    double cursor = 0.0;
+    auto addSegment = [&profile](double start, double end, TimeBand band) {
+        if (end <= start) return;
+        profile.breakpoints.push_back(start);
+        profile.bands.push_back(band);
+    };
+    for (const auto& window : sorted) {
+        addSegment(cursor, window.start, OffPeak);
+        addSegment(std::max(cursor, window.start), window.end, window.band);
+        cursor = std::max(cursor, window.end);
+    }
+    addSegment(cursor, 24.0, OffPeak);
+    profile.breakpoints.push_back(24.0);
+
+    // 每个整点所在的段
+    for (int hour = 0; hour < 24; hour++) {
+        uint16_t segment = 0;
+        while (profile.breakpoints[segment + 1] <= hour) segment++;
+        profile.hourSegment[hour] = segment;
+    }
+
+    // 各断点之前每个时段的累计小时数
+    profile.elapsed.assign(profile.breakpoints.size(), {});
+    for (size_t i = 0; i + 1 < profile.breakpoints.size(); i++) {
+        profile.elapsed[i + 1] = profile.elapsed[i];
+        profile.elapsed[i + 1][profile.bands[i]] += profile.breakpoints[i + 1] - profile.breakpoints[i];
+    }
+    return profile;
+}
+
+// 所在段的下标，hour需在[0, 24)内：按小时格子查到该格子起点所在段，再顺序跨过格子内的断点
+static size_t segmentAt(const TravelTimeProfile &profile, double hour)
+{
+    size_t segment = profile.hourSegment[std::min((int)hour, 23)];
+    while (profile.breakpoints[segment + 1] <= hour) {
+        segment++;
+    }
+    return segment;
+}
+
+TimeBand timeBandAt(const TravelTimeProfile &profile, double hour)
+{
+    if (profile.bands.empty()) return OffPeak;
+    hour -= 24.0 * std::floor(hour / 24.0);
+    return profile.bands[segmentAt(profile, hour)];
+}
+
+double legTravelTime(const TravelTimeProfile &profile, const BandTravelTimes &times, double speed, double departure)
+{
+    double distance = times.unit[OffPeak];
+    if (!(distance > 0.0001)) return 0.0;
+    if (!std::isfinite(distance)) return std::numeric_limits<double>::infinity();
+    if (profile.bands.empty()) return distance / speed;
+
+    double start = departure;
+    if (start < 0.0 || start >= 24.0) {
+        start -= 24.0 * std::floor(departure / 24.0);
+    }
+    size_t segment = segmentAt(profile, start);
+
+    // 大多数路段在出发所在的段或下一段内就能到达，不必建立整天的进度函数
+    double legTime = times.unit[profile.bands[segment]] / speed;
+    double firstSpan = profile.breakpoints[segment + 1] - start;
+    if (legTime <= firstSpan) {
+        return legTime;
+    }
+    size_t next = segment + 1 < profile.bands.size() ? segment + 1 : 0;
+    double nextLegTime = times.unit[profile.bands[next]] / speed;
+    double nextRemaining = (1.0 - firstSpan / legTime) * nextLegTime;
+    if (nextRemaining <= profile.breakpoints[next + 1] - profile.breakpoints[next]) {
+        return firstSpan + nextRemaining;
+    }
+
+    // 各时段每小时完成的路程比例；进度W(t)为[0, t)内各时段累计小时数与之的加权和，随t单调不减
+    double rate[TimeBandCount];
+    for (int b = 0; b < TimeBandCount; b++) {
+        rate[b] = speed / times.unit[b];
+    }
+    auto progress = [&](size_t i) {
+        const auto& hours = profile.elapsed[i];
+        return hours[OffPeak] * rate[OffPeak] + hours[MorningPeak] * rate[MorningPeak] + hours[EveningPeak] * rate[EveningPeak];
+    };
+    double target = progress(segment) + (start - profile.breakpoints[segment]) * rate[profile.bands[segment]] + 1.0;
+
+    // 超过一天的部分整天跳过
+    size_t last = profile.bands.size();
+    double dayProgress = progress(last);
+    double days = std::floor(target / dayProgress);
+    target = std::max(target - days * dayProgress, 0.0);
+
+    // 二分查找进度达到target所在的段：最后一个 W(t_i) <= target 的断点
+    size_t lo = 0, hi = last;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (progress(mid) <= target) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    double arrival = profile.breakpoints[lo] + (target - progress(lo)) / rate[profile.bands[lo]];
+    return days * 24.0 + arrival - start;
+}